@@ -3,6 +3,10 @@
 LISP_FILE="./evaluators/lisp/lisp.c"
 LISP_TEST_FILE="./resources/lisp/very_long_lisp_program.lisp"
 INTEGRATION_PY="test/integration/test_lisp.py"
+BENCHMARK_FILE="./test/benchmark/lisp_bench.c"
+BENCHMARK_BASELINE="./log/benchmark_baseline.json"
+REGEX_CACHE_GEN="./tools/regex_cache_gen.c"
+LISP_REGEXES="./evaluators/lisp/lisp_regexes.txt"
 # FLAGS="-DMULTITHREADED"
 # FLAGS="-DARENA_ALLOCATOR"
 
@@ -23,6 +27,10 @@ elif [[ $1 == "prof-test" ]]; then
     ./compile.sh integration-test
 elif [[ $1 == "integration-test" ]]; then
     python3 $INTEGRATION_PY
+elif [[ $1 == "benchmark" ]]; then
+    # Pass `-o $BENCHMARK_BASELINE` instead of `-b ...` to record a new baseline.
+    clang -Ofast $FLAGS $BENCHMARK_FILE -o bench.out
+    ./bench.out -b $BENCHMARK_BASELINE "${@:2}"
 elif [[ $1 == "profile" ]]; then
     clang -Ofast -DDRY_RUN -fprofile-instr-generate -fcoverage-mapping $LISP_FILE
     ./a.out $LISP_TEST_FILE
@@ -31,6 +39,22 @@ elif [[ $1 == "profile" ]]; then
     rm ./a.out merge.out default.profraw
 elif [[ $1 == "arena-allocated" ]]; then
     clang -Ofast -DARENA_ALLOCATOR $LISP_FILE;
+elif [[ $1 == "stats" ]]; then
+    clang -Ofast $FLAGS -DAPLI_STATS $LISP_FILE;
+elif [[ $1 == "trace" ]]; then
+    # Run with APLI_TRACE_FILE=trace.json to record a timeline (chrome://tracing, ui.perfetto.dev).
+    clang -Ofast $FLAGS -DAPLI_TRACE $LISP_FILE;
+elif [[ $1 == "alloc-tracking" ]]; then
+    clang -Ofast -DAPLI_ALLOC_TRACKING $LISP_FILE;
+elif [[ $1 == "regex-cache" ]]; then
+    # Regenerates the DFA cache of the lisp token rules (run it after changing a regex).
+    clang -O2 $REGEX_CACHE_GEN -o regex_cache_gen.out
+    ./regex_cache_gen.out $LISP_REGEXES evaluators/lisp/lisp_regex_cache.h lisp evaluators/lisp/lisp_regex_scanners.h
+elif [[ $1 == "lazy-dfa" ]]; then
+    # Builds the DFAs of the token rules while tokenizing instead of loading the cache.
+    clang -Ofast $FLAGS -DLAZY_DFA $LISP_FILE;
+elif [[ $1 == "gc-stats" ]]; then
+    clang -Ofast $FLAGS -DPRINT_GC_STATS $LISP_FILE;
 elif [[ $1 == "" ]]; then
     clang -Ofast $FLAGS $LISP_FILE;
 else
@@ -20,6 +20,15 @@ void _initialize_memory() {
     beginning_of_block = (size_t) malloc(MAX_SIZE);
 }
 
+// Everything allocated after `_arena_mark()` is released at once by `_arena_reset(mark)`.
+size_t _arena_mark() {
+    return beginning_of_block;
+}
+
+void _arena_reset(size_t mark) {
+    beginning_of_block = mark;
+}
+
 #ifdef ARENA_ALLOCATOR
 #define malloc(sz)  (_malloc(sz))
 #define free(ptr)
@@ -0,0 +1,293 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+
+/**
+ * A precise mark-sweep collector for the lisp evaluator.
+ *
+ * Every heap object starts with a `gc_object` header and is threaded onto a single
+ * intrusive list. The evaluator pushes the objects it is actively using (the global
+ * environment and the closure of every function currently on the C stack) onto the
+ * root stack; everything reachable from a root through the type's `trace` function
+ * survives a collection, everything else is finalized.
+ *
+ * Allocation never collects by itself. `gc_alloc` only requests a collection once the
+ * number of bytes allocated since the last collection passes the threshold, and the
+ * evaluator performs it at the next `gc_safepoint`, where every live value is either
+ * bound in a rooted environment or on the root stack.
+ *
+ * Configuration (bytes):
+ *   -DGC_INITIAL_THRESHOLD=...  bytes allocated before the first collection.
+ *   -DGC_HEAP_LIMIT=...         maximum live bytes after a collection (0 = unlimited).
+ * Both can be overridden at runtime through the `LISP_GC_THRESHOLD` and
+ * `LISP_GC_HEAP_LIMIT` environment variables, which are read by `gc_init`. Compile with
+ * `-DPRINT_GC_STATS` to dump the collector statistics when the evaluator exits.
+ *
+ * A heap that is still over the limit after a collection is an evaluation error: it is
+ * reported through `lisp_fail`, so a server only fails the request that ran out of heap.
+ */
+
+#ifndef GC_INITIAL_THRESHOLD
+#define GC_INITIAL_THRESHOLD (1UL << 20)
+#endif
+
+#ifndef GC_HEAP_LIMIT
+#define GC_HEAP_LIMIT 0UL
+#endif
+
+#define GC_INITIAL_ROOT_CAPACITY 64
+#define GC_INITIAL_GRAY_CAPACITY 256
+
+typedef struct _gc_object gc_object;
+typedef struct _gc_type gc_type;
+
+struct _gc_type {
+    const char *name;
+    void (*trace)(gc_object*);     // calls `gc_mark` on every object directly referenced.
+    void (*finalize)(gc_object*);  // releases everything owned by the object (not the object).
+};
+
+struct _gc_object {
+    gc_object *next;
+    const gc_type *type;
+    size_t size;
+    unsigned char marked;
+};
+
+typedef struct _gc_stats {
+    size_t collections;
+    size_t objects_allocated;
+    size_t objects_freed;
+    size_t bytes_allocated;
+    size_t bytes_freed;
+    size_t live_objects;
+    size_t live_bytes;
+    size_t peak_live_bytes;
+    unsigned long long total_pause_ns;
+    unsigned long long max_pause_ns;
+} gc_stats;
+
+typedef struct _gc_heap {
+    gc_object *objects;
+    gc_object **roots;
+    size_t roots_size, roots_capacity;
+    gc_object **gray;
+    size_t gray_size, gray_capacity;
+    size_t bytes_since_collection;
+    size_t threshold;
+    size_t initial_threshold;
+    size_t heap_limit;
+    unsigned char collection_requested;
+    unsigned char initialized;
+    gc_stats stats;
+} gc_heap;
+
+gc_heap _gc_heap = {0};
+
+#define gc_init()               _gc_init()
+#define gc_alloc(type, sz)      _gc_alloc(type, sz)
+#define gc_mark(obj)            _gc_mark((gc_object*) (obj))
+#define gc_push_root(obj)       _gc_push_root((gc_object*) (obj))
+#define gc_pop_root()           _gc_pop_root()
+#define gc_account(obj, delta)  _gc_account((gc_object*) (obj), delta)
+#define gc_safepoint()          if(_gc_heap.collection_requested) _gc_collect()
+#define gc_collect()            _gc_collect()
+#define gc_free_all()           _gc_free_all()
+#define gc_shutdown()           _gc_shutdown()
+#define gc_get_stats()          (_gc_heap.stats)
+#define gc_print_stats(fp)      _gc_print_stats(fp)
+
+void _gc_init();
+void *_gc_alloc(const gc_type *type, size_t sz);
+void _gc_mark(gc_object *obj);
+void _gc_push_root(gc_object *obj);
+void _gc_pop_root();
+void _gc_account(gc_object *obj, long delta);
+void _gc_collect();
+void _gc_free_all();
+void _gc_shutdown();
+void _gc_print_stats(FILE *fp);
+
+// Defined by the evaluator (see lisp.c).
+_Noreturn void lisp_fail();
+
+unsigned long long _gc_now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+size_t _gc_env_size(const char *name, size_t fallback) {
+    const char *val = getenv(name);
+    if(NULL == val || '\0' == val[0])
+        return fallback;
+    return (size_t) strtoull(val, NULL, 10);
+}
+
+void _gc_init() {
+    if(_gc_heap.initialized)
+        return;
+    _gc_heap.initialized = 1;
+    _gc_heap.initial_threshold = _gc_env_size("LISP_GC_THRESHOLD", GC_INITIAL_THRESHOLD);
+    _gc_heap.threshold = _gc_heap.initial_threshold;
+    _gc_heap.heap_limit = _gc_env_size("LISP_GC_HEAP_LIMIT", GC_HEAP_LIMIT);
+    _gc_heap.roots_capacity = GC_INITIAL_ROOT_CAPACITY;
+    _gc_heap.roots = (gc_object**) malloc(sizeof(gc_object*) * _gc_heap.roots_capacity);
+    _gc_heap.gray_capacity = GC_INITIAL_GRAY_CAPACITY;
+    _gc_heap.gray = (gc_object**) malloc(sizeof(gc_object*) * _gc_heap.gray_capacity);
+}
+
+void *_gc_alloc(const gc_type *type, size_t sz) {
+    assert(sizeof(gc_object) <= sz);
+    gc_object *obj = (gc_object*) malloc(sz);
+    obj->next = _gc_heap.objects;
+    obj->type = type;
+    obj->size = 0;
+    obj->marked = 0;
+    _gc_heap.objects = obj;
+
+    _gc_heap.stats.objects_allocated += 1;
+    _gc_heap.stats.live_objects += 1;
+    _gc_account(obj, (long) sz);
+    return obj;
+}
+
+// Objects own memory that grows after allocation (ie. environment frames), so the owner
+// reports the difference to keep the heap accounting close to the real footprint.
+void _gc_account(gc_object *obj, long delta) {
+    obj->size += delta;
+    if(0 < delta) {
+        _gc_heap.stats.bytes_allocated += delta;
+        _gc_heap.bytes_since_collection += delta;
+    }
+    _gc_heap.stats.live_bytes += delta;
+    if(_gc_heap.stats.peak_live_bytes < _gc_heap.stats.live_bytes)
+        _gc_heap.stats.peak_live_bytes = _gc_heap.stats.live_bytes;
+    if(_gc_heap.threshold <= _gc_heap.bytes_since_collection)
+        _gc_heap.collection_requested = 1;
+}
+
+void _gc_push_root(gc_object *obj) {
+    if(_gc_heap.roots_size == _gc_heap.roots_capacity) {
+        _gc_heap.roots_capacity *= 2;
+        gc_object **roots = (gc_object**) malloc(sizeof(gc_object*) * _gc_heap.roots_capacity);
+        memcpy(roots, _gc_heap.roots, sizeof(gc_object*) * _gc_heap.roots_size);
+        free(_gc_heap.roots);
+        _gc_heap.roots = roots;
+    }
+    _gc_heap.roots[_gc_heap.roots_size++] = obj;
+}
+
+void _gc_pop_root() {
+    assert(0 < _gc_heap.roots_size);
+    _gc_heap.roots_size -= 1;
+}
+
+// Marking uses an explicit gray stack so deeply nested closures cannot overflow the C stack.
+void _gc_mark(gc_object *obj) {
+    if(NULL == obj || obj->marked)
+        return;
+    obj->marked = 1;
+    if(_gc_heap.gray_size == _gc_heap.gray_capacity) {
+        _gc_heap.gray_capacity *= 2;
+        gc_object **gray = (gc_object**) malloc(sizeof(gc_object*) * _gc_heap.gray_capacity);
+        memcpy(gray, _gc_heap.gray, sizeof(gc_object*) * _gc_heap.gray_size);
+        free(_gc_heap.gray);
+        _gc_heap.gray = gray;
+    }
+    _gc_heap.gray[_gc_heap.gray_size++] = obj;
+}
+
+void _gc_free_object(gc_object *obj) {
+    _gc_heap.stats.objects_freed += 1;
+    _gc_heap.stats.bytes_freed += obj->size;
+    _gc_heap.stats.live_objects -= 1;
+    _gc_heap.stats.live_bytes -= obj->size;
+    if(NULL != obj->type->finalize)
+        obj->type->finalize(obj);
+    free(obj);
+}
+
+void _gc_collect() {
+    unsigned long long begin = _gc_now_ns();
+
+    for(size_t i = 0; i < _gc_heap.roots_size; ++i)
+        _gc_mark(_gc_heap.roots[i]);
+    while(_gc_heap.gray_size) {
+        gc_object *obj = _gc_heap.gray[--_gc_heap.gray_size];
+        if(NULL != obj->type->trace)
+            obj->type->trace(obj);
+    }
+
+    gc_object **link = &_gc_heap.objects;
+    while(NULL != *link) {
+        gc_object *obj = *link;
+        if(obj->marked) {
+            obj->marked = 0;
+            link = &obj->next;
+        } else {
+            *link = obj->next;
+            _gc_free_object(obj);
+        }
+    }
+
+    // Grow the threshold with the live heap so that collections stay proportional to the
+    // amount of allocation rather than the amount of live data.
+    size_t threshold = _gc_heap.initial_threshold;
+    if(threshold < _gc_heap.stats.live_bytes)
+        threshold = _gc_heap.stats.live_bytes;
+    _gc_heap.threshold = threshold;
+    _gc_heap.bytes_since_collection = 0;
+    _gc_heap.collection_requested = 0;
+
+    unsigned long long pause = _gc_now_ns() - begin;
+    _gc_heap.stats.collections += 1;
+    _gc_heap.stats.total_pause_ns += pause;
+    if(_gc_heap.stats.max_pause_ns < pause)
+        _gc_heap.stats.max_pause_ns = pause;
+
+    if(0 != _gc_heap.heap_limit && _gc_heap.heap_limit < _gc_heap.stats.live_bytes) {
+        lisp_output_flush();
+        printf("Heap limit exceeded! %zu live bytes (limit: %zu).\n",
+            _gc_heap.stats.live_bytes, _gc_heap.heap_limit);
+        lisp_fail();
+    }
+}
+
+// Releases every object regardless of reachability (used at exit / between isolated runs).
+void _gc_free_all() {
+    while(NULL != _gc_heap.objects) {
+        gc_object *obj = _gc_heap.objects;
+        _gc_heap.objects = obj->next;
+        _gc_free_object(obj);
+    }
+    _gc_heap.bytes_since_collection = 0;
+    _gc_heap.collection_requested = 0;
+}
+
+// Frees the heap and the collector's own state; the next `gc_init` starts from scratch.
+void _gc_shutdown() {
+    _gc_free_all();
+    if(_gc_heap.initialized) {
+        free(_gc_heap.roots);
+        free(_gc_heap.gray);
+    }
+    memset(&_gc_heap, 0, sizeof(_gc_heap));
+}
+
+void _gc_print_stats(FILE *fp) {
+    gc_stats s = _gc_heap.stats;
+    fprintf(fp, "--- GC statistics ---\n");
+    fprintf(fp, "collections:       %zu\n", s.collections);
+    fprintf(fp, "objects allocated: %zu (%zu bytes)\n", s.objects_allocated, s.bytes_allocated);
+    fprintf(fp, "objects freed:     %zu (%zu bytes)\n", s.objects_freed, s.bytes_freed);
+    fprintf(fp, "live objects:      %zu (%zu bytes, peak %zu bytes)\n",
+        s.live_objects, s.live_bytes, s.peak_live_bytes);
+    fprintf(fp, "total pause:       %.3f ms\n", s.total_pause_ns / 1e6);
+    fprintf(fp, "max pause:         %.3f ms\n", s.max_pause_ns / 1e6);
+    fprintf(fp, "mean pause:        %.3f ms\n",
+        s.collections ? (s.total_pause_ns / 1e6) / s.collections : 0.0);
+}
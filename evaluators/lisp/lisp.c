@@ -1,9 +1,13 @@
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <setjmp.h>
 #include "arena.c"
 #include "../../src/apli.h"
-#include "lisp_regex_cache.c"
+#include "lisp_regex_cache.h"
+#include "lisp_regex_scanners.h"
+#include "lisp_output.c"
+#include "gc.c"
 
 #define APLI_EVAL_ARGUMENTS     environment *env
 #define APLI_EVAL_NAMES         env
@@ -44,20 +48,46 @@ typedef struct _string_segment {
     size_t length;
 } string_segment;
 
-typedef string_segment identifier;
-typedef struct _return_value_type return_value;
-
+/**
+ * Every identifier and string literal is interned into a `symbol` that lives for the rest
+ * of the program, so values only carry a pointer and frames compare keys by address.
+ * `builtin` is set for the names of the special forms / primitives handled by `lisp_call`.
+ */
+typedef enum _builtin_kind {
+    NOT_BUILTIN, BUILTIN_ADD, BUILTIN_MUL, BUILTIN_SUB, BUILTIN_DIV, BUILTIN_EQ, BUILTIN_LT,
+    BUILTIN_GT, BUILTIN_LE, BUILTIN_GE, BUILTIN_LET, BUILTIN_DEFUN, BUILTIN_IF, BUILTIN_LAMBDA,
+    BUILTIN_FUNCALL, BUILTIN_TERPRI, BUILTIN_WRITE, BUILTIN_WRITE_STRING, BUILTIN_WRITE_LINE,
+    BUILTIN_PROGN, BUILTIN_AND, BUILTIN_OR
+} builtin_kind;
+
+typedef struct _symbol {
+    string_segment name;
+    size_t hash;
+    builtin_kind builtin;
+} symbol;
+
+typedef symbol* identifier;
 typedef struct _return_value_type return_value;
 typedef struct _identifier_return_value_map_ _identifier_return_value_map_t;
 typedef Map(identifier, return_value)* frame;
 typedef struct _frame_vector_ Vector(frame);
 typedef struct _identifier_vector_ Vector(identifier);
 
-typedef struct _environment {
+/**
+ * Environments and function closures live on the GC heap (see `gc.c`). An environment
+ * owns all of its frames except the first `shared_frames`, which belong to `owner` (the
+ * global frame is shared by every closure cloned from it).
+ */
+typedef struct _environment environment;
+struct _environment {
+    gc_object gc;
     Vector(frame) *stack_frame;
-} environment;
+    environment *owner;
+    size_t shared_frames;
+};
 
 typedef struct _function_value {
+    gc_object gc;
     environment *closure;
     ApliNode function_pointer;
     Vector(identifier) *arguments;
@@ -66,13 +96,18 @@ typedef struct _function_value {
 // NONE is used as a placeholder for implementing recursively defined functions.
 typedef enum _rv_type {NUMBER, IDENTIFIER, FUNCTION, STRING} rv_type;
 /**
- * NUMBER -> ref is size_t
- * IDENTIFIER -> ref is string_segment
+ * NUMBER -> ref.num is an immediate int
+ * IDENTIFIER -> ref.sym is the interned name
+ * STRING -> ref.str is the interned contents of the literal (without the quotes)
+ * FUNCTION -> ref.fun_v is a GC heap object
+ *
+ * A return_value is 16 bytes, so it is passed and returned in registers.
  */
 typedef union _rv_data {
     int num;
-    string_segment segment;
-    function_value fun_v;
+    symbol *sym;
+    symbol *str;
+    function_value *fun_v;
 } rv_data;
 
 typedef struct _return_value_type {
@@ -80,10 +115,16 @@ typedef struct _return_value_type {
     rv_data ref;
 } return_value;
 
+_Static_assert(sizeof(return_value) <= 16, "return_value must stay two words wide");
+
 define_map(identifier, return_value);
 define_vector(frame);
 define_vector(identifier);
 
+typedef struct _string_segment_identifier_map_ _string_segment_identifier_map_t;
+define_map(string_segment, identifier);
+Map(string_segment, identifier) *symbol_table = NULL;
+
 #define resolve_id(env, id)         _resolve_identifier(env, id)
 #define env_new()                   _env_new()
 #define env_free(env)               _env_free(env)
@@ -94,21 +135,28 @@ define_vector(identifier);
 #define seg_to_str(seg)             _segment_to_str(seg)
 #define seg_eq_str(seg, str)        _segment_eq_str(seg, str)
 #define str_to_seg(str, len)        _str_to_segment(str, len)
+#define intern(seg)                 _intern(seg)
 
 const char* ftoca(const char* file_path);
-return_value _resolve_identifier(environment *env, string_segment id);
+return_value _resolve_identifier(environment *env, identifier id);
 environment *_env_new();
 void _env_free(environment *env);
 void _push_frame(environment *env);
 void _pop_frame(environment *env);
-void _extend_env(environment *env, string_segment id, return_value rv);
+void _extend_env(environment *env, identifier id, return_value rv);
 environment *_clone_env(environment *env);
+function_value *function_new(environment *closure, ApliNode body, Vector(identifier) *args);
 
 size_t seg_hash(string_segment seg);
 size_t seg_eq(string_segment seg1, string_segment seg2);
 const char *_segment_to_str(string_segment segment);
 string_segment _str_to_segment(const char* str, size_t len);
 size_t _segment_eq_str(string_segment segment, const char *str);
+symbol *_intern(string_segment seg);
+void intern_builtins();
+return_value decode_atomic_symbol(string_segment segment);
+void annotate_literals(ApliNode node);
+identifier atomic_symbol_identifier(ApliNode atomic_symbol_node);
 
 apli_init();
 apli_define_functions(s_expression, list, s_expressions, atomic_symbol);
@@ -133,18 +181,69 @@ void print_return_value(return_value val);
 void print_return_type(return_value val);
 void print_frame(frame f);
 
+// The grammar, token rules and evaluation hooks are built once by `lisp_init` and shared by
+// every script the process evaluates (see `lisp_server.c`).
+_bnf_rules_t *bnf_rules;
+_token_rules_t *token_rules;
+parser_type parser_type_inst = LEFT_TO_RIGHT;
+_parse_tree_t parse_tree_result;
+size_t has_parse_tree_result = 0;
+List(_token_t) *script_tokens = NULL;  // kept reachable until parsed, for a parse error to free
+
+// Evaluation errors jump to `lisp_error_jmp` when it is set (server mode), otherwise they exit.
+jmp_buf *lisp_error_jmp = NULL;
+_Noreturn void lisp_fail();
+_Noreturn void lisp_parse_fail();
+
+void lisp_init();
+void lisp_init_token_rules(size_t compile);
+void lisp_run_script(const char *input);
+void lisp_evaluate_script();
+void lisp_release_script();
+void symbols_free();
+
+#include "lisp_server.c"
+
+// Compile with -DLISP_NO_MAIN to embed the evaluator in another program (ie. the benchmark
+// harness in test/benchmark).
+#ifndef LISP_NO_MAIN
 
 int main(int argc, char **argv) {
     _initialize_memory();
 
-    _bnf_rules_t *bnf_rules = (_bnf_rules_new());
-    _token_rules_t *token_rules = (_token_rules_fns_impl._new());
-    _parse_tree_t parse_tree_result;
+    if(argc < 2 || 3 < argc)
+        assert(0 == "Invalid # of arguments to executable.");
+
+    lisp_init();
+
+    if(0 == strcmp("--server", argv[1]) || 0 == strcmp("--socket", argv[1]))
+        return lisp_server_main(argc, argv);
+
+    const char *input;
+    if(0 == strcmp("-e", argv[1]) || 0 == strcmp("--execute", argv[1])) {
+        if(3 != argc) {
+            printf("A second argument was not provided.\n");
+            exit(1);
+        }
+        input = argv[2];
+    } else {
+        if(2 != argc) {
+            printf("Invalid arguments provided to executable.\n");
+            exit(1);
+        }
+        input = ftoca(argv[1]);
+    }
+
+    lisp_run_script(input);
+
+__APLI_END__
+#endif
+
+void lisp_init() {
     eval_fns = (_apli_function_name_apli_function_reference_new_map());
     ((eval_fns)->key_eq = (&str_eq));
     ((eval_fns)->hash = (&str_hash));
-    parser_type parser_type_inst = LEFT_TO_RIGHT;
-
+    bnf_rules = (_bnf_rules_new());
 
     // If we didn't parse right to left, then the parser errors on "(A B C)". This is due to the
     // lack of a `s_expressions := s_expressions s_expressions` rule. See the README for more information.
@@ -152,31 +251,11 @@ int main(int argc, char **argv) {
     // compiler flags and comment out the line below to use the default `LEFT_TO_RIGHT` parser.
     apli_set_parser_type(RIGHT_TO_LEFT);
 
-    if(argc < 2 || 3 < argc)
-        assert(0 == "Invalid # of arguments to executable.");
-
     apli_non_terminals(s_expression, list, s_expressions, atomic_symbol);
     apli_terminals(ATOMIC_SYMBOL, OPEN_PAREN, CLOSE_PAREN, PERIOD, COMMENT);
 
-    apli_regex_init();
-    apli_regex(
-        (COMMENT, ";[^\n]*"),
-        (ATOMIC_SYMBOL, "(\"([^\n\"]|\\\")*\"|[a-z0-9\\-]+|(<=|>=|[+-\\*/<>=]))"),
-        (OPEN_PAREN, "\\("),
-        (CLOSE_PAREN, "\\)"),
-        (PERIOD, "\\.")
-    );
+    lisp_init_token_rules(0);
 
-    // Only have one of the following uncommented:
-    // apli_regex_compile();    // compiles the regexes into a flat_dfa during runtime
-    apli_regex_load(
-        (COMMENT, forward_comment, backward_comment),
-        (ATOMIC_SYMBOL, forward_atomic_symbol, backward_atomic_symbol),
-        (OPEN_PAREN, forward_op_paren, backward_op_paren),
-        (CLOSE_PAREN, forward_close_paren, backward_close_paren),
-        (PERIOD, forward_period, backward_period)
-    );                          // loads the regexes from `lisp_regex_cache.c`
-    
     apli_bnf(
         (s_expression, atomic_symbol),
         (s_expression, OPEN_PAREN, s_expression, PERIOD, s_expression, CLOSE_PAREN),
@@ -187,50 +266,193 @@ int main(int argc, char **argv) {
         (s_expressions, s_expression, s_expressions),
         (atomic_symbol, ATOMIC_SYMBOL)
     );
+    bnf_rules_prepare(bnf_rules, parser_type_inst);
 
-    const char *input;
-    if(0 == strcmp("-e", argv[1]) || 0 == strcmp("--execute", argv[1])) {
-        if(3 != argc) {
-            printf("A second argument was not provided.\n");
-            exit(1);
-        }
-        input = argv[2];
-    } else {
-        if(2 != argc) {
-            printf("Invalid arguments provided to executable.\n");
-            exit(1);
-        }
-        input = ftoca(argv[1]);
-    }
+    lisp_output_init();
+}
 
-    List(_token_t) *tokens = token_rules_tokenize(token_rules, input);
-    _token_rules_ignore_token(tokens, "COMMENT");
-    parse_tree_result = bnf_rules_construct_parse_tree(bnf_rules, tokens, parser_type_inst);
+// (Re)builds `token_rules`. The DFAs are either compiled from the regexes or loaded from
+// `lisp_regex_cache.h` (the default), which is generated from `lisp_regexes.txt`.
+void lisp_init_token_rules(size_t compile) {
+    token_rules = (_token_rules_fns_impl._new());
+
+    apli_regex_init();
+    apli_regex(
+        (COMMENT, ";[^\n]*"),
+        (ATOMIC_SYMBOL, "(\"([^\n\"]|\\\")*\"|[a-z0-9\\-]+|(<=|>=|[+-\\*/<>=]))"),
+        (OPEN_PAREN, "\\("),
+        (CLOSE_PAREN, "\\)"),
+        (PERIOD, "\\.")
+    );
+    apli_regex_skip(COMMENT);
+
+#ifdef LAZY_DFA
+    // Determinizes the DFAs while tokenizing instead of loading the cache and the scanners.
+    apli_regex_compile();
+    return;
+#endif
+    // Regexes that changed since the cache was generated are compiled instead of loaded.
+    size_t stale = compile ? 0 : apli_regex_load_cache(lisp_regex_cache);
+    if(0 < stale)
+        fprintf(stderr, "lisp: %zu cached DFAs are stale, run `./compile.sh regex-cache`.\n", stale);
+    if(compile || 0 < stale)
+        apli_regex_compile();   // compiles the regexes into a flat_dfa during runtime
+#ifndef LISP_TABLE_DFA
+    // Tokenizes with the direct-coded scanners of `lisp_regex_scanners.h` instead of the DFA
+    // tables (compile with -DLISP_TABLE_DFA to compare them).
+    apli_regex_load_scanners(lisp_regex_scanners);
+#endif
+}
+
+void lisp_run_script(const char *input) {
+    script_tokens = token_rules_tokenize(token_rules, input);
+    parse_tree_result = bnf_rules_construct_parse_tree(bnf_rules, script_tokens, parser_type_inst);
+    has_parse_tree_result = 1;
+    list_free(script_tokens);
+    script_tokens = NULL;
 
     // DRY_RUN wil only run the lexing and parsing steps. Since the evaluation is the
     // user's responsibility, I will be focusing on optimizing the dry run.
-#ifdef DRY_RUN
-    exit(0);
+#ifndef DRY_RUN
+    lisp_evaluate_script();
 #endif
+}
 
+// Evaluates `parse_tree_result` in a fresh environment.
+void lisp_evaluate_script() {
+    apli_alloc_push_tag(APLI_ALLOC_EVALUATOR);
+    gc_init();
+    intern_builtins();
+    annotate_literals(parse_tree_result.root);
     environment *env = env_new();
+    gc_push_root(env);
     push_frame(env);
     apli_evaluate_node(parse_tree_result.root);
-    env_free(env);
+    gc_pop_root();
+    gc_free_all();
+    apli_alloc_pop_tag();
 
-__APLI_END__
+#ifdef PRINT_GC_STATS
+    gc_print_stats(stderr);
+#endif
+}
+
+void free_annotations(ApliNode node) {
+    if(NULL != apli_annotation())
+        free(apli_annotation());
+    for(size_t i = 1; i <= apli_num_children(); ++i)
+        free_annotations(apli_get_child(i));
+}
+
+// Releases everything `lisp_run_script` allocated, including after a parse or evaluation error.
+void lisp_release_script() {
+    if(NULL != script_tokens) {
+        list_free(script_tokens);
+        script_tokens = NULL;
+    }
+    if(has_parse_tree_result) {
+        free_annotations(parse_tree_result.root);
+        parse_tree_free(parse_tree_result);
+        has_parse_tree_result = 0;
+    }
+    symbols_free();
+    gc_shutdown();
+}
+
+_Noreturn void lisp_fail() {
+    lisp_output_flush();
+    if(NULL != lisp_error_jmp)
+        longjmp(*lisp_error_jmp, 1);
+    exit(1);
+}
+
+// The parser's error handler: the parser reports the details on stderr.
+_Noreturn void lisp_parse_fail() {
+    lisp_output_flush();
+    printf("Parse error! The script is not a sequence of s-expressions.\n");
+    lisp_fail();
+}
+
+// Stops the script on an error in it (ie. a wrong argument), after the output so far.
+_Noreturn void lisp_error(const char *message) {
+    lisp_output_flush();
+    printf("%s\n", message);
+    lisp_fail();
+}
+
+
+#define FRAME_ENTRY_SIZE \
+    (sizeof(MapMatch(identifier, return_value)) + 2 * sizeof(void*))
+#define FRAME_SIZE(f) \
+    (sizeof(*(f)) + sizeof(void*) * vector_size((f)->buckets) + map_size(f) * FRAME_ENTRY_SIZE)
+
+void trace_return_value(return_value rv) {
+    if(FUNCTION == rv.type)
+        gc_mark(rv.ref.fun_v);
+}
+
+void trace_frame(frame f) {
+    size_t buckets_size = vector_size(f->buckets);
+    for(size_t i = 0; i < buckets_size; ++i) {
+        _identifier_return_value_map_match_list_t bucket = vector_get(f->buckets, i);
+        if(NULL == bucket)
+            continue;
+        Iterator(_identifier_return_value_map_match_t) *iter = list_get_iterator(bucket);
+        while(NULL != iter) {
+            trace_return_value(iter_val(iter).value);
+            iter = iter_next(iter);
+        }
+    }
+}
+
+void _env_trace(gc_object *obj) {
+    environment *env = (environment*) obj;
+    gc_mark(env->owner);
+    for(size_t i = env->shared_frames; i < vector_size(env->stack_frame); ++i)
+        trace_frame(vector_get(env->stack_frame, i));
+}
+
+void _env_finalize(gc_object *obj) {
+    environment *env = (environment*) obj;
+    while(env->shared_frames < vector_size(env->stack_frame)) {
+        map_free(vector_get_back(env->stack_frame));
+        vector_pop_back(env->stack_frame);
+    }
+    vector_free(env->stack_frame);
+}
+
+void _function_trace(gc_object *obj) {
+    gc_mark(((function_value*) obj)->closure);
+}
+
+void _function_finalize(gc_object *obj) {
+    vector_free(((function_value*) obj)->arguments);
+}
+
+const gc_type environment_gc_type = {"environment", &_env_trace, &_env_finalize};
+const gc_type function_gc_type = {"function", &_function_trace, &_function_finalize};
 
 environment *_env_new() {
-    environment *env = (environment*) malloc(sizeof(environment));
+    environment *env = (environment*) gc_alloc(&environment_gc_type, sizeof(environment));
     env->stack_frame = vector_new(frame);
+    env->owner = NULL;
+    env->shared_frames = 0;
     return env;
 }
 
+// Environments are reclaimed by the collector; `env_free` only drops the owned frames early.
 void _env_free(environment *env) {
-    while(vector_size(env->stack_frame))
+    while(env->shared_frames < vector_size(env->stack_frame))
         pop_frame(env);
-    vector_free(env->stack_frame);
-    free(env);
+}
+
+function_value *function_new(environment *closure, ApliNode body, Vector(identifier) *args) {
+    function_value *fun = (function_value*) gc_alloc(&function_gc_type, sizeof(function_value));
+    fun->closure = closure;
+    fun->function_pointer = body;
+    fun->arguments = args;
+    gc_account(fun, sizeof(identifier) * vector_size(args));
+    return fun;
 }
 
 apli_function(s_expressions) {
@@ -253,7 +475,7 @@ apli_function(s_expression) {
         return apli_eval_child(1);
     } else if(apli_child_token_name_equals(OPEN_PAREN, 1)) {
         // s_expression = "(" s_expression "." s_expressison ")"
-        assert(0 == "Not implemented!");
+        lisp_error("Dotted pairs are not implemented!");
     } else {
         // s_expression = list
         return apli_eval_child(1);
@@ -264,27 +486,89 @@ apli_function(s_expression) {
 apli_function(atomic_symbol) {
     // printf("atomic_symbol\n");
     // atomic_symbol := r"[^a-z1-9][a-z1-9]+[^a-z1-9]" [OFFSET: +1 ; -1]
-    ApliToken tok = apli_get_child_token(1);
-    string_segment segment = {apli_token_ref(tok), apli_token_reflen(tok)};
+    // Literals are decoded once by `annotate_literals`, before evaluation.
+    return_value *literal = (return_value*) apli_annotation();
     return_value rv;
-    if('0' <= apli_token_ref(tok)[0] && apli_token_ref(tok)[0] <= '9') {
+    if(NULL != literal) {
+        rv = *literal;
+    } else {
+        ApliToken tok = apli_get_child_token(1);
+        rv = decode_atomic_symbol(str_to_seg(apli_token_ref(tok), apli_token_reflen(tok)));
+    }
+    if(IDENTIFIER == rv.type)
+        return resolve_id(env, rv.ref.sym);
+    return rv;
+}
+
+return_value decode_atomic_symbol(string_segment segment) {
+    return_value rv;
+    if('0' <= segment.str[0] && segment.str[0] <= '9') {
         rv.type = NUMBER;
-        rv.ref.num = atoi(seg_to_str(segment));
-        return rv;
-    } else if(('"' == apli_token_ref(tok)[0]) && ('"' == apli_token_ref(tok)[segment.length - 1])) {
+        rv.ref.num = 0;
+        for(size_t i = 0; i < segment.length && '0' <= segment.str[i] && segment.str[i] <= '9'; ++i)
+            rv.ref.num = 10 * rv.ref.num + (segment.str[i] - '0');
+    } else if(('"' == segment.str[0]) && ('"' == segment.str[segment.length - 1])) {
+        // Strip the quotes and resolve the escape sequences understood by `write`.
+        const char *str = segment.str + 1;
+        size_t length = segment.length - 2;
+        char *buff = (char*) malloc(length + 1);
+        size_t buff_length = 0;
+        for(size_t i = 0; i < length; ++i) {
+            if('\\' == str[i] && i + 1 < length) {
+                switch(str[i + 1]) {
+                case 'n':
+                    buff[buff_length++] = '\n';
+                    i += 1;
+                    break;
+                case 'r':
+                    buff[buff_length++] = '\r';
+                    i += 1;
+                    break;
+                case 't':
+                    buff[buff_length++] = '\t';
+                    i += 1;
+                    break;
+                default:
+                    buff[buff_length++] = '\\';
+                    break;
+                }
+                continue;
+            }
+            buff[buff_length++] = str[i];
+        }
         rv.type = STRING;
-        rv.ref.segment = segment;
-
-        // offset the string:
-        rv.ref.segment.str += 1;
-        rv.ref.segment.length -= 2;
-
-        return rv;
+        rv.ref.str = intern(str_to_seg(buff, buff_length));
+        free(buff);
     } else {
-        return resolve_id(env, segment);
+        rv.type = IDENTIFIER;
+        rv.ref.sym = intern(segment);
     }
-    
-    assert(0 == "Not reachable");
+    return rv;
+}
+
+// Stores the decoded value of every `atomic_symbol` in its node's annotation.
+void annotate_literals(ApliNode node) {
+    for(size_t i = 1; i <= apli_num_children(); ++i) {
+        ApliNode child = apli_get_child(i);
+        if(!child.root.is_terminal_t)
+            continue;
+        if(apli_node_terminal_name_equals(child, atomic_symbol) && NULL == apli_node_annotation(child)) {
+            ApliToken tok = apli_node_get_child(child, 1).root.ptr.token;
+            return_value *literal = (return_value*) malloc(sizeof(return_value));
+            *literal = decode_atomic_symbol(str_to_seg(apli_token_ref(tok), apli_token_reflen(tok)));
+            apli_node_annotate_child(node, i, literal);
+        } else {
+            annotate_literals(child);
+        }
+    }
+}
+
+identifier atomic_symbol_identifier(ApliNode node) {
+    return_value *literal = (return_value*) apli_annotation();
+    if(NULL != literal && IDENTIFIER == literal->type)
+        return literal->ref.sym;
+    ApliToken tok = apli_get_child_token(1);
+    return intern(str_to_seg(apli_token_ref(tok), apli_token_reflen(tok)));
 }
 
 return_value lisp_call(return_value id, Vector(_parse_tree_node_t) *children, environment*);
@@ -296,8 +580,9 @@ apli_function(list) {
         ApliNode sexprs = apli_get_child(2);
         return lisp_call(apli_evaluate_node(vector_get(sexprs.children, 0)), sexprs.children, env);
     }
+    lisp_output_flush();
     printf("Evaluating '()' is not possible!\n");
-    assert(0 == "Invalid evaluation state!");
+    lisp_fail();
 }
 
 char *add_pre_post_buffer(const char *str, size_t buffer_size) {
@@ -316,7 +601,7 @@ char *add_pre_post_buffer(const char *str, size_t buffer_size) {
     return cpy;
 }
 
-return_value _resolve_identifier(environment *env, string_segment id) {
+return_value _resolve_identifier(environment *env, identifier id) {
     Vector(frame) *sf = env->stack_frame;
     size_t sz = vector_size(sf);
 
@@ -335,7 +620,7 @@ return_value _resolve_identifier(environment *env, string_segment id) {
     }
     return_value rv;
     rv.type = IDENTIFIER;
-    rv.ref.segment = id;
+    rv.ref.sym = id;
     return rv;
     // printf("Invalid Identifier Error! Identifier `%s` is not bound.\n", seg_to_str(id));
     // assert(0 == "Invalid identifier");
@@ -355,6 +640,14 @@ size_t seg_hash(string_segment seg) {
     return hash; 
 }
 
+size_t symbol_hash(identifier sym) {
+    return sym->hash;
+}
+
+size_t symbol_eq(identifier sym1, identifier sym2) {
+    return sym1 == sym2;
+}
+
 size_t seg_eq(string_segment seg1, string_segment seg2) {
     // printf("Comparing: "); print_string_segment(seg1); printf(" "); print_string_segment(seg2);
     // printf("\n");
@@ -369,48 +662,61 @@ size_t seg_eq(string_segment seg1, string_segment seg2) {
 
 void _push_frame(environment *env) {
     frame f = map_new(identifier, return_value);
-    map_set_hash(f, &seg_hash);
-    map_set_key_eq(f, &seg_eq);
+    map_set_hash(f, &symbol_hash);
+    map_set_key_eq(f, &symbol_eq);
     vector_push_back(env->stack_frame, f);
+    gc_account(env, FRAME_SIZE(f));
 }
 
 void _pop_frame(environment *env) {
-    assert(0 < vector_size(env->stack_frame));
-    map_free(vector_get_back(env->stack_frame));
+    assert(env->shared_frames < vector_size(env->stack_frame));
+    frame f = vector_get_back(env->stack_frame);
+    gc_account(env, -(long) FRAME_SIZE(f));
+    map_free(f);
     vector_pop_back(env->stack_frame);
 }
 
-void _extend_env(environment *env, string_segment id, return_value rv) {
+void _extend_env(environment *env, identifier id, return_value rv) {
 #ifndef NO_ID_BINDING_WARN
     if(IDENTIFIER == rv.type)
-        (assert(0 == "Warning! Binding value is an identifier!"));
+        lisp_error("Binding value is an identifier!");
 #endif
     frame f = vector_get_back(env->stack_frame);
+    long sz = FRAME_SIZE(f);
     map_insert(f, id, rv);
+    gc_account(env, (long) FRAME_SIZE(f) - sz);
 }
 
 environment *_clone_env(environment *env) {
     size_t sz = vector_size(env->stack_frame);
     environment *new_env = env_new();
+    new_env->owner = (NULL == env->owner) ? env : env->owner;
+    new_env->shared_frames = 1;
     vector_push_back(new_env->stack_frame, vector_get(env->stack_frame, 0));
     for(size_t i = 1; i < sz; ++i) {
         frame nxt_frame = vector_get(env->stack_frame, i);
         frame frame_clone = map_clone(nxt_frame);
         vector_push_back(new_env->stack_frame, frame_clone);
+        gc_account(new_env, FRAME_SIZE(frame_clone));
     }
     return new_env;
 }
 
+#define CHECK_ARGUMENT(result, result_type) \
+    if(result_type != (result).type) { \
+        lisp_output_flush(); \
+        printf("Argument must be " #result_type "! Result: "); \
+        print_return_value(result); \
+        printf("\n"); \
+        lisp_fail(); \
+    }
+
 #define LOOP_OVER_REST_SEXPRS(children, result_type, step_expr) \
     if(1 < vector_size(children)) { \
         ApliNode node = vector_get(children, 1); \
         while(apli_node_terminal_name_equals(node, s_expressions)) { \
             return_value result = apli_evaluate_child(1); \
-            if(result_type != result.type) { \
-                printf("Argument must be " #result_type "! Result: "); \
-                print_return_value(result); \
-                assert(0 == "Invalid argument!"); \
-            } \
+            CHECK_ARGUMENT(result, result_type); \
             step_expr; \
             if(vector_size(node.children) < 2) \
                 break; \
@@ -418,6 +724,23 @@ environment *_clone_env(environment *env) {
         } \
     }
 
+// The number of arguments of a call: the length of the s_expressions after the callee.
+size_t lisp_num_args(Vector(_parse_tree_node_t) *children) {
+    if(vector_size(children) < 2)
+        return 0;
+    ApliNode node = vector_get(children, 1);
+    size_t num_args = 1;
+    for(; 2 == apli_num_children(); ++num_args)
+        node = apli_get_child(2);
+    return num_args;
+}
+
+void lisp_check_num_args(Vector(_parse_tree_node_t) *children, size_t min, size_t max) {
+    size_t num_args = lisp_num_args(children);
+    if(num_args < min || max < num_args)
+        lisp_error("Invalid # of arguments given to function call.");
+}
+
 size_t return_value_is_truthy(return_value);
 void map_bindings(ApliNode node, environment *env);
 Vector(identifier) *construct_list_of_args(ApliNode args_node, environment *env);
@@ -425,58 +748,64 @@ Vector(identifier) *construct_list_of_args(ApliNode args_node, environment *env)
 
 return_value lisp_call(return_value id, Vector(_parse_tree_node_t) *children, environment *env) {
     if(IDENTIFIER == id.type) // used to resolve recursive identifiers.
-        id = resolve_id(env, id.ref.segment);
+        id = resolve_id(env, id.ref.sym);
 #ifdef PRINT_STACK_FRAME
+    lisp_output_flush();
     printf("\x1b[31;1m");
     print_return_value(id); printf(" "); print_env(env); 
     printf("\x1b[0m\n");
 #endif
 
     if(NUMBER == id.type) {
+        lisp_output_flush();
         printf("Number `%d` is not callable.\n", id.ref.num);
-        exit(1);
+        lisp_fail();
     } else if(IDENTIFIER == id.type) {
-        if(seg_eq_str(id.ref.segment, "+")) {
+        builtin_kind builtin = id.ref.sym->builtin;
+        if(BUILTIN_ADD == builtin) {
             int total = 0;
             LOOP_OVER_REST_SEXPRS(children, NUMBER, total += result.ref.num);
             return_value rv;
             rv.type = NUMBER;
             rv.ref.num = total;
             return rv;
-        } else if(seg_eq_str(id.ref.segment, "*")) {
+        } else if(BUILTIN_MUL == builtin) {
             int total = 1;
             LOOP_OVER_REST_SEXPRS(children, NUMBER, total *= result.ref.num);
             return_value rv;
             rv.type = NUMBER;
             rv.ref.num = total;
             return rv;
-        } else if(seg_eq_str(id.ref.segment, "-")) {
-            ApliNode node = vector_get(children, 1); \
+        } else if(BUILTIN_SUB == builtin) {
+            lisp_check_num_args(children, 1, ~0UL);
+            ApliNode node = vector_get(children, 1);
             return_value ret = apli_evaluate_child(1);
-            assert(NUMBER == ret.type);
+            CHECK_ARGUMENT(ret, NUMBER);
             int total = ret.ref.num;
             if(1 == apli_num_children())
                 total = -total;
-            assert(1 < vector_size(children));
             children = vector_get(children, 1).children;
             LOOP_OVER_REST_SEXPRS(children, NUMBER, total -= result.ref.num);
             return_value rv;
             rv.type = NUMBER;
             rv.ref.num = total;
             return rv;
-        } else if(seg_eq_str(id.ref.segment, "/")) {
+        } else if(BUILTIN_DIV == builtin) {
+            lisp_check_num_args(children, 1, ~0UL);
             ApliNode node = vector_get(children, 1);
             return_value ret = apli_evaluate_child(1);
-            assert(NUMBER == ret.type);
+            CHECK_ARGUMENT(ret, NUMBER);
             int total = ret.ref.num;
-            assert(1 < vector_size(children));
             children = vector_get(children, 1).children;
-            LOOP_OVER_REST_SEXPRS(children, NUMBER, total /= result.ref.num);
+            LOOP_OVER_REST_SEXPRS(children, NUMBER,
+                if(0 == result.ref.num) lisp_error("Division by zero!");
+                total /= result.ref.num);
             return_value rv;
             rv.type = NUMBER;
             rv.ref.num = total;
             return rv;
-        } else if (seg_eq_str(id.ref.segment, "=")) {
+        } else if(BUILTIN_EQ == builtin) {
+            lisp_check_num_args(children, 2, 2);
             ApliNode node = vector_get(children, 1);
             return_value val1 = apli_evaluate_child(1);
             node = apli_get_child(2);
@@ -485,7 +814,8 @@ return_value lisp_call(return_value id, Vector(_parse_tree_node_t) *children, en
             ret.type = NUMBER;
             ret.ref.num = NUMBER == val1.type && NUMBER == val2.type && val1.ref.num == val2.ref.num;
             return ret;
-        } else if (seg_eq_str(id.ref.segment, "<")) {
+        } else if(BUILTIN_LT == builtin) {
+            lisp_check_num_args(children, 2, 2);
             ApliNode node = vector_get(children, 1);
             return_value val1 = apli_evaluate_child(1);
             node = apli_get_child(2);
@@ -494,7 +824,8 @@ return_value lisp_call(return_value id, Vector(_parse_tree_node_t) *children, en
             ret.type = NUMBER;
             ret.ref.num = NUMBER == val1.type && NUMBER == val2.type && val1.ref.num < val2.ref.num;
             return ret;
-        } else if (seg_eq_str(id.ref.segment, ">")) {
+        } else if(BUILTIN_GT == builtin) {
+            lisp_check_num_args(children, 2, 2);
             ApliNode node = vector_get(children, 1);
             return_value val1 = apli_evaluate_child(1);
             node = apli_get_child(2);
@@ -503,7 +834,8 @@ return_value lisp_call(return_value id, Vector(_parse_tree_node_t) *children, en
             ret.type = NUMBER;
             ret.ref.num = NUMBER == val1.type && NUMBER == val2.type && val1.ref.num > val2.ref.num;
             return ret;
-        } else if (seg_eq_str(id.ref.segment, "<=")) {
+        } else if(BUILTIN_LE == builtin) {
+            lisp_check_num_args(children, 2, 2);
             ApliNode node = vector_get(children, 1);
             return_value val1 = apli_evaluate_child(1);
             node = apli_get_child(2);
@@ -514,7 +846,8 @@ return_value lisp_call(return_value id, Vector(_parse_tree_node_t) *children, en
             // printf("val2.ref.num = %d\n", val2.ref.num);
             ret.ref.num = NUMBER == val1.type && NUMBER == val2.type && val1.ref.num <= val2.ref.num;
             return ret;
-        } else if (seg_eq_str(id.ref.segment, ">=")) {
+        } else if(BUILTIN_GE == builtin) {
+            lisp_check_num_args(children, 2, 2);
             ApliNode node = vector_get(children, 1);
             return_value val1 = apli_evaluate_child(1);
             node = apli_get_child(2);
@@ -523,7 +856,8 @@ return_value lisp_call(return_value id, Vector(_parse_tree_node_t) *children, en
             ret.type = NUMBER;
             ret.ref.num = NUMBER == val1.type && NUMBER == val2.type && val1.ref.num >= val2.ref.num;
             return ret;
-        } else if(seg_eq_str(id.ref.segment, "let")) {
+        } else if(BUILTIN_LET == builtin) {
+            lisp_check_num_args(children, 2, ~0UL);
             ApliNode node = vector_get(children, 1);
             ApliNode bindings = apli_get_child(1);
             node = apli_get_child(2);
@@ -531,44 +865,42 @@ return_value lisp_call(return_value id, Vector(_parse_tree_node_t) *children, en
             push_frame(env);
             map_bindings(bindings, env);
             return_value body_evaluation = apli_evaluate_node(node);
-            // printf("BODY: "); print_return_value(resolve_id(env, body_evaluation.ref.segment));
+            // printf("BODY: "); print_return_value(resolve_id(env, body_evaluation.ref.sym));
             pop_frame(env);
             return body_evaluation;
-        } else if(seg_eq_str(id.ref.segment, "defun")) {
+        } else if(BUILTIN_DEFUN == builtin) {
+            lisp_check_num_args(children, 3, ~0UL);
             ApliNode node = vector_get(children, 1);
             ApliNode function_name = apli_node_get_child(apli_get_child(1), 1);
             if(!apli_node_terminal_name_equals(function_name, atomic_symbol))
-                assert(0 == "Function name must be an atomic_symbol");
+                lisp_error("Function name must be an atomic_symbol");
             return_value function_name_rv = apli_evaluate_node(function_name);
-            assert(IDENTIFIER == function_name_rv.type);
-            identifier function_name_id = function_name_rv.ref.segment;
+            if(IDENTIFIER != function_name_rv.type)
+                lisp_error("Function name is not an identifier!");
+            identifier function_name_id = function_name_rv.ref.sym;
 
             node = apli_get_child(2);
             ApliNode args_node = apli_get_child(1);
             ApliNode function_body = apli_get_child(2);
 
-            environment *nenv = env_new();
-            Vector(identifier) *identifier_vec = construct_list_of_args(args_node, nenv);
-            env_free(nenv);
+            Vector(identifier) *identifier_vec = construct_list_of_args(args_node, env);
 
             return_value rv;
             rv.type = FUNCTION;
-
-            rv.ref.fun_v.closure = clone_env(env);
-            rv.ref.fun_v.function_pointer = function_body;
-            rv.ref.fun_v.arguments = identifier_vec;
+            rv.ref.fun_v = function_new(clone_env(env), function_body, identifier_vec);
 
             // print_env(env);
-            // print_env(rv.ref.fun_v.closure);
-            extend_env(rv.ref.fun_v.closure, function_name_id, rv);
+            // print_env(rv.ref.fun_v->closure);
+            extend_env(rv.ref.fun_v->closure, function_name_id, rv);
             extend_env(env, function_name_id, rv);
 
             // printf("Function made "); print_return_value(rv);
             // print_env(env);
-            // print_env(rv.ref.fun_v.closure);
+            // print_env(rv.ref.fun_v->closure);
 
             return rv;
-        } else if(seg_eq_str(id.ref.segment, "if")) {
+        } else if(BUILTIN_IF == builtin) {
+            lisp_check_num_args(children, 2, 3);
             ApliNode node = vector_get(children, 1);
             return_value comp = apli_evaluate_child(1);
             if(return_value_is_truthy(comp)) {
@@ -576,88 +908,73 @@ return_value lisp_call(return_value id, Vector(_parse_tree_node_t) *children, en
                 return apli_evaluate_child(1);
             } else {
                 node = apli_get_child(2);
+                if(1 == apli_num_children()) {
+                    // (no else branch: false, as `and` returns it)
+                    return_value zero;
+                    zero.type = NUMBER;
+                    zero.ref.num = 0;
+                    return zero;
+                }
                 node = apli_get_child(2);
                 return apli_evaluate_child(1);
             }
-        } else if(seg_eq_str(id.ref.segment, "lambda")) {
+        } else if(BUILTIN_LAMBDA == builtin) {
+            lisp_check_num_args(children, 2, ~0UL);
             ApliNode node = vector_get(children, 1);
             ApliNode args_node = apli_get_child(1);
             ApliNode function_body = apli_get_child(2);
 
-            environment *nenv = env_new();
-            Vector(identifier) *identifier_vec = construct_list_of_args(args_node, nenv);
-            env_free(nenv);
+            Vector(identifier) *identifier_vec = construct_list_of_args(args_node, env);
 
             return_value rv;
             rv.type = FUNCTION;
-
-            rv.ref.fun_v.closure = clone_env(env);
-            rv.ref.fun_v.function_pointer = function_body;
-            rv.ref.fun_v.arguments = identifier_vec;
+            rv.ref.fun_v = function_new(clone_env(env), function_body, identifier_vec);
 
             return rv;
-        } else if(seg_eq_str(id.ref.segment, "funcall")) {
+        } else if(BUILTIN_FUNCALL == builtin) {
+            lisp_check_num_args(children, 1, ~0UL);
             ApliNode node = vector_get(children, 1);
             ApliNode function_name = apli_node_get_child(apli_get_child(1), 1);
             if(!apli_node_terminal_name_equals(function_name, atomic_symbol))
-                assert(0 == "Function name must be an atomic_symbol");
+                lisp_error("Function name must be an atomic_symbol");
             return_value function_name_rv = apli_evaluate_node(function_name);
             return lisp_call(function_name_rv, node.children, env);
-        } else if(seg_eq_str(id.ref.segment, "terpri")) {
-            printf("\n"); // NOTE: Assume linux.
+        } else if(BUILTIN_TERPRI == builtin) {
+            lisp_output_char('\n'); // NOTE: Assume linux.
             return_value one;
             one.type = NUMBER;
             one.ref.num = 1;
             return one; 
-        } else if(seg_eq_str(id.ref.segment, "write")
-            || seg_eq_str(id.ref.segment, "write-string")
-            || seg_eq_str(id.ref.segment, "write-line")) {
+        } else if(BUILTIN_WRITE == builtin
+            || BUILTIN_WRITE_STRING == builtin
+            || BUILTIN_WRITE_LINE == builtin) {
+            lisp_check_num_args(children, 1, 1);
             ApliNode node = vector_get(children, 1);
             return_value rv = apli_evaluate_node(node);
             if(NUMBER == rv.type) {
-                printf("%d", rv.ref.num);
+                lisp_output_int(rv.ref.num);
                 return rv;
             } else if(STRING == rv.type) {
-                string_segment seg = rv.ref.segment;
-                for(size_t i = 0; i < seg.length; ++i) {
-                    if('\\' == seg.str[i] && i + 1 < seg.length) {
-                        switch(seg.str[i + 1]) {
-                        case 'n':
-                            printf("\n");
-                            i += 1;
-                            break;
-                        case 'r':
-                            printf("\r");
-                            i += 1;
-                            break;
-                        case 't':
-                            printf("\t");
-                            i += 1;
-                            break;
-                        default:
-                            printf("\\");
-                            break;
-                        }
-                        continue;
-                    }
-                    printf("%c", seg.str[i]);
-                }
-                if(seg_eq_str(id.ref.segment, "write-line"))
-                    printf("\n");
+                // Escape sequences were resolved when the literal was decoded.
+                string_segment seg = rv.ref.str->name;
+                lisp_output_write(seg.str, seg.length);
+                if(BUILTIN_WRITE_LINE == builtin)
+                    lisp_output_char('\n');
                 return rv;
             } else {
+                lisp_output_flush();
                 printf("Cannot print invalid type "); print_return_type(rv);
                 printf("\n");
-                exit(1);
+                lisp_fail();
             }
-        } else if(seg_eq_str(id.ref.segment, "progn")) {
+        } else if(BUILTIN_PROGN == builtin) {
             return_value one;
             one.type = NUMBER;
             one.ref.num = 1;
             if(1 == vector_size(children))
                 return one;
             return apli_evaluate_node(vector_get(children, 1));
-        } else if(seg_eq_str(id.ref.segment, "and")) {
+        } else if(BUILTIN_AND == builtin) {
             return_value rv;
             if(1 < vector_size(children)) {
                 rv.type = NUMBER;
@@ -675,7 +992,7 @@ return_value lisp_call(return_value id, Vector(_parse_tree_node_t) *children, en
             }
             rv.ref.num = 1;
             return rv;
-        } else if(seg_eq_str(id.ref.segment, "or")) {
+        } else if(BUILTIN_OR == builtin) {
             return_value rv;
             if(1 < vector_size(children)) {
                 rv.type = NUMBER;
@@ -694,38 +1011,43 @@ return_value lisp_call(return_value id, Vector(_parse_tree_node_t) *children, en
             rv.ref.num = 0;
             return rv;
         } else {
+            lisp_output_flush();
             printf("Invalid call! ");
             print_env(env);
             print_return_value(id);
-            exit(1);
+            lisp_fail();
         }
     } else if(FUNCTION == id.type) {
         // printf("Function call "); print_env(env); printf("\n");
-        environment *tmp_closure = id.ref.fun_v.closure;
+        // The callee stays rooted for the duration of the call: it may not be bound anywhere
+        // (ie. `((lambda (x) x) 1)`), and its closure holds the argument frame.
+        size_t arg_size = vector_size(id.ref.fun_v->arguments);
+        if(arg_size != lisp_num_args(children))
+            lisp_error("Invalid # of arguments given to function call.");
+        gc_push_root(id.ref.fun_v);
+        gc_safepoint();
+        environment *tmp_closure = id.ref.fun_v->closure;
         push_frame(tmp_closure);
         // print_env(tmp_closure);
-        size_t arg_size = vector_size(id.ref.fun_v.arguments);
         ApliNode node;
         if(1 < vector_size(children))
             node = vector_get(children, 1); // sexprs
         for(size_t i = 0; i < arg_size; ++i) {
-            extend_env(tmp_closure, vector_get(id.ref.fun_v.arguments, i), apli_evaluate_child(1));
+            extend_env(tmp_closure, vector_get(id.ref.fun_v->arguments, i), apli_evaluate_child(1));
             if(i == arg_size - 1)
                 break;
-            if(1 == apli_num_children())
-                assert(0 == "Invalid # of arguments given to function call.");
             node = apli_get_child(2);
         }
-        if(1 <= arg_size && 1 != apli_num_children())
-            assert(0 == "Invalid # of arguments given to function call.");
-        return_value rv = apli_evaluate_node_args(id.ref.fun_v.function_pointer, tmp_closure);
+        return_value rv = apli_evaluate_node_args(id.ref.fun_v->function_pointer, tmp_closure);
         pop_frame(tmp_closure);
+        gc_pop_root();
         return rv;
     }
 
+    lisp_output_flush();
     printf("Return value is not callable! ");
     print_return_value(id);
-    exit(1);
+    lisp_fail();
 }
 
 size_t return_value_is_truthy(return_value rv) {
@@ -741,7 +1063,7 @@ void map_bindings(ApliNode node, environment *env) {
     node = apli_get_child(1); // node : list
     // _parser_print_parse_tree_value(node.root);
     if(!apli_node_terminal_name_equals(node, list))
-        (assert(0 == "Bindings must be a list."));
+        lisp_error("Bindings must be a list.");
 
     if(3 != apli_num_children()) 
         return;
@@ -750,29 +1072,26 @@ void map_bindings(ApliNode node, environment *env) {
         ApliNode binding = apli_get_child(1);
         binding = apli_node_get_child(binding, 1);
         if(!apli_node_terminal_name_equals(binding, list))
-            (assert(0 == "Bindings must be a list."));
+            lisp_error("Bindings must be a list.");
         if(3 != vector_size(binding.children))
-            (assert(0 == "Bindings cannot be '()'"));
+            lisp_error("Bindings cannot be '()'");
         binding = apli_node_get_child(binding, 2);
+        if(vector_size(binding.children) < 2)
+            lisp_error("Binding has no value!");
 
         ApliNode atomic_symbol_id = apli_node_get_child(apli_node_get_child(binding, 1), 1);
         if(!apli_node_terminal_name_equals(atomic_symbol_id, atomic_symbol))
-            (assert(0 == "Binding name must be an atomic_symbol!"));
-
-        ApliToken tok = apli_node_get_child(atomic_symbol_id, 1).root.ptr.token;
-        string_segment segment = {apli_token_ref(tok), apli_token_reflen(tok)};
+            lisp_error("Binding name must be an atomic_symbol!");
 
         return_value var_name;
         var_name.type = IDENTIFIER;
-        var_name.ref.segment = segment;
+        var_name.ref.sym = atomic_symbol_identifier(atomic_symbol_id);
         return_value value = apli_evaluate_node_args(apli_node_get_child(binding, 2), env);
 
 
         if(IDENTIFIER != var_name.type)
-            (assert(0 == "Binding name is not an identifier!"));
-        string_segment var_segment = var_name.ref.segment;
-
-        extend_env(env, var_segment, value);
+            lisp_error("Binding name is not an identifier!");
+        extend_env(env, var_name.ref.sym, value);
         if(vector_size(node.children) < 2)
             break;
         node = apli_get_child(2);
@@ -786,7 +1105,7 @@ Vector(identifier) *construct_list_of_args(ApliNode node, environment *env) {
 
     // _parser_print_parse_tree_value(node.root);
     if(!apli_node_terminal_name_equals(node, list))
-        (assert(0 == "Bindings must be a list."));
+        lisp_error("Bindings must be a list.");
 
     if(3 != apli_num_children()) 
         return ids;
@@ -795,12 +1114,9 @@ Vector(identifier) *construct_list_of_args(ApliNode node, environment *env) {
     while(1 <= apli_num_children()) {
         ApliNode next_id = apli_node_get_child(apli_get_child(1), 1);
         if(!apli_node_terminal_name_equals(next_id, atomic_symbol))
-            (assert(0 == "Bindings must be a list."));
-
-        ApliToken tok = apli_node_get_child(next_id, 1).root.ptr.token;
-        string_segment segment = {apli_token_ref(tok), apli_token_reflen(tok)};
+            lisp_error("Bindings must be a list.");
 
-        vector_push_back(ids, segment);
+        vector_push_back(ids, atomic_symbol_identifier(next_id));
         if(1 == apli_num_children())
             break;
         node = apli_get_child(2);
@@ -829,13 +1145,73 @@ size_t _segment_eq_str(string_segment segment, const char *str) {
     return seg_eq(segment, _str_to_segment(str, strlen(str)));
 }
 
+// FNV-1a; frames mask the hash with the bucket count, so every bit has to be mixed.
+size_t symbol_name_hash(string_segment seg) {
+    size_t hash = 14695981039346656037UL;
+    for(size_t i = 0; i < seg.length; ++i) {
+        hash ^= (unsigned char) seg.str[i];
+        hash *= 1099511628211UL;
+    }
+    return hash;
+}
+
+void symbols_free() {
+    if(NULL == symbol_table)
+        return;
+    size_t buckets_size = vector_size(symbol_table->buckets);
+    for(size_t i = 0; i < buckets_size; ++i) {
+        _string_segment_identifier_map_match_list_t bucket = vector_get(symbol_table->buckets, i);
+        if(NULL == bucket)
+            continue;
+        Iterator(_string_segment_identifier_map_match_t) *iter = list_get_iterator(bucket);
+        while(NULL != iter) {
+            free(iter_val(iter).value);
+            iter = iter_next(iter);
+        }
+    }
+    map_free(symbol_table);
+    symbol_table = NULL;
+}
+
+symbol *_intern(string_segment seg) {
+    if(NULL == symbol_table) {
+        symbol_table = map_new(string_segment, identifier);
+        map_set_hash(symbol_table, &seg_hash);
+        map_set_key_eq(symbol_table, &seg_eq);
+    }
+    if(map_count(symbol_table, seg))
+        return map_at(symbol_table, seg);
+
+    // The symbol owns a copy of its name, it must outlive the source text.
+    symbol *sym = (symbol*) malloc(sizeof(symbol) + seg.length + 1);
+    char *name = (char*) (sym + 1);
+    memcpy(name, seg.str, seg.length);
+    name[seg.length] = '\0';
+    sym->name = str_to_seg(name, seg.length);
+    sym->hash = symbol_name_hash(seg);
+    sym->builtin = NOT_BUILTIN;
+    map_insert(symbol_table, sym->name, sym);
+    return sym;
+}
+
+void intern_builtins() {
+    const char *names[] = {"+", "*", "-", "/", "=", "<", ">", "<=", ">=", "let", "defun", "if",
+        "lambda", "funcall", "terpri", "write", "write-string", "write-line", "progn", "and", "or"};
+    const builtin_kind kinds[] = {BUILTIN_ADD, BUILTIN_MUL, BUILTIN_SUB, BUILTIN_DIV, BUILTIN_EQ,
+        BUILTIN_LT, BUILTIN_GT, BUILTIN_LE, BUILTIN_GE, BUILTIN_LET, BUILTIN_DEFUN, BUILTIN_IF,
+        BUILTIN_LAMBDA, BUILTIN_FUNCALL, BUILTIN_TERPRI, BUILTIN_WRITE, BUILTIN_WRITE_STRING,
+        BUILTIN_WRITE_LINE, BUILTIN_PROGN, BUILTIN_AND, BUILTIN_OR};
+    for(size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i)
+        intern(str_to_seg(names[i], strlen(names[i])))->builtin = kinds[i];
+}
+
 void print_return_value(return_value val) {
     if(NUMBER == val.type) {
         printf("NUMBER: %d", val.ref.num);
     }else if(IDENTIFIER == val.type) {
-        printf("IDENTIFIER: `%s`", seg_to_str(val.ref.segment));
+        printf("IDENTIFIER: `%s`", seg_to_str(val.ref.sym->name));
     } else if(FUNCTION == val.type) {
-        printf("FUNCTION <%p>", val.ref.fun_v.closure);
+        printf("FUNCTION <%p>", val.ref.fun_v->closure);
     }
 }
 
@@ -854,7 +1230,7 @@ void print_frame(frame f) {
     printf("{");
     while(list_size(lst)) {
         MapMatch(identifier, return_value) nxt = list_get_front(lst);
-        print_string_segment(nxt.key);
+        print_string_segment(nxt.key->name);
         printf(" ");
         print_return_value(nxt.value);
         if(1 != list_size(lst))
@@ -0,0 +1,107 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Buffered writer used by the `write` family and `terpri`.
+ *
+ * Output is appended to a user-space buffer and handed to stdio in bulk once the buffer
+ * holds `threshold` bytes, when `lisp_output_flush` is called, or at exit. Anything else
+ * that writes to stdout (ie. error messages) must call `lisp_output_flush` first so the
+ * output stays in program order.
+ *
+ * Configuration:
+ *   -DLISP_OUTPUT_BUFFER_SIZE=...  size of the buffer (and the default flush threshold).
+ *   `LISP_OUTPUT_FLUSH_THRESHOLD`  environment variable overriding the flush threshold,
+ *                                  ie. `1` flushes after every write.
+ */
+
+#ifndef LISP_OUTPUT_BUFFER_SIZE
+#define LISP_OUTPUT_BUFFER_SIZE (1UL << 16)
+#endif
+
+typedef struct _lisp_output {
+    char *buffer;
+    size_t size;
+    size_t threshold;
+    FILE *fp;
+} lisp_output;
+
+lisp_output _lisp_output = {NULL, 0, LISP_OUTPUT_BUFFER_SIZE, NULL};
+
+#define lisp_output_init()                  _lisp_output_init()
+#define lisp_output_flush()                 _lisp_output_flush()
+#define lisp_output_write(str, len)         _lisp_output_write(str, len)
+#define lisp_output_char(c)                 _lisp_output_char(c)
+#define lisp_output_int(num)                _lisp_output_int(num)
+#define lisp_output_set_threshold(bytes)    _lisp_output_set_threshold(bytes)
+#define lisp_output_set_stream(fp)          _lisp_output_set_stream(fp)
+
+void _lisp_output_flush();
+void _lisp_output_set_threshold(size_t bytes);
+
+void _lisp_output_init() {
+    if(NULL != _lisp_output.buffer)
+        return;
+    _lisp_output.buffer = (char*) malloc(LISP_OUTPUT_BUFFER_SIZE);
+    _lisp_output.fp = stdout;
+    const char *threshold = getenv("LISP_OUTPUT_FLUSH_THRESHOLD");
+    if(NULL != threshold && '\0' != threshold[0])
+        _lisp_output_set_threshold(strtoull(threshold, NULL, 10));
+    atexit(&_lisp_output_flush);
+}
+
+void _lisp_output_set_threshold(size_t bytes) {
+    if(0 == bytes || LISP_OUTPUT_BUFFER_SIZE < bytes)
+        bytes = LISP_OUTPUT_BUFFER_SIZE;
+    _lisp_output.threshold = bytes;
+}
+
+// Flushes pending output to the current stream before switching to `fp`.
+void _lisp_output_set_stream(FILE *fp) {
+    _lisp_output_flush();
+    _lisp_output.fp = fp;
+}
+
+void _lisp_output_flush() {
+    if(0 == _lisp_output.size)
+        return;
+    fwrite(_lisp_output.buffer, sizeof(char), _lisp_output.size, _lisp_output.fp);
+    fflush(_lisp_output.fp);
+    _lisp_output.size = 0;
+}
+
+void _lisp_output_write(const char *str, size_t len) {
+    if(NULL == _lisp_output.buffer)
+        _lisp_output_init();
+    // Runs that don't fit in the buffer are written straight through.
+    if(LISP_OUTPUT_BUFFER_SIZE - _lisp_output.size < len) {
+        _lisp_output_flush();
+        if(LISP_OUTPUT_BUFFER_SIZE <= len) {
+            fwrite(str, sizeof(char), len, _lisp_output.fp);
+            return;
+        }
+    }
+    memcpy(_lisp_output.buffer + _lisp_output.size, str, len);
+    _lisp_output.size += len;
+    if(_lisp_output.threshold <= _lisp_output.size)
+        _lisp_output_flush();
+}
+
+void _lisp_output_char(char c) {
+    _lisp_output_write(&c, 1);
+}
+
+void _lisp_output_int(int num) {
+    char digits[16];
+    size_t pos = sizeof(digits);
+    unsigned int magnitude = (num < 0) ? -(unsigned int) num : (unsigned int) num;
+    do {
+        digits[--pos] = '0' + (magnitude % 10);
+        magnitude /= 10;
+    } while(magnitude);
+    if(num < 0)
+        digits[--pos] = '-';
+    _lisp_output_write(digits + pos, sizeof(digits) - pos);
+}
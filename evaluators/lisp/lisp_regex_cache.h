@@ -1,4 +1,10 @@
-const char forward_comment[] = {
+// Serialized DFAs of the `lisp` token rules, written by `token_rules_write_cache`
+// (see tools/regex_cache_gen.c). Do not edit: regenerate it when a regex changes.
+
+#ifndef _lisp_REGEX_CACHE_
+#define _lisp_REGEX_CACHE_
+
+static const char _lisp_regex_cache_0_forward[] __attribute__((aligned(sizeof(size_t)))) = {
 '\x07', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x04', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
@@ -8,22 +14,14 @@ const char forward_comment[] = {
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x06', '\x05', '\x05', '\x05', '\x05', '\x05', 
-'\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', 
-'\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', 
-'\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', 
-'\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', 
-'\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', 
-'\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', 
-'\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', 
-'\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x06', '\x05', '\x05', '\x05', '\x05', '\x05', 
-'\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', 
-'\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', 
-'\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', 
-'\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', 
-'\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', 
-'\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', 
-'\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', 
+'\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x04', '\x07', '\x07', '\x07', '\x07', '\x07', 
+'\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', 
+'\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', 
+'\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', 
+'\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', 
+'\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', 
+'\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', 
+'\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
@@ -31,26 +29,27 @@ const char forward_comment[] = {
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF'
+'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
+'\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x04', '\x07', '\x07', '\x07', '\x07', '\x07', 
+'\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', 
+'\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', 
+'\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', 
+'\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', 
+'\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', 
+'\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', 
+'\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07', '\x07'
 };
-const char backward_comment[] = {
+
+static const char _lisp_regex_cache_0_backward[] __attribute__((aligned(sizeof(size_t)))) = {
 '\x07', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x04', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x04', '\x02', '\x02', '\x02', '\x02', '\x02', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x07', '\x02', '\x02', '\x02', '\x02', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x04', '\x02', '\x02', '\x02', '\x02', '\x02', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x07', '\x02', '\x02', '\x02', '\x02', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x02', '\x06', '\x06', '\x06', '\x06', '\x06', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x05', '\x06', '\x06', '\x06', '\x06', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
@@ -59,50 +58,62 @@ const char backward_comment[] = {
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x04', '\x02', '\x02', '\x02', '\x02', '\x02', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x07', '\x02', '\x02', '\x02', '\x02', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', 
-'\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02', '\x02'
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x02', '\x06', '\x06', '\x06', '\x06', '\x06', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x05', '\x06', '\x06', '\x06', '\x06', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x02', '\x06', '\x06', '\x06', '\x06', '\x06', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x05', '\x06', '\x06', '\x06', '\x06', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', 
+'\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06', '\x06'
 };
-const char forward_atomic_symbol[] = {
+
+static const char _lisp_regex_cache_1_forward[] __attribute__((aligned(sizeof(size_t)))) = {
 '\x07', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x0C', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\xFF', '\xFF', '\x0E', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x11', '\x11', '\x11', '\x05', '\x11', '\x11', 
-'\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x11', '\x11', '\x07', '\x11', '\x0B', '\x11', 
-'\x11', '\x11', '\x11', '\x11', '\x11', '\x11', '\x11', '\x11', '\x11', '\x11', '\x11', '\x11', '\x11', '\x11', '\x11', '\x11', 
-'\x11', '\x11', '\x11', '\x11', '\x11', '\x11', '\x11', '\x11', '\x11', '\x11', '\x11', '\x11', '\x05', '\xFF', '\xFF', '\xFF', 
-'\xFF', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', 
-'\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
+'\xFF', '\xFF', '\x02', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x0B', '\x0B', '\x0B', '\x05', '\x0B', '\x0B', 
+'\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x0B', '\x0B', '\x07', '\x0B', '\x09', '\x0B', 
+'\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', 
+'\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x05', '\xFF', '\xFF', '\xFF', 
+'\xFF', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', 
+'\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
+'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x12', '\x10', '\x10', '\x10', '\x10', '\x10', 
+'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
+'\x10', '\x10', '\x0F', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
+'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
+'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
+'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
+'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
+'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x03', '\xFF', '\xFF', 
-'\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x03', '\xFF', '\xFF', '\xFF', 
-'\xFF', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', 
-'\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
+'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x0D', '\xFF', '\xFF', 
+'\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
+'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x0D', '\xFF', '\xFF', '\xFF', 
+'\xFF', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', 
+'\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x03', '\xFF', '\xFF', 
-'\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x03', '\xFF', '\xFF', '\xFF', 
-'\xFF', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', 
-'\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
+'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x15', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x09', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
+'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x17', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
@@ -113,12 +124,32 @@ const char forward_atomic_symbol[] = {
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x0D', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
+'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x0D', '\xFF', '\xFF', 
+'\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
+'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x0D', '\xFF', '\xFF', '\xFF', 
+'\xFF', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', 
+'\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\x0D', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
+'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x12', '\x10', '\x10', '\x10', '\x10', '\x10', 
+'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
+'\x10', '\x10', '\x0F', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
+'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
+'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
+'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
+'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
+'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
+'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x12', '\x10', '\x10', '\x10', '\x10', '\x10', 
+'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
+'\x10', '\x10', '\x0F', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
+'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
+'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
+'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
+'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
+'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
@@ -126,14 +157,6 @@ const char forward_atomic_symbol[] = {
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x14', '\x12', '\x12', '\x12', '\x12', '\x12', 
-'\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', 
-'\x12', '\x12', '\x17', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', 
-'\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', 
-'\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', 
-'\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', 
-'\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', 
-'\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
@@ -142,14 +165,6 @@ const char forward_atomic_symbol[] = {
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x14', '\x12', '\x12', '\x12', '\x12', '\x12', 
-'\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', 
-'\x12', '\x12', '\x17', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', 
-'\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', 
-'\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', 
-'\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', 
-'\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', 
-'\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
@@ -158,45 +173,42 @@ const char forward_atomic_symbol[] = {
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x14', '\x12', '\x12', '\x12', '\x12', '\x12', 
-'\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', 
-'\x12', '\x12', '\x17', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', 
-'\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', 
-'\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', 
-'\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', 
-'\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', 
-'\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12', '\x12'
+'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF'
 };
-const char backward_atomic_symbol[] = {
+
+static const char _lisp_regex_cache_1_backward[] __attribute__((aligned(sizeof(size_t)))) = {
 '\x07', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x0B', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\xFF', '\xFF', '\x0C', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x0F', '\x0F', '\x0F', '\x05', '\x0F', '\x0F', 
-'\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x0F', '\x0F', '\x0F', '\x07', '\x0F', '\x0F', 
-'\x0F', '\x0F', '\x0F', '\x0F', '\x0F', '\x0F', '\x0F', '\x0F', '\x0F', '\x0F', '\x0F', '\x0F', '\x0F', '\x0F', '\x0F', '\x0F', 
-'\x0F', '\x0F', '\x0F', '\x0F', '\x0F', '\x0F', '\x0F', '\x0F', '\x0F', '\x0F', '\x0F', '\x0F', '\x05', '\xFF', '\xFF', '\xFF', 
-'\xFF', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', 
-'\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
+'\xFF', '\xFF', '\x02', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x09', '\x09', '\x09', '\x05', '\x09', '\x09', 
+'\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x05', '\x09', '\x09', '\x09', '\x07', '\x09', '\x09', 
+'\x09', '\x09', '\x09', '\x09', '\x09', '\x09', '\x09', '\x09', '\x09', '\x09', '\x09', '\x09', '\x09', '\x09', '\x09', '\x09', 
+'\x09', '\x09', '\x09', '\x09', '\x09', '\x09', '\x09', '\x09', '\x09', '\x09', '\x09', '\x09', '\x05', '\xFF', '\xFF', '\xFF', 
+'\xFF', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', 
+'\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
+'\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x10', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
+'\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
+'\x0E', '\x0E', '\x0D', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
+'\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
+'\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
+'\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
+'\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
+'\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x03', '\xFF', '\xFF', 
-'\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
+'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x0B', '\xFF', '\xFF', 
+'\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x03', '\xFF', '\xFF', '\xFF', 
-'\xFF', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', 
-'\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
+'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x0B', '\xFF', '\xFF', '\xFF', 
+'\xFF', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', 
+'\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x03', '\xFF', '\xFF', 
-'\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x03', '\xFF', '\xFF', '\xFF', 
-'\xFF', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', 
-'\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\x03', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
+'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x13', '\xFF', '\x15', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x09', '\xFF', '\x0B', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
@@ -208,7 +220,28 @@ const char backward_atomic_symbol[] = {
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
+'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x0B', '\xFF', '\xFF', 
+'\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
+'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\x0B', '\xFF', '\xFF', '\xFF', 
+'\xFF', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', 
+'\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\x0B', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
+'\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x10', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
+'\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
+'\x0E', '\x0E', '\x0D', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
+'\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
+'\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
+'\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
+'\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
+'\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
+'\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x10', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
+'\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
+'\x0E', '\x0E', '\x0D', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
+'\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
+'\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
+'\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
+'\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
+'\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', '\x0E', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
@@ -217,15 +250,6 @@ const char backward_atomic_symbol[] = {
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x12', '\x10', '\x10', '\x10', '\x10', '\x10', 
-'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
-'\x10', '\x10', '\x15', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
-'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
-'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
-'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
-'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
-'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
-'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
@@ -233,14 +257,6 @@ const char backward_atomic_symbol[] = {
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x12', '\x10', '\x10', '\x10', '\x10', '\x10', 
-'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
-'\x10', '\x10', '\x15', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
-'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
-'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
-'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
-'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
-'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
@@ -249,16 +265,10 @@ const char backward_atomic_symbol[] = {
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
-'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x12', '\x10', '\x10', '\x10', '\x10', '\x10', 
-'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
-'\x10', '\x10', '\x15', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
-'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
-'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
-'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
-'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', 
-'\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10', '\x10'
+'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF'
 };
-const char forward_op_paren[] = {
+
+static const char _lisp_regex_cache_2_forward[] __attribute__((aligned(sizeof(size_t)))) = {
 '\x07', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
@@ -277,7 +287,8 @@ const char forward_op_paren[] = {
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF'
 };
-const char backward_op_paren[] = {
+
+static const char _lisp_regex_cache_2_backward[] __attribute__((aligned(sizeof(size_t)))) = {
 '\x07', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
@@ -296,7 +307,8 @@ const char backward_op_paren[] = {
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF'
 };
-const char forward_close_paren[] = {
+
+static const char _lisp_regex_cache_3_forward[] __attribute__((aligned(sizeof(size_t)))) = {
 '\x07', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
@@ -315,7 +327,8 @@ const char forward_close_paren[] = {
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF'
 };
-const char backward_close_paren[] = {
+
+static const char _lisp_regex_cache_3_backward[] __attribute__((aligned(sizeof(size_t)))) = {
 '\x07', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
@@ -334,7 +347,8 @@ const char backward_close_paren[] = {
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF'
 };
-const char forward_period[] = {
+
+static const char _lisp_regex_cache_4_forward[] __attribute__((aligned(sizeof(size_t)))) = {
 '\x07', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
@@ -353,7 +367,8 @@ const char forward_period[] = {
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF'
 };
-const char backward_period[] = {
+
+static const char _lisp_regex_cache_4_backward[] __attribute__((aligned(sizeof(size_t)))) = {
 '\x07', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
@@ -371,4 +386,19 @@ const char backward_period[] = {
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 
 '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF', '\xFF'
-};
\ No newline at end of file
+};
+
+static const _regex_cache_entry_t lisp_regex_cache[] = {
+    {"COMMENT", ";[^\n]*", 0xDAD909B3BDF1190CUL,
+        _lisp_regex_cache_0_forward, _lisp_regex_cache_0_backward},
+    {"ATOMIC_SYMBOL", "(\"([^\n\"]|\\\")*\"|[a-z0-9\\-]+|(<=|>=|[+-\\*/<>=]))", 0x7B3C90134426C9E0UL,
+        _lisp_regex_cache_1_forward, _lisp_regex_cache_1_backward},
+    {"OPEN_PAREN", "\\(", 0x09501807B5DE2229UL,
+        _lisp_regex_cache_2_forward, _lisp_regex_cache_2_backward},
+    {"CLOSE_PAREN", "\\)", 0x09501707B5DE2076UL,
+        _lisp_regex_cache_3_forward, _lisp_regex_cache_3_backward},
+    {"PERIOD", "\\.", 0x09501A07B5DE258FUL,
+        _lisp_regex_cache_4_forward, _lisp_regex_cache_4_backward}
+};
+
+#endif
@@ -0,0 +1,877 @@
+// Direct-coded scanners of the `lisp` token rules, written by `token_rules_write_scanners`
+// (see tools/regex_cache_gen.c). Do not edit: regenerate it when a regex changes.
+
+#ifndef _lisp_REGEX_SCANNERS_
+#define _lisp_REGEX_SCANNERS_
+
+static size_t _lisp_regex_scanner_0_forward(const char *ptr, size_t ptr_sz) {
+    size_t offset = 0UL;
+    size_t max_right_bound = ~0UL;
+    apli_stat_inc(dfa_runs);
+s0:
+    if(ptr_sz < offset)
+        goto end;
+    if(~0UL != max_right_bound)
+        goto found;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x3B:
+            goto a1;
+        case 0x8A:
+            goto s2;
+        case 0x80 ... 0x89:
+        case 0x8B ... 0xFF:
+            goto a3;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a1:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x0A:
+            goto s2;
+        case 0x00 ... 0x09:
+        case 0x0B ... 0x7F:
+            goto a3;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+s2:
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x8A:
+            goto s2;
+        case 0x80 ... 0x89:
+        case 0x8B ... 0xFF:
+            goto a3;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a3:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x0A:
+            goto s2;
+        case 0x00 ... 0x09:
+        case 0x0B ... 0x7F:
+            goto a3;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+found:
+#ifdef APLI_STATS
+    switch((unsigned char) ptr[offset]) {
+        case 0x3B:
+        case 0x8A:
+        case 0x80 ... 0x89:
+        case 0x8B ... 0xFF:
+            break;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+    }
+#endif
+    offset += 1;
+end:
+    apli_stat_add(dfa_transitions, offset);
+    return max_right_bound;
+}
+
+static size_t _lisp_regex_scanner_0_backward(const char *ptr, size_t ptr_sz) {
+    size_t offset = 0UL;
+    size_t max_right_bound = ~0UL;
+    apli_stat_inc(dfa_runs);
+s0:
+    if(ptr_sz < offset)
+        goto end;
+    if(~0UL != max_right_bound)
+        goto found;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x0A:
+            goto s1;
+        case 0x3B:
+            goto a2;
+        case 0x00 ... 0x09:
+        case 0x0B ... 0x3A:
+        case 0x3C ... 0x7F:
+            goto s3;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+s1:
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x8A:
+            goto s1;
+        case 0xBB:
+            goto a2;
+        case 0x80 ... 0x89:
+        case 0x8B ... 0xBA:
+        case 0xBC ... 0xFF:
+            goto s3;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a2:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x0A:
+        case 0x8A:
+            goto s1;
+        case 0x3B:
+        case 0xBB:
+            goto a2;
+        case 0x00 ... 0x09:
+        case 0x0B ... 0x3A:
+        case 0x3C ... 0x89:
+        case 0x8B ... 0xBA:
+        case 0xBC ... 0xFF:
+            goto s3;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+s3:
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x0A:
+            goto s1;
+        case 0x3B:
+            goto a2;
+        case 0x00 ... 0x09:
+        case 0x0B ... 0x3A:
+        case 0x3C ... 0x7F:
+            goto s3;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+found:
+#ifdef APLI_STATS
+    switch((unsigned char) ptr[offset]) {
+        case 0x0A:
+        case 0x3B:
+        case 0x00 ... 0x09:
+        case 0x0B ... 0x3A:
+        case 0x3C ... 0x7F:
+            break;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+    }
+#endif
+    offset += 1;
+end:
+    apli_stat_add(dfa_transitions, offset);
+    return max_right_bound;
+}
+
+static size_t _lisp_regex_scanner_1_forward(const char *ptr, size_t ptr_sz) {
+    size_t offset = 0UL;
+    size_t max_right_bound = ~0UL;
+    apli_stat_inc(dfa_runs);
+s0:
+    if(ptr_sz < offset)
+        goto end;
+    if(~0UL != max_right_bound)
+        goto found;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x22:
+            goto s1;
+        case 0x2D:
+        case 0x30 ... 0x39:
+        case 0x5C:
+            goto a2;
+        case 0x3C:
+            goto a3;
+        case 0x3E:
+            goto a4;
+        case 0x2A ... 0x2C:
+        case 0x2E ... 0x2F:
+        case 0x3A ... 0x3B:
+        case 0x3D:
+        case 0x3F ... 0x5B:
+            goto a5;
+        case 0x61 ... 0x7A:
+            goto a6;
+        case 0xA2:
+            goto a7;
+        case 0x80 ... 0x89:
+        case 0x8B ... 0xA1:
+        case 0xA3 ... 0xFF:
+            goto s8;
+        case 0x8A:
+            goto s9;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+s1:
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        case 0xAD:
+        case 0xB0 ... 0xB9:
+        case 0xDC:
+        case 0xE1 ... 0xFA:
+            goto a6;
+        case 0x22:
+            goto a7;
+        case 0x00 ... 0x09:
+        case 0x0B ... 0x21:
+        case 0x23 ... 0x7F:
+            goto s8;
+        case 0x0A:
+            goto s9;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a2:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x2D:
+        case 0x30 ... 0x39:
+        case 0x5C:
+        case 0x61 ... 0x7A:
+            goto a6;
+        case 0xBD:
+            goto a10;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a3:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x3D:
+            goto a10;
+        case 0xBD:
+            goto a11;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a4:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x3D:
+            goto a11;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a5:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        case 0xAD:
+        case 0xB0 ... 0xB9:
+        case 0xDC:
+        case 0xE1 ... 0xFA:
+            goto a6;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a6:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x2D:
+        case 0x30 ... 0x39:
+        case 0x5C:
+        case 0x61 ... 0x7A:
+            goto a6;
+        case 0xA2:
+            goto a7;
+        case 0x80 ... 0x89:
+        case 0x8B ... 0xA1:
+        case 0xA3 ... 0xFF:
+            goto s8;
+        case 0x8A:
+            goto s9;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a7:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x22:
+        case 0xA2:
+            goto a7;
+        case 0x00 ... 0x09:
+        case 0x0B ... 0x21:
+        case 0x23 ... 0x89:
+        case 0x8B ... 0xA1:
+        case 0xA3 ... 0xFF:
+            goto s8;
+        case 0x0A:
+        case 0x8A:
+            goto s9;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+s8:
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x22:
+            goto a7;
+        case 0x00 ... 0x09:
+        case 0x0B ... 0x21:
+        case 0x23 ... 0x7F:
+            goto s8;
+        case 0x0A:
+            goto s9;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+s9:
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a10:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a11:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+found:
+#ifdef APLI_STATS
+    switch((unsigned char) ptr[offset]) {
+        case 0x22:
+        case 0x2D:
+        case 0x30 ... 0x39:
+        case 0x5C:
+        case 0x3C:
+        case 0x3E:
+        case 0x2A ... 0x2C:
+        case 0x2E ... 0x2F:
+        case 0x3A ... 0x3B:
+        case 0x3D:
+        case 0x3F ... 0x5B:
+        case 0x61 ... 0x7A:
+        case 0xA2:
+        case 0x80 ... 0x89:
+        case 0x8B ... 0xA1:
+        case 0xA3 ... 0xFF:
+        case 0x8A:
+            break;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+    }
+#endif
+    offset += 1;
+end:
+    apli_stat_add(dfa_transitions, offset);
+    return max_right_bound;
+}
+
+static size_t _lisp_regex_scanner_1_backward(const char *ptr, size_t ptr_sz) {
+    size_t offset = 0UL;
+    size_t max_right_bound = ~0UL;
+    apli_stat_inc(dfa_runs);
+s0:
+    if(ptr_sz < offset)
+        goto end;
+    if(~0UL != max_right_bound)
+        goto found;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x22:
+            goto s1;
+        case 0x2D:
+        case 0x30 ... 0x39:
+        case 0x5C:
+            goto a2;
+        case 0x3D:
+            goto a3;
+        case 0x2A ... 0x2C:
+        case 0x2E ... 0x2F:
+        case 0x3A ... 0x3C:
+        case 0x3E ... 0x5B:
+            goto a4;
+        case 0x61 ... 0x7A:
+            goto a5;
+        case 0xA2:
+            goto a6;
+        case 0x80 ... 0x89:
+        case 0x8B ... 0xA1:
+        case 0xA3 ... 0xFF:
+            goto s7;
+        case 0x8A:
+            goto s8;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+s1:
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        case 0xAD:
+        case 0xB0 ... 0xB9:
+        case 0xDC:
+        case 0xE1 ... 0xFA:
+            goto a5;
+        case 0x22:
+            goto a6;
+        case 0x00 ... 0x09:
+        case 0x0B ... 0x21:
+        case 0x23 ... 0x7F:
+            goto s7;
+        case 0x0A:
+            goto s8;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a2:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x2D:
+        case 0x30 ... 0x39:
+        case 0x5C:
+        case 0x61 ... 0x7A:
+            goto a5;
+        case 0xBC:
+            goto a9;
+        case 0xBE:
+            goto a10;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a3:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x3C:
+            goto a9;
+        case 0x3E:
+            goto a10;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a4:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        case 0xAD:
+        case 0xB0 ... 0xB9:
+        case 0xDC:
+        case 0xE1 ... 0xFA:
+            goto a5;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a5:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x2D:
+        case 0x30 ... 0x39:
+        case 0x5C:
+        case 0x61 ... 0x7A:
+            goto a5;
+        case 0xA2:
+            goto a6;
+        case 0x80 ... 0x89:
+        case 0x8B ... 0xA1:
+        case 0xA3 ... 0xFF:
+            goto s7;
+        case 0x8A:
+            goto s8;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a6:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x22:
+        case 0xA2:
+            goto a6;
+        case 0x00 ... 0x09:
+        case 0x0B ... 0x21:
+        case 0x23 ... 0x89:
+        case 0x8B ... 0xA1:
+        case 0xA3 ... 0xFF:
+            goto s7;
+        case 0x0A:
+        case 0x8A:
+            goto s8;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+s7:
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x22:
+            goto a6;
+        case 0x00 ... 0x09:
+        case 0x0B ... 0x21:
+        case 0x23 ... 0x7F:
+            goto s7;
+        case 0x0A:
+            goto s8;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+s8:
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a9:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a10:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+found:
+#ifdef APLI_STATS
+    switch((unsigned char) ptr[offset]) {
+        case 0x22:
+        case 0x2D:
+        case 0x30 ... 0x39:
+        case 0x5C:
+        case 0x3D:
+        case 0x2A ... 0x2C:
+        case 0x2E ... 0x2F:
+        case 0x3A ... 0x3C:
+        case 0x3E ... 0x5B:
+        case 0x61 ... 0x7A:
+        case 0xA2:
+        case 0x80 ... 0x89:
+        case 0x8B ... 0xA1:
+        case 0xA3 ... 0xFF:
+        case 0x8A:
+            break;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+    }
+#endif
+    offset += 1;
+end:
+    apli_stat_add(dfa_transitions, offset);
+    return max_right_bound;
+}
+
+static size_t _lisp_regex_scanner_2_forward(const char *ptr, size_t ptr_sz) {
+    size_t offset = 0UL;
+    size_t max_right_bound = ~0UL;
+    apli_stat_inc(dfa_runs);
+s0:
+    if(ptr_sz < offset)
+        goto end;
+    if(~0UL != max_right_bound)
+        goto found;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x28:
+            goto a1;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a1:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+found:
+#ifdef APLI_STATS
+    switch((unsigned char) ptr[offset]) {
+        case 0x28:
+            break;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+    }
+#endif
+    offset += 1;
+end:
+    apli_stat_add(dfa_transitions, offset);
+    return max_right_bound;
+}
+
+static size_t _lisp_regex_scanner_2_backward(const char *ptr, size_t ptr_sz) {
+    size_t offset = 0UL;
+    size_t max_right_bound = ~0UL;
+    apli_stat_inc(dfa_runs);
+s0:
+    if(ptr_sz < offset)
+        goto end;
+    if(~0UL != max_right_bound)
+        goto found;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x28:
+            goto a1;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a1:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+found:
+#ifdef APLI_STATS
+    switch((unsigned char) ptr[offset]) {
+        case 0x28:
+            break;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+    }
+#endif
+    offset += 1;
+end:
+    apli_stat_add(dfa_transitions, offset);
+    return max_right_bound;
+}
+
+static size_t _lisp_regex_scanner_3_forward(const char *ptr, size_t ptr_sz) {
+    size_t offset = 0UL;
+    size_t max_right_bound = ~0UL;
+    apli_stat_inc(dfa_runs);
+s0:
+    if(ptr_sz < offset)
+        goto end;
+    if(~0UL != max_right_bound)
+        goto found;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x29:
+            goto a1;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a1:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+found:
+#ifdef APLI_STATS
+    switch((unsigned char) ptr[offset]) {
+        case 0x29:
+            break;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+    }
+#endif
+    offset += 1;
+end:
+    apli_stat_add(dfa_transitions, offset);
+    return max_right_bound;
+}
+
+static size_t _lisp_regex_scanner_3_backward(const char *ptr, size_t ptr_sz) {
+    size_t offset = 0UL;
+    size_t max_right_bound = ~0UL;
+    apli_stat_inc(dfa_runs);
+s0:
+    if(ptr_sz < offset)
+        goto end;
+    if(~0UL != max_right_bound)
+        goto found;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x29:
+            goto a1;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a1:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+found:
+#ifdef APLI_STATS
+    switch((unsigned char) ptr[offset]) {
+        case 0x29:
+            break;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+    }
+#endif
+    offset += 1;
+end:
+    apli_stat_add(dfa_transitions, offset);
+    return max_right_bound;
+}
+
+static size_t _lisp_regex_scanner_4_forward(const char *ptr, size_t ptr_sz) {
+    size_t offset = 0UL;
+    size_t max_right_bound = ~0UL;
+    apli_stat_inc(dfa_runs);
+s0:
+    if(ptr_sz < offset)
+        goto end;
+    if(~0UL != max_right_bound)
+        goto found;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x2E:
+            goto a1;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a1:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+found:
+#ifdef APLI_STATS
+    switch((unsigned char) ptr[offset]) {
+        case 0x2E:
+            break;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+    }
+#endif
+    offset += 1;
+end:
+    apli_stat_add(dfa_transitions, offset);
+    return max_right_bound;
+}
+
+static size_t _lisp_regex_scanner_4_backward(const char *ptr, size_t ptr_sz) {
+    size_t offset = 0UL;
+    size_t max_right_bound = ~0UL;
+    apli_stat_inc(dfa_runs);
+s0:
+    if(ptr_sz < offset)
+        goto end;
+    if(~0UL != max_right_bound)
+        goto found;
+    switch((unsigned char) ptr[offset++]) {
+        case 0x2E:
+            goto a1;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+a1:
+    max_right_bound = offset;
+    if(ptr_sz < offset)
+        goto end;
+    switch((unsigned char) ptr[offset++]) {
+        default:
+            apli_stat_inc(dfa_begin_resets);
+            goto s0;
+    }
+found:
+#ifdef APLI_STATS
+    switch((unsigned char) ptr[offset]) {
+        case 0x2E:
+            break;
+        default:
+            apli_stat_inc(dfa_begin_resets);
+    }
+#endif
+    offset += 1;
+end:
+    apli_stat_add(dfa_transitions, offset);
+    return max_right_bound;
+}
+
+static const _regex_scanner_entry_t lisp_regex_scanners[] = {
+    {"COMMENT", 0xDAD909B3BDF1190CUL, _lisp_regex_scanner_0_forward, _lisp_regex_scanner_0_backward},
+    {"ATOMIC_SYMBOL", 0x7B3C90134426C9E0UL, _lisp_regex_scanner_1_forward, _lisp_regex_scanner_1_backward},
+    {"OPEN_PAREN", 0x09501807B5DE2229UL, _lisp_regex_scanner_2_forward, _lisp_regex_scanner_2_backward},
+    {"CLOSE_PAREN", 0x09501707B5DE2076UL, _lisp_regex_scanner_3_forward, _lisp_regex_scanner_3_backward},
+    {"PERIOD", 0x09501A07B5DE258FUL, _lisp_regex_scanner_4_forward, _lisp_regex_scanner_4_backward}
+};
+
+#endif
@@ -0,0 +1,176 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/**
+ * Server mode: one process builds the grammar, the token rules (and their DFAs) and the
+ * parser tables once, then evaluates many scripts.
+ *
+ *   ./a.out --server           requests on stdin, responses on stdout
+ *   ./a.out --socket <path>    listens on a Unix socket (one client at a time)
+ *
+ * Request:  "<length>\n" followed by <length> bytes of lisp source.
+ * Response: "<status> <length>\n" followed by <length> bytes of output. The status is 0 when
+ *           the script ran to completion and 1 when it did not parse or stopped on an error
+ *           (the error message is part of the output, as it would be on stdout).
+ *
+ * Every request gets a fresh environment, symbol table and GC heap, and with ARENA_ALLOCATOR
+ * the arena is reset to where it was before the request. Errors in a script (a wrong argument
+ * or number of arguments, a malformed binding, ...) go through `lisp_fail`, so they only fail
+ * their own request.
+ *
+ * Scripts longer than LISP_SERVER_MAX_REQUEST bytes (-DLISP_SERVER_MAX_REQUEST=...), or that
+ * cannot be allocated, are skipped and answered with status 1 and an error message.
+ */
+
+#ifndef LISP_SERVER_MAX_REQUEST
+#define LISP_SERVER_MAX_REQUEST (1UL << 26)
+#endif
+
+enum {LISP_SERVER_END, LISP_SERVER_REQUEST, LISP_SERVER_REJECTED};
+
+void lisp_server_reply_error(FILE *out, const char *message) {
+    fprintf(out, "1 %zu\n%s", strlen(message), message);
+    fflush(out);
+}
+
+// Reads past the `length` bytes of a rejected script. Returns 0 if the input ends first.
+int lisp_server_skip(FILE *in, size_t length) {
+    char buff[4096];
+    while(0 < length) {
+        size_t chunk = (length < sizeof(buff)) ? length : sizeof(buff);
+        if(chunk != fread(buff, sizeof(char), chunk, in))
+            return 0;
+        length -= chunk;
+    }
+    return 1;
+}
+
+// Returns LISP_SERVER_REQUEST with the script in `*script`, LISP_SERVER_REJECTED if the
+// request was answered with an error instead, or LISP_SERVER_END.
+int lisp_server_read_request(FILE *in, FILE *out, char **script) {
+    size_t length;
+    if(1 != fscanf(in, "%zu", &length) || '\n' != fgetc(in))
+        return LISP_SERVER_END;
+    char *buff = (LISP_SERVER_MAX_REQUEST < length) ? NULL : (char*) malloc(length + 1);
+    if(NULL == buff) {
+        lisp_server_reply_error(out, (LISP_SERVER_MAX_REQUEST < length)
+            ? "Request too large!\n" : "Out of memory for the request!\n");
+        return lisp_server_skip(in, length) ? LISP_SERVER_REJECTED : LISP_SERVER_END;
+    }
+    if(length != fread(buff, sizeof(char), length, in)) {
+        free(buff);
+        return LISP_SERVER_END;
+    }
+    buff[length] = '\0';
+    *script = buff;
+    return LISP_SERVER_REQUEST;
+}
+
+void lisp_server_handle_request(const char *script, FILE *out) {
+    // Error messages are printed with printf, so stdout itself is redirected into the
+    // response for the duration of the request.
+    char *output = NULL;
+    size_t output_length = 0;
+    FILE *capture = open_memstream(&output, &output_length);
+    FILE *real_stdout = stdout;
+    stdout = capture;
+    lisp_output_set_stream(capture);
+
+    jmp_buf error_jmp;
+    volatile int status = 0;
+    size_t tag_depth = apli_alloc_tag_depth();
+    lisp_error_jmp = &error_jmp;
+    if(0 == setjmp(error_jmp))
+        lisp_run_script(script);
+    else
+        status = 1;
+    lisp_error_jmp = NULL;
+    apli_alloc_set_tag_depth(tag_depth);
+    apli_trace_reset_eval();
+
+    lisp_output_set_stream(real_stdout);
+    stdout = real_stdout;
+    fclose(capture);
+
+    fprintf(out, "%d %zu\n", status, output_length);
+    fwrite(output, sizeof(char), output_length, out);
+    fflush(out);
+    // `output` comes from libc (open_memstream), not from the arena.
+    (free)(output);
+
+    lisp_release_script();
+}
+
+void lisp_server_serve(FILE *in, FILE *out) {
+    char *script;
+    while(1) {
+#ifdef ARENA_ALLOCATOR
+        size_t mark = _arena_mark();
+#endif
+        int request = lisp_server_read_request(in, out, &script);
+        if(LISP_SERVER_END == request)
+            break;
+        if(LISP_SERVER_REQUEST == request) {
+            lisp_server_handle_request(script, out);
+            free(script);
+        }
+#ifdef ARENA_ALLOCATOR
+        _arena_reset(mark);
+#endif
+    }
+}
+
+int lisp_server_listen(const char *path) {
+    struct sockaddr_un addr;
+    if(sizeof(addr.sun_path) <= strlen(path)) {
+        fprintf(stderr, "Socket path is too long: %s\n", path);
+        return 1;
+    }
+    int server_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(server_fd < 0) {
+        perror("socket");
+        return 1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    unlink(path);
+    if(bind(server_fd, (struct sockaddr*) &addr, sizeof(addr)) < 0 || listen(server_fd, 16) < 0) {
+        perror("bind/listen");
+        close(server_fd);
+        return 1;
+    }
+    while(1) {
+        int client_fd = accept(server_fd, NULL, NULL);
+        if(client_fd < 0) {
+            perror("accept");
+            continue;
+        }
+        FILE *in = fdopen(client_fd, "r");
+        FILE *out = fdopen(dup(client_fd), "w");
+        lisp_server_serve(in, out);
+        fclose(in);
+        fclose(out);
+    }
+    close(server_fd);
+    return 0;
+}
+
+int lisp_server_main(int argc, char **argv) {
+    parser_set_error_handler(&lisp_parse_fail);
+    if(0 == strcmp("--socket", argv[1])) {
+        if(3 != argc) {
+            printf("A socket path was not provided.\n");
+            exit(1);
+        }
+        return lisp_server_listen(argv[2]);
+    }
+    lisp_server_serve(stdin, stdout);
+    return 0;
+}
@@ -3,6 +3,7 @@
 
 
 #include "parser/parser.h"
+#include "context.h"
 #include "util/macro_magic.h"
 
 // #undef _size_t_set_t
@@ -53,8 +54,9 @@
 #define STRINGIFY(str)          DEFER3(_STRINGIFY)(str)
 #define THIRD(a,b,c,...) c
 #define FORTH(a,b,c,d,...) d
+// `<name>_index` is only read by `apli_regex_load`, which DFA caches have replaced.
 #define apli_define_regex_internal(expr) \
-    size_t DEFER3(CAT)( DEFER2(FIRST) expr , _index) = regex_index_counter++; \
+    size_t DEFER3(CAT)( DEFER2(FIRST) expr , _index) __attribute__((unused)) = regex_index_counter++; \
     DEFER2(IF_ELSE) (DEFER1(HAS_ARGS) DEFER1(_REST) DEFER1(_REST) expr) ( \
         token_rules_add_rule_offset(token_rules, STRINGIFY(DEFER3(FIRST) expr), DEFER3(THIRD) expr, DEFER3(FORTH) expr, DEFER3(SECOND) expr), \
         token_rules_add_rule(token_rules, STRINGIFY(DEFER3(FIRST) expr), DEFER3(SECOND) expr) \
@@ -66,6 +68,11 @@
 #define apli_regex(...)             MAP(apli_define_regex_internal, SEMI_COLON, __VA_ARGS__)
 
 #define apli_regex_compile()        token_rules_compile(token_rules)
+// Consumes the matches of the named rules without making tokens of them (see `token_rules_skip`).
+#define apli_regex_skip_internal(name)  token_rules_skip(token_rules, #name)
+#define apli_regex_skip(...)        MAP(apli_regex_skip_internal, SEMI_COLON, __VA_ARGS__)
+// Names the tokens of `rule` whose text is `word` `name` (see `token_rules_add_keyword`).
+#define apli_keyword(name, word, rule)  token_rules_add_keyword(token_rules, #name, (word), #rule)
 
 #define apli_regex_load_internal(expr) \
     DEFER5(regex_load) ( \
@@ -75,6 +82,10 @@
     )
 
 #define apli_regex_load(...)        MAP(apli_regex_load_internal, SEMI_COLON, __VA_ARGS__)
+// Loads the DFAs of a cache generated by tools/regex_cache_gen.c (see `token_rules_load_cache`).
+#define apli_regex_load_cache(cache)    token_rules_load_cache(token_rules, (cache))
+// Runs the direct-coded scanners generated by tools/regex_cache_gen.c (see `token_rules_load_scanners`).
+#define apli_regex_load_scanners(scanners)  token_rules_load_scanners(token_rules, (scanners))
 
 #define __APLI_START__ \
     int main(int argc, char **argv) { \
@@ -123,25 +134,49 @@ typedef const char* apli_function_name;
     (parse_tree_result = apli_get_parse_tree((input), parser_type_inst), \
      apli_evaluate_node(parse_tree_result.root))
 
-#define apli_evaluate_node(node) \
-    map_at(eval_fns, \
-        node.root.is_terminal_t \
+#define apli_node_name(node) \
+    (node.root.is_terminal_t \
         ? (assert(node.root.ptr.terminal.name[node.root.ptr.terminal.name_length] == '\0'), node.root.ptr.terminal.name) \
-        : node.root.ptr.token.name)((node) APLI_EVAL_NAMES_INTERNAL())
+        : node.root.ptr.token.name)
+
+#define _apli_evaluate_node(node) \
+    map_at(eval_fns, apli_stat_dispatch(apli_node_name(node)))((node) APLI_EVAL_NAMES_INTERNAL())
+
+// With APLI_TRACE, evaluations are wrapped in trace events (see util/trace.h). This uses a
+// GNU statement expression and requires a non-void APLI_EVAL_RETURN_TYPE.
+#ifdef APLI_TRACE
+#define apli_evaluate_node(node) \
+    ({ \
+        APLI_EVAL_RETURN_TYPE _apli_trace_result; \
+        if(__builtin_expect(!apli_trace_enabled(), 1)) { \
+            _apli_trace_result = _apli_evaluate_node(node); \
+        } else { \
+            const char *_apli_trace_name = apli_node_name(node), *_apli_trace_parent; \
+            int _apli_traced = _apli_trace_eval_begin(_apli_trace_name, &_apli_trace_parent); \
+            _apli_trace_result = _apli_evaluate_node(node); \
+            _apli_trace_eval_end(_apli_traced, _apli_trace_name, _apli_trace_parent); \
+        } \
+        _apli_trace_result; \
+    })
+#else
+#define apli_evaluate_node(node)    _apli_evaluate_node(node)
+#endif
 
 #define apli_evaluate_args(input, ...) \
     (parse_tree_result = apli_get_parse_tree((input), parser_type_inst), \
      apli_evaluate_node_args(parse_tree_result.root, __VA_ARGS__))
 
 #define apli_evaluate_node_args(node, ...) \
-    map_at(eval_fns, \
-        node.root.is_terminal_t \
-        ? (assert(node.root.ptr.terminal.name[node.root.ptr.terminal.name_length] == '\0'), node.root.ptr.terminal.name) \
-        : node.root.ptr.token.name)((node), __VA_ARGS__)
+    map_at(eval_fns, apli_stat_dispatch(apli_node_name(node)))((node), __VA_ARGS__)
 
 #define apli_get_parse_tree(input, parser_type) \
     bnf_rules_construct_parse_tree(bnf_rules, token_rules_tokenize(token_rules, (input)), (parser_type))
 
+// Freezes the rules defined so far into an `ApliContext` (see context.h), ie. to parse many
+// inputs at once with `apli_context_parse_batch`.
+#define apli_context_from_rules() \
+    apli_context_new(bnf_rules, token_rules, parser_type_inst)
+
 #define apli_num_children() vector_size(node.children)
 #define apli_get_children() (node.children)
 #define apli_node_get_child(node, child_number) vector_get(node.children, ((child_number) - 1))
@@ -149,6 +184,14 @@ typedef const char* apli_function_name;
 #define apli_get_child_token(child_number) apli_get_child(child_number).root.ptr.token
 #define apli_get_child_terminal(child_number) apli_get_child(child_number).root.ptr.terminal
 #define apli_evaluate_child(child_number) apli_evaluate_node(apli_get_child(child_number))
+#define apli_node_annotation(node) ((node).annotation)
+#define apli_annotation() apli_node_annotation(node)
+#define apli_node_annotate_child(node, child_number, value) \
+    do { \
+        _parse_tree_node_t _apli_annotated_child = apli_node_get_child(node, child_number); \
+        _apli_annotated_child.annotation = (value); \
+        vector_set((node).children, ((child_number) - 1), _apli_annotated_child); \
+    } while(0)
 #define apli_eval_child(child_number)   apli_evaluate_child(child_number)
 #define apli_child_token_name_equals(token_id, child_number) \
     (0 == apli_get_child(child_number).root.is_terminal_t && 0 == strcmp(#token_id, apli_get_child_token(child_number).name))
@@ -0,0 +1,94 @@
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include "parser/parser.h"
+#include "util/thread_pool.h"
+
+/**
+ * A compiled language: token rules, BNF rules and a parser type that are compiled once and
+ * then only read, so that one context can parse any number of inputs on any number of
+ * threads at the same time.
+ *
+ * `apli_context_new` compiles the token rules' regexes and builds the parser tables (the
+ * terminal tree, the look-ahead and the rule order) up front; parsing never modifies them.
+ * Everything a parse writes to (the token list, the parse stack, the look-ahead list and the
+ * tree) is owned by that parse. The rules must not be changed (ie. by adding a rule) or freed
+ * while the context is in use.
+ *
+ * Tokens to leave out of the parse (ie. comments) are marked with `token_rules_skip` before
+ * the context is made.
+ *
+ * `apli_context_parse_batch` parses `n` inputs as tasks on the default thread pool (see
+ * util/thread_pool.h) and stores their trees in order. A syntax error in any input ends the
+ * process as in `bnf_rules_construct_parse_tree`; the parser's error handler then runs on a
+ * worker thread, so it must not longjmp.
+ *
+ * ----- Usage -----
+ *   ApliContext *ctx = apli_context_new(bnf_rules, token_rules, type);
+ *     - apli_context_parse(ctx, input)             -> _parse_tree_t
+ *     - apli_context_parse_batch(ctx, inputs, n, trees: _parse_tree_t*)   -> void
+ *     - apli_context_free(ctx)                     -> void (the rules are not freed)
+ */
+
+#define ApliContext                                         _apli_context_t
+#define apli_context_new(bnf_rules, token_rules, type)      (_apli_context_new((bnf_rules), (token_rules), (type)))
+#define apli_context_parse(ctx, input)                      (_apli_context_parse((ctx), (input)))
+#define apli_context_parse_batch(ctx, inputs, n, trees)     (_apli_context_parse_batch((ctx), (inputs), (n), (trees)))
+#define apli_context_free(ctx)                              (free((ctx)))
+
+struct _apli_context_ {
+    _bnf_rules_t *bnf_rules;
+    TokenRules *token_rules;
+    parser_type type;
+};
+typedef struct _apli_context_ _apli_context_t;
+
+_apli_context_t *_apli_context_new(_bnf_rules_t *bnf_rules, TokenRules *token_rules, parser_type type) {
+    token_rules_compile(token_rules);
+    apli_alloc_push_tag(APLI_ALLOC_PARSER);
+    bnf_rules_prepare(bnf_rules, type);
+    apli_alloc_pop_tag();
+    _apli_context_t *ctx = (_apli_context_t*) malloc(sizeof(_apli_context_t));
+    ctx->bnf_rules = bnf_rules;
+    ctx->token_rules = token_rules;
+    ctx->type = type;
+    return ctx;
+}
+
+_parse_tree_t _apli_context_parse(const _apli_context_t *ctx, const char *input) {
+    List(_token_t) *tokens = token_rules_tokenize(ctx->token_rules, input);
+    _parse_tree_t parse_tree = bnf_rules_construct_parse_tree(ctx->bnf_rules, tokens, ctx->type);
+    list_free(tokens);
+    return parse_tree;
+}
+
+typedef struct _apli_context_parse_task_ {
+    const _apli_context_t *ctx;
+    const char *input;
+    _parse_tree_t *tree;
+} _apli_context_parse_task_t;
+
+static void _apli_context_parse_task(void *arg) {
+    _apli_context_parse_task_t *task = (_apli_context_parse_task_t*) arg;
+    apli_trace_begin("parser", "parse_batch_input");
+    *task->tree = _apli_context_parse(task->ctx, task->input);
+    apli_trace_end("parser", "parse_batch_input");
+}
+
+void _apli_context_parse_batch(const _apli_context_t *ctx, const char **inputs, size_t n, _parse_tree_t *trees) {
+    apli_trace_begin("parser", "parse_batch");
+    ThreadPool *pool = thread_pool_default();
+    TaskGroup group = task_group_init();
+    _apli_context_parse_task_t *tasks = (_apli_context_parse_task_t*) malloc(sizeof(_apli_context_parse_task_t) * n);
+    for(size_t i = 0; i < n; ++i) {
+        tasks[i].ctx = ctx;
+        tasks[i].input = inputs[i];
+        tasks[i].tree = &trees[i];
+        thread_pool_submit(pool, &group, &_apli_context_parse_task, &tasks[i]);
+    }
+    thread_pool_wait(pool, &group);
+    free(tasks);
+    apli_trace_end("parser", "parse_batch");
+}
+
+#endif
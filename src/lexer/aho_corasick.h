@@ -0,0 +1,188 @@
+#ifndef AHO_CORASICK_H
+#define AHO_CORASICK_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * An Aho-Corasick automaton finds the occurrences of many literal strings in one pass over an
+ * input, instead of one regex search per literal.
+ *
+ * The literals are the paths of a trie over bytes; every trie node is a state whose failure
+ * link is the longest proper suffix of its path that is also a trie node. Adding a literal only
+ * extends the trie: `aho_corasick_build` completes the transitions with the failure links once
+ * all the literals are added (it must be called again after adding more), so scanning a
+ * character is one table lookup. `aho_corasick_find_all` reports, for every literal, its leftmost
+ * non-overlapping occurrences: the matches that `regex_find_all` finds with the literal as a
+ * regex. The automaton is only read while scanning, so one automaton can scan any number of
+ * inputs at the same time.
+ *
+ * ----- Usage -----
+ *   AhoCorasick *ac = aho_corasick_new();
+ *     - aho_corasick_add(ac, literal, length)              -> size_t ( the literal's id: 0, 1, ... )
+ *     - aho_corasick_size(ac)                              -> size_t ( # of literals )
+ *     - aho_corasick_build(ac)                             -> void ( does nothing if nothing was added )
+ *     - aho_corasick_find_all(ac, input, size, matches)    -> void
+ *             (matches: List(_regex_match_t)*[# of literals], the occurrences of literal `id` are
+ *              appended to `matches[id]`)
+ *     - aho_corasick_free(ac)                              -> void
+ */
+
+#define AhoCorasick                                         _aho_corasick_t
+#define aho_corasick_new()                                  (_aho_corasick_new())
+#define aho_corasick_add(ac, literal, length)               (_aho_corasick_add((ac), (literal), (length)))
+#define aho_corasick_size(ac)                               ((ac)->num_literals)
+#define aho_corasick_build(ac)                              (_aho_corasick_build((ac)))
+#define aho_corasick_find_all(ac, input, size, matches)     (_aho_corasick_find_all((ac), (input), (size), (matches)))
+#define aho_corasick_free(ac)                               (_aho_corasick_free((ac)))
+
+#define AHO_CORASICK_ALPHABET_SIZE 256
+#define _AHO_CORASICK_NONE UINT32_MAX
+
+struct _aho_corasick_ {
+    size_t num_states;
+    size_t state_capacity;
+    uint32_t *trie;             // [state * 256 + c]: the child of `state` on `c` (0: none, as the root is no child)
+    uint32_t *delta;            // [state * 256 + c]: the trie completed with the failure links
+    uint32_t *ends;             // the first literal whose path ends at the state (or _AHO_CORASICK_NONE)
+    uint32_t *output_begin;     // the literals that end at the state or at one of its suffixes are
+    uint32_t *outputs;          // outputs[output_begin[state] .. output_begin[state + 1])
+    size_t num_literals;
+    size_t *lengths;            // the length of every literal
+    uint32_t *next_same;        // the next literal with the same path (or _AHO_CORASICK_NONE)
+    size_t dirty;               // whether literals were added since `delta` was built
+};
+typedef struct _aho_corasick_ _aho_corasick_t;
+
+_aho_corasick_t* _aho_corasick_new() {
+    _aho_corasick_t *ac = (_aho_corasick_t*) calloc(1, sizeof(_aho_corasick_t));
+    ac->state_capacity = 16;
+    ac->num_states = 1;
+    ac->trie = (uint32_t*) calloc(ac->state_capacity * AHO_CORASICK_ALPHABET_SIZE, sizeof(uint32_t));
+    ac->ends = (uint32_t*) malloc(sizeof(uint32_t) * ac->state_capacity);
+    ac->ends[0] = _AHO_CORASICK_NONE;
+    ac->dirty = 1;
+    return ac;
+}
+
+/* Completes the trie into `delta` and collects the outputs of every state, breadth-first. */
+void _aho_corasick_build(_aho_corasick_t *ac) {
+    if(!ac->dirty)
+        return;
+    ac->dirty = 0;
+    size_t n = ac->num_states;
+    free(ac->delta);
+    free(ac->output_begin);
+    free(ac->outputs);
+    ac->delta = (uint32_t*) malloc(sizeof(uint32_t) * n * AHO_CORASICK_ALPHABET_SIZE);
+    uint32_t *fail = (uint32_t*) calloc(n, sizeof(uint32_t));
+    uint32_t *order = (uint32_t*) malloc(sizeof(uint32_t) * n);
+    size_t head = 0, tail = 0;
+    for(size_t c = 0; c < AHO_CORASICK_ALPHABET_SIZE; ++c) {
+        uint32_t child = ac->trie[c];
+        ac->delta[c] = child;
+        if(0 != child)
+            order[tail++] = child;
+    }
+    while(head < tail) {
+        uint32_t state = order[head++];
+        for(size_t c = 0; c < AHO_CORASICK_ALPHABET_SIZE; ++c) {
+            uint32_t child = ac->trie[state * AHO_CORASICK_ALPHABET_SIZE + c];
+            uint32_t fallback = ac->delta[fail[state] * AHO_CORASICK_ALPHABET_SIZE + c];
+            if(0 == child) {
+                ac->delta[state * AHO_CORASICK_ALPHABET_SIZE + c] = fallback;
+            } else {
+                ac->delta[state * AHO_CORASICK_ALPHABET_SIZE + c] = child;
+                fail[child] = fallback;
+                order[tail++] = child;
+            }
+        }
+    }
+    // A state's failure link is found before the state, so its outputs are complete by then.
+    size_t num_outputs = 0;
+    uint32_t *counts = (uint32_t*) calloc(n, sizeof(uint32_t));
+    for(size_t k = 0; k < tail; ++k) {
+        uint32_t state = order[k];
+        for(uint32_t literal = ac->ends[state]; _AHO_CORASICK_NONE != literal; literal = ac->next_same[literal])
+            ++counts[state];
+        counts[state] += counts[fail[state]];
+        num_outputs += counts[state];
+    }
+    ac->output_begin = (uint32_t*) malloc(sizeof(uint32_t) * (n + 1));
+    ac->outputs = (uint32_t*) malloc(sizeof(uint32_t) * (num_outputs ? num_outputs : 1));
+    ac->output_begin[0] = 0;
+    for(size_t state = 0; state < n; ++state)
+        ac->output_begin[state + 1] = ac->output_begin[state] + counts[state];
+    for(size_t k = 0; k < tail; ++k) {
+        uint32_t state = order[k], out = ac->output_begin[state];
+        for(uint32_t literal = ac->ends[state]; _AHO_CORASICK_NONE != literal; literal = ac->next_same[literal])
+            ac->outputs[out++] = literal;
+        for(uint32_t i = ac->output_begin[fail[state]]; i < ac->output_begin[fail[state] + 1]; ++i)
+            ac->outputs[out++] = ac->outputs[i];
+    }
+    free(counts);
+    free(order);
+    free(fail);
+}
+
+size_t _aho_corasick_add(_aho_corasick_t *ac, const char *literal, size_t length) {
+    assert(0 < length);
+    uint32_t state = 0;
+    for(size_t i = 0; i < length; ++i) {
+        size_t index = state * AHO_CORASICK_ALPHABET_SIZE + (unsigned char) literal[i];
+        if(0 == ac->trie[index]) {
+            if(ac->num_states == ac->state_capacity) {
+                ac->state_capacity *= 2;
+                ac->trie = (uint32_t*) realloc(ac->trie, sizeof(uint32_t) * ac->state_capacity * AHO_CORASICK_ALPHABET_SIZE);
+                memset(ac->trie + ac->num_states * AHO_CORASICK_ALPHABET_SIZE, 0,
+                    sizeof(uint32_t) * (ac->state_capacity - ac->num_states) * AHO_CORASICK_ALPHABET_SIZE);
+                ac->ends = (uint32_t*) realloc(ac->ends, sizeof(uint32_t) * ac->state_capacity);
+            }
+            ac->ends[ac->num_states] = _AHO_CORASICK_NONE;
+            ac->trie[index] = (uint32_t) ac->num_states++;
+        }
+        state = ac->trie[index];
+    }
+    size_t id = ac->num_literals++;
+    ac->lengths = (size_t*) realloc(ac->lengths, sizeof(size_t) * ac->num_literals);
+    ac->next_same = (uint32_t*) realloc(ac->next_same, sizeof(uint32_t) * ac->num_literals);
+    ac->lengths[id] = length;
+    ac->next_same[id] = ac->ends[state];
+    ac->ends[state] = (uint32_t) id;
+    ac->dirty = 1;
+    return id;
+}
+
+void _aho_corasick_find_all(const _aho_corasick_t *ac, const char *input, size_t size, List(_regex_match_t) **matches) {
+    assert(!ac->dirty && "aho_corasick_build must be called after adding literals.");
+    // An occurrence of a literal is kept if it starts at or after the end of its last one.
+    size_t *free_from = (size_t*) calloc(ac->num_literals ? ac->num_literals : 1, sizeof(size_t));
+    uint32_t state = 0;
+    for(size_t i = 0; i < size; ++i) {
+        state = ac->delta[state * AHO_CORASICK_ALPHABET_SIZE + (unsigned char) input[i]];
+        for(uint32_t k = ac->output_begin[state]; k < ac->output_begin[state + 1]; ++k) {
+            uint32_t literal = ac->outputs[k];
+            size_t begin = i + 1 - ac->lengths[literal];
+            if(begin < free_from[literal])
+                continue;
+            _regex_match_t match = {begin, ac->lengths[literal]};
+            list_push_back(matches[literal], match);
+            free_from[literal] = i + 1;
+        }
+    }
+    free(free_from);
+}
+
+void _aho_corasick_free(_aho_corasick_t *ac) {
+    free(ac->trie);
+    free(ac->delta);
+    free(ac->ends);
+    free(ac->output_begin);
+    free(ac->outputs);
+    free(ac->lengths);
+    free(ac->next_same);
+    free(ac);
+}
+
+#endif
@@ -1,7 +1,9 @@
 #include <assert.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include "dfa.h"
 #include "../util/list.h"
+#include "../util/stats.h"
 
 #ifndef SIZE_T_LIST
     #define SIZE_T_LIST
@@ -23,6 +25,7 @@ define_dfa(size_t, char);
 #define flat_dfa_serialize(dfa)                                 (_flat_dfa_serialize(dfa))
 #define flat_dfa_deserialize(ptr)                               (_flat_dfa_deserialize(ptr))
 #define flat_dfa_from_compressed_dfa(dfa)                       (_flat_dfa_from_compressed_dfa(dfa))
+#define flat_dfa_run_greedy_reverse(dfa, ptr, sz)               (_flat_dfa_run_greedy_reverse((dfa), (ptr), (sz)))
 struct _flat_dfa_ ;
 
 /* Virtual table for mutable DFA functions */
@@ -50,19 +53,22 @@ _flat_dfa_t* _flat_dfa_new(size_t state_size);
 /* Throws an assert error if the dfa is locked. */
 inline void _flat_assert_is_not_locked(_flat_dfa_t *dfa) { }
 
-/* Runs the dfa with the given transition iterator. */
-size_t _flat_dfa_run_greedy(_flat_dfa_t *dfa, const char *ptr, size_t ptr_sz) {
+/* Runs the dfa on ptr[0], ptr[step], ..., ptr[ptr_sz * step]. */
+static inline __attribute__((always_inline)) size_t _flat_dfa_run_greedy_step(_flat_dfa_t *dfa,
+    const char *ptr, size_t ptr_sz, ptrdiff_t step) {
     size_t current_state = _flat_dfa_begin_state;
     size_t offset = 0UL;
     size_t max_right_bound = ~0UL;
     size_t state = 0;
+    apli_stat_inc(dfa_runs);
     while(offset <= ptr_sz) {
         size_t real_state = current_state >> 1;        
         if (_flat_dfa_state_exists(
-            dfa->transition[_flat_dfa_offset_into_transition(real_state, ptr[offset])]
+            dfa->transition[_flat_dfa_offset_into_transition(real_state, ptr[(ptrdiff_t) offset * step])]
         )) {
-            current_state = dfa->transition[_flat_dfa_offset_into_transition(real_state, ptr[offset])];
+            current_state = dfa->transition[_flat_dfa_offset_into_transition(real_state, ptr[(ptrdiff_t) offset * step])];
         } else {
+            apli_stat_inc(dfa_begin_resets);
             current_state = _flat_dfa_begin_state;
         }
         ++offset;
@@ -70,15 +76,27 @@ size_t _flat_dfa_run_greedy(_flat_dfa_t *dfa, const char *ptr, size_t ptr_sz) {
         /* printf("OFFSET: %zu, STATE: %zu\n", offset, current_state); */
         if(real_state == _flat_dfa_begin_state && max_right_bound != ~0UL) {
             /* printf("RETURNING\n"); */
-            return max_right_bound;\
+            apli_stat_add(dfa_transitions, offset);
+            return max_right_bound;
         } else if(_flat_dfa_state_is_accept(current_state)) {
             /* printf("State is accepting!\n"); */
             max_right_bound = offset;
         }
     }
+    apli_stat_add(dfa_transitions, offset);
     return max_right_bound;
 }
 
+/* Runs the dfa on the string at `ptr`. */
+size_t _flat_dfa_run_greedy(_flat_dfa_t *dfa, const char *ptr, size_t ptr_sz) {
+    return _flat_dfa_run_greedy_step(dfa, ptr, ptr_sz, 1);
+}
+
+/* Runs the dfa on the string that ends at `ptr`, backwards: ptr[0], ptr[-1], ..., ptr[-ptr_sz]. */
+size_t _flat_dfa_run_greedy_reverse(_flat_dfa_t *dfa, const char *ptr, size_t ptr_sz) {
+    return _flat_dfa_run_greedy_step(dfa, ptr, ptr_sz, -1);
+}
+
 /* Runs the dfa with the given transition iterator. */
 size_t _flat_dfa_run_greedy_iterator(_flat_dfa_t *dfa, Iterator(char) *transition_iter) {
     size_t current_state = _flat_dfa_begin_state;
@@ -10,6 +10,8 @@
 #else
 #include "nfa_optimized.h"
 #endif
+#include "nfa_sim.h"
+#include "lazy_dfa.h"
 
 #include "../util/bitset.h"
 
@@ -22,6 +24,33 @@
  *     - regex_run(reg, str: const char*)     -> size_t ( 0 or 1 )
  *     - regex_find_all(reg, const char*)     -> List(_regex_match_t)*
  *     - regex_free(reg)                      -> void
+ *   regex_source_hash(str: const char*)      -> size_t
+ *
+ *   RegexCursor cursor = regex_cursor_init();
+ *     - regex_next_match(reg, str: const char*, len, &cursor)
+ *                                            -> size_t ( 0 or 1, the match is `cursor.match` )
+ *     - regex_next_matches(reg, str, len, &cursor, matches: _regex_match_t*, capacity)
+ *                                            -> size_t ( # of matches written to `matches` )
+ *
+ * A cursor walks the matches of `regex_find_all` one at a time (or a batch at a time, into an
+ * array of the caller's), over the `len` characters at `str` (which need not end in '\0').
+ * Nothing is allocated while it walks: the string is neither measured nor copied reversed, as
+ * the backward runs read it right to left. Generated backward scanners only read forwards, so
+ * cursors run the backward DFAs instead.
+ *
+ * A direction whose DFA would have more than `REGEX_DFA_STATE_BUDGET` states (ie. the 2^n
+ * states of `(a|b)*a(a|b)...(a|b)`) stops the subset construction there and runs its NFA
+ * instead (see nfa_sim.h), so that matching stays linear and compiling does not blow up.
+ *
+ * A bounded repetition `r{m,n}` is `n` copies of `r` in the NFA, unless the copies would have
+ * more than `REGEX_REPEAT_COPY_BUDGET` NFA states: then `r` is in the NFA once, with a counter of
+ * its iterations (as `[0-9]{1,1000}` would have a thousand copies, and a DFA that counts to a
+ * thousand). Regexes with counters always run their NFAs. Counters do not nest, so an `r` with
+ * a counter of its own is copied. A regex whose NFA would still need more than `_NFA_MAX_STATES`
+ * states (ie. `((a){1,40}){1,40}`) does not compile: `regex_compile` returns NULL.
+ *
+ * With `-DLAZY_DFA`, `regex_compile` only builds the NFAs, and the DFAs are determinized
+ * while they run (see lazy_dfa.h). Regexes loaded from DFA caches still run their tables.
  */
 
 #define Regex                       _regex_t
@@ -31,6 +60,13 @@
 #define regex_find_all(regex,str)   (_regex_fn_impl_.find_all_matches((regex), (str)))
 #define regex_load(regex, fd, bw)   (_regex_fn_impl_.load((regex), (fd), (bw)))
 #define regex_free(regex)           (_regex_fn_impl_.destroy((regex)))
+#define regex_source_hash(str)      (_regex_source_hash((str)))
+
+#define RegexCursor                                             _regex_cursor_t
+#define regex_cursor_init()                                     ((_regex_cursor_t) {0, {0, 0}})
+#define regex_next_match(regex, str, len, cursor)               (_regex_cursor_next((regex), (str), (len), (cursor)))
+#define regex_next_matches(regex, str, len, cursor, matches, capacity) \
+    (_regex_cursor_next_batch((regex), (str), (len), (cursor), (matches), (capacity)))
 
 /**
  * Regex parsing algorithm:
@@ -73,6 +109,14 @@ typedef struct _regex_match_ _regex_match_t;
 
 typedef struct _regex_ _regex_t;
 
+// Where a walk over the matches of a string is: the next search starts at `offset`, and
+// `match` is the last match found.
+struct _regex_cursor_ {
+    size_t offset;
+    _regex_match_t match;
+};
+typedef struct _regex_cursor_ _regex_cursor_t;
+
 typedef struct __regex_match_t_list_ _regex_match_t_list_t;
 struct _regex_fns_ {
     struct _regex_* (*from)(const char*);
@@ -92,6 +136,22 @@ define_list(_regex_match_t);
 
 #define IS_SPECIAL_CHARACTER(c) ('*' == c || '+' == c || '?' == c)
 
+// Repetitions whose copies would have more NFA states are counted instead.
+#ifndef REGEX_REPEAT_COPY_BUDGET
+#define REGEX_REPEAT_COPY_BUDGET 64
+#endif
+
+// A flat DFA stores `(state << 1) | accept` in a char (0xFF: no transition), so it holds at most
+// 127 states; a larger budget is lowered to that.
+#ifndef REGEX_DFA_STATE_BUDGET
+#define REGEX_DFA_STATE_BUDGET 127
+#endif
+#define _REGEX_MAX_FLAT_DFA_STATES _NFA_FROZEN_MAX_FLAT_DFA_STATES
+
+// A direct-coded scanner (see `token_rules_write_scanners`): a function that returns what
+// `dfa_run_greedy` returns for the DFA it was generated from.
+typedef size_t (*_regex_scanner_t)(const char*, size_t);
+
 typedef enum {REGEX_RAW_LOADED, REGEX_COMPILED} _regex_state_type;
 typedef enum {REGEX_NOT_ROOTED, REGEX_LEFT_ROOTED, REGEX_RIGHT_ROOTED} _regex_root_type;
 struct _regex_ {
@@ -102,8 +162,42 @@ struct _regex_ {
     Nfa(size_t, char) *backward_nfa;
     _flat_dfa_t *forward_dfa;
     _flat_dfa_t *backward_dfa;
+    _regex_scanner_t forward_scanner;       // run instead of the DFAs when not NULL
+    _regex_scanner_t backward_scanner;
+    _lazy_dfa_t *forward_lazy_dfa;          // instead of `forward_dfa` with `LAZY_DFA`
+    _lazy_dfa_t *backward_lazy_dfa;
+    _nfa_sim_t *forward_nfa_sim;            // instead of `forward_dfa` past the DFA state budget
+    _nfa_sim_t *backward_nfa_sim;
 };
 
+#ifdef LAZY_DFA
+#define _regex_run_greedy_reverse(regex, ptr, sz) \
+    ((NULL != (regex)->backward_lazy_dfa) \
+        ? lazy_dfa_run_greedy_reverse((regex)->backward_lazy_dfa, (ptr), (sz)) \
+        : (NULL != (regex)->backward_nfa_sim) \
+            ? nfa_sim_run_greedy_reverse((regex)->backward_nfa_sim, (ptr), (sz)) \
+            : flat_dfa_run_greedy_reverse((regex)->backward_dfa, (ptr), (sz)))
+#define _regex_run_greedy(regex, direction, ptr, sz) \
+    ((NULL != (regex)->direction##_scanner) \
+        ? (regex)->direction##_scanner((ptr), (sz)) \
+        : (NULL != (regex)->direction##_lazy_dfa) \
+            ? lazy_dfa_run_greedy((regex)->direction##_lazy_dfa, (ptr), (sz)) \
+            : (NULL != (regex)->direction##_nfa_sim) \
+                ? nfa_sim_run_greedy((regex)->direction##_nfa_sim, (ptr), (sz)) \
+                : dfa_run_greedy((regex)->direction##_dfa, (ptr), (sz)))
+#else
+#define _regex_run_greedy_reverse(regex, ptr, sz) \
+    ((NULL != (regex)->backward_nfa_sim) \
+        ? nfa_sim_run_greedy_reverse((regex)->backward_nfa_sim, (ptr), (sz)) \
+        : flat_dfa_run_greedy_reverse((regex)->backward_dfa, (ptr), (sz)))
+#define _regex_run_greedy(regex, direction, ptr, sz) \
+    ((NULL != (regex)->direction##_scanner) \
+        ? (regex)->direction##_scanner((ptr), (sz)) \
+        : (NULL != (regex)->direction##_nfa_sim) \
+            ? nfa_sim_run_greedy((regex)->direction##_nfa_sim, (ptr), (sz)) \
+            : dfa_run_greedy((regex)->direction##_dfa, (ptr), (sz)))
+#endif
+
 _regex_t* _regex_from(const char* str) {
     size_t str_size = strlen(str);
     char *buf = (char*) malloc(str_size * sizeof(char) + 1);
@@ -117,6 +211,12 @@ _regex_t* _regex_from(const char* str) {
     new_regex->backward_nfa = NULL;
     new_regex->forward_dfa = NULL;
     new_regex->backward_dfa = NULL;
+    new_regex->forward_scanner = NULL;
+    new_regex->backward_scanner = NULL;
+    new_regex->forward_lazy_dfa = NULL;
+    new_regex->backward_lazy_dfa = NULL;
+    new_regex->forward_nfa_sim = NULL;
+    new_regex->backward_nfa_sim = NULL;
     return new_regex;
 }
 
@@ -140,6 +240,7 @@ size_t _regex_expand_token(Vector(char)*, Nfa(size_t, char)*, size_t, const char
 size_t _regex_string_segment_equals(const char*, _regex_string_segment_t segment);
 size_t _regex_is_special_character(_regex_string_segment_t);
 void _regex_add_all_alphabet_transitions_between(Vector(char) *alphabet, Nfa(size_t, char) *nfa, size_t state1, size_t state2);
+_nfa_char_class_t _regex_alphabet_char_class(Vector(char) *alphabet);
 void _debug_print_regex_string_segment_t(_regex_string_segment_t rss);
 void _regex_expand_root_at_start_token_check(Vector(char) *alphabet, Nfa(size_t, char) *nfa, _regex_string_segment_t *current, size_t *next_start, size_t *end);
 void _regex_expand_root_at_start_token(Vector(char) *alphabet, Nfa(size_t, char) *nfa, _regex_string_segment_t *current, size_t *next_start, size_t *end);
@@ -152,66 +253,108 @@ void _regex_process_repeat_token(size_t *from, size_t *to, const char *raw_regex
 
 #include <stdio.h> // TODO: delete this
 
-_regex_t* _regex_compile(_regex_t *regex) {
+// Builds the NFA and the flat DFA of one direction. Both directions of a regex can be built
+// concurrently; `_regex_compile` builds both and marks the regex as compiled. Returns NULL if
+// the NFA would be too large (see `nfa_is_too_large`).
+_regex_t* _regex_compile_direction(_regex_t *regex, _regex_parse_direction_t direction) {
     size_t regex_size = strlen(regex->raw_regex);
-    regex->forward_nfa = nfa_new(size_t, char, 0);
-    regex->backward_nfa = nfa_new(size_t, char, 0);
+    Nfa(size_t, char) *nfa = nfa_new(size_t, char, 0);
     Vector(char) *alphabet = vector_new(char);
     for(int i = 0; i < (1 << _flat_dfa_offset_constant); ++i) {
         vector_push_back(alphabet, i);
     }
-    // printf("forward dfa: \n");
-    size_t fend = _regex_parse(alphabet, regex->forward_nfa, 0, regex->raw_regex, regex_size, REGEX_FORWARD);
-    // printf("backward dfa: \n");
-    size_t bend = _regex_parse(alphabet, regex->backward_nfa, 0, regex->raw_regex, regex_size, REGEX_BACKWARD);
+    size_t end = _regex_parse(alphabet, nfa, 0, regex->raw_regex, regex_size, direction);
+    if(nfa_is_too_large(nfa)) {
+        nfa_free(nfa);
+        vector_free(alphabet);
+        return NULL;
+    }
     // printf("[`%s`] # of nfa states: %zu, ", regex->raw_regex, end + 1);
-    nfa_add_accept_state(regex->forward_nfa, fend);
-    nfa_add_accept_state(regex->backward_nfa, bend);
-    Dfa(size_t_set_ptr_t, char) *forward_dfa = nfa_to_dfa(regex->forward_nfa, alphabet);
-    Dfa(size_t_set_ptr_t, char) *backward_dfa = nfa_to_dfa(regex->backward_nfa, alphabet);
-    // printf("# of dfa transitions: %zu\n", map_size(dfa->transition_map));
+    nfa_add_accept_state(nfa, end);
+    if(0 < nfa_num_counters(nfa)) {
+        // Neither DFA knows about counters: the NFA is simulated.
+        vector_free(alphabet);
+        if(REGEX_FORWARD == direction) {
+            regex->forward_nfa = nfa;
+            regex->forward_nfa_sim = nfa_sim_from_nfa(nfa);
+        } else {
+            regex->backward_nfa = nfa;
+            regex->backward_nfa_sim = nfa_sim_from_nfa(nfa);
+        }
+        return regex;
+    }
+#ifdef LAZY_DFA
+    // The subset construction is left to the runs.
     vector_free(alphabet);
-    Dfa(size_t, char) *compressed_forward_dfa = dfa_compress(forward_dfa); // added step
-    Dfa(size_t, char) *compressed_backward_dfa = dfa_compress(backward_dfa); // added step
-
-#ifdef PRINT_REGEX_COMPILATION
-    printf("Finished compiling `%s`\n", regex->raw_regex);
-    printf("Begin state: %zu\n", compressed_forward_dfa->begin_state);
-    List(size_t) *lst = set_get_list(compressed_forward_dfa->accept_states);
-    size_t max = 0UL;
-    while(list_size(lst)) {
-        if(max < list_get_front(lst))
-            max = list_get_front(lst);
-        list_pop_front(lst);
+    if(REGEX_FORWARD == direction) {
+        regex->forward_nfa = nfa;
+        regex->forward_lazy_dfa = lazy_dfa_from_nfa(nfa);
+    } else {
+        regex->backward_nfa = nfa;
+        regex->backward_lazy_dfa = lazy_dfa_from_nfa(nfa);
     }
-    printf("# of dfa states: %zu\n\n", max);
+    return regex;
 #endif
+    size_t max_states = (REGEX_DFA_STATE_BUDGET < _REGEX_MAX_FLAT_DFA_STATES)
+        ? REGEX_DFA_STATE_BUDGET : _REGEX_MAX_FLAT_DFA_STATES;
+    _nfa_frozen_t *frozen_nfa = nfa_freeze(nfa, alphabet);
+    _flat_dfa_t *flat_dfa = nfa_frozen_to_flat_dfa(frozen_nfa, max_states);
+    nfa_frozen_free(frozen_nfa);
+    vector_free(alphabet);
+    if(NULL == flat_dfa) {
+        if(REGEX_FORWARD == direction) {
+            regex->forward_nfa = nfa;
+            regex->forward_nfa_sim = nfa_sim_from_nfa(nfa);
+        } else {
+            regex->backward_nfa = nfa;
+            regex->backward_nfa_sim = nfa_sim_from_nfa(nfa);
+        }
+        return regex;
+    }
 
-    dfa_free(forward_dfa);
-    dfa_free(backward_dfa);
-    regex->forward_dfa = flat_dfa_from_compressed_dfa(compressed_forward_dfa);
-    regex->backward_dfa = flat_dfa_from_compressed_dfa(compressed_backward_dfa);
+#ifdef PRINT_REGEX_COMPILATION
+    printf("Finished compiling `%s` (%s)\n", regex->raw_regex, REGEX_FORWARD == direction ? "forward" : "backward");
+    printf("# of dfa states: %zu\n\n", flat_dfa->state_size);
+#endif
 
 #ifdef PRINT_FLAT_DFA
     printf("Finished compiling `%s`\n", regex->raw_regex);
-    printf("Forward_dfa:");
-    const char *str = flat_dfa_serialize(regex->forward_dfa);
-    _flat_dfa_print(str);
-    free((void*) str);
-    printf("Backward_dfa:");
-    str = flat_dfa_serialize(regex->backward_dfa);
+    printf(REGEX_FORWARD == direction ? "Forward_dfa:" : "Backward_dfa:");
+    const char *str = flat_dfa_serialize(flat_dfa);
     _flat_dfa_print(str);
     free((void*) str);
     printf("\n");
 #endif
 
-    dfa_free(compressed_forward_dfa);
-    dfa_free(compressed_backward_dfa);
+    if(REGEX_FORWARD == direction) {
+        regex->forward_nfa = nfa;
+        regex->forward_dfa = flat_dfa;
+    } else {
+        regex->backward_nfa = nfa;
+        regex->backward_dfa = flat_dfa;
+    }
+    return regex;
+}
 
+// Returns NULL (and the regex stays uncompiled) if its NFA would be too large.
+_regex_t* _regex_compile(_regex_t *regex) {
+    if(NULL == _regex_compile_direction(regex, REGEX_FORWARD)
+    || NULL == _regex_compile_direction(regex, REGEX_BACKWARD))
+        return NULL;
     regex->state = REGEX_COMPILED;
     return regex;
 }
 
+// FNV-1a over the raw regex; stamped on cached DFAs to detect that their regex changed.
+size_t _regex_source_hash(const char *raw_regex) {
+    size_t hash = 14695981039346656037UL;
+    for(; '\0' != *raw_regex; ++raw_regex) {
+        hash ^= (255UL & *raw_regex);
+        hash *= 1099511628211UL;
+    }
+    return hash;
+}
+
 _regex_t* _regex_load_flat_dfas(_regex_t *regex, const char *forward, const char *backward) {
     regex->forward_dfa = flat_dfa_deserialize(forward);
     regex->backward_dfa = flat_dfa_deserialize(backward);
@@ -383,6 +526,36 @@ void _regex_expand_non_root_token(Vector(char)* alphabet, Nfa(size_t, char) *nfa
             // printf("from: %zu, to: %zu\n", from, to);
             nfa_add_epsilon_transition(nfa, (*next_start), (*next_start)+1);
             *next_start = (*next_start) + 1;
+            size_t copies = (0 != to + 1 && from < to) ? to : from;
+            // The body is expanded on the side first, for the number of NFA states of a copy.
+            Nfa(size_t, char) *body = nfa_new(size_t, char, 0);
+            size_t body_states = _regex_expand_token(alphabet, body, 1, current->ptr, current->length, pd);
+            size_t body_counts = (0 < nfa_num_counters(body)), body_too_large = nfa_is_too_large(body);
+            nfa_free(body);
+            // Counters do not nest: a body with a counter of its own is copied.
+            size_t counted = (REGEX_REPEAT_COPY_BUDGET < copies * body_states && !body_counts);
+            size_t needed = counted ? body_states + 3 : (copies + 1) * body_states + 3;
+            if (body_too_large || _NFA_MAX_STATES <= *next_start + needed) {
+                // The repetition matches nothing, and the regex is rejected (see `nfa_is_too_large`).
+                nfa_set_too_large(nfa);
+                *end = *next_start;
+                *current = next;
+                list_pop_front(tokens);
+                continue;
+            }
+            if (counted) {
+                // One counted copy of the body, between `begin` and `body_end`, instead of `to` copies.
+                size_t begin = *next_start;
+                nfa_add_epsilon_transition(nfa, begin, begin + 1);
+                size_t body_end = _regex_expand_token(alphabet, nfa, begin + 1, current->ptr, current->length, pd);
+                nfa_add_epsilon_transition(nfa, body_end, body_end + 1);
+                nfa_add_counter(nfa, begin, body_end + 1, body_end + 2, from, (0 != to + 1) ? to : _NFA_UNBOUNDED);
+                *end = body_end + 2;
+                *next_start = *end;
+                *current = next;
+                list_pop_front(tokens);
+                continue;
+            }
             for(size_t i = 0; i < from; ++i) {
                 *end = _regex_expand_token(alphabet, nfa, *next_start, current->ptr, current->length, pd);
                 *next_start = *end;
@@ -491,8 +664,8 @@ size_t _regex_expand_token(Vector(char) *alphabet, Nfa(size_t, char) *nfa, size_
         if('^' == raw_regex[1]) {
             start_index = 2;
             inverted_flag = 1;
-            _regex_add_all_alphabet_transitions_between(alphabet, nfa, begin_expansion_state, begin_expansion_state + 1);
         }
+        _nfa_char_class_t chars = nfa_char_class_empty();
         size_t end_index = raw_regex_size - 1;
         for(size_t ind = start_index; ind < end_index; ++ind) {
             if(ind + 2 < end_index && '\\' != raw_regex[ind] && '-' == raw_regex[ind+1]) {
@@ -501,20 +674,23 @@ size_t _regex_expand_token(Vector(char) *alphabet, Nfa(size_t, char) *nfa, size_
                 char end = raw_regex[ind+2];
                 if(end < start)
                     assert(0 == "Invalid character span (end_char < start_char)");
-                for(char c = start; c <= end; ++c)
-                    if(inverted_flag)
-                        nfa_remove_transition(nfa, begin_expansion_state, c, begin_expansion_state + 1);
-                    else
-                        nfa_add_transition(nfa, begin_expansion_state, c, begin_expansion_state + 1);
+                nfa_char_class_insert_range(&chars, start, end);
                 ind += 2; // we have processed raw_regex[ind + 2]
             } else {
                 // No character span
-                if(inverted_flag)
-                    nfa_remove_transition(nfa, begin_expansion_state, raw_regex[ind], begin_expansion_state + 1);
-                else
-                    nfa_add_transition(nfa, begin_expansion_state, raw_regex[ind], begin_expansion_state + 1);
+                nfa_char_class_insert(&chars, raw_regex[ind]);
             }
         }
+        if(inverted_flag) {
+            // The listed characters of the alphabet lead to the empty set of states.
+            _nfa_char_class_t alphabet_chars = _regex_alphabet_char_class(alphabet), listed = chars;
+            for(size_t i = 0; i < _NFA_CHAR_CLASS_WORDS; ++i) {
+                chars.bits[i] = alphabet_chars.bits[i] & ~listed.bits[i];
+                listed.bits[i] &= alphabet_chars.bits[i];
+            }
+            nfa_add_dead_class_transition(nfa, begin_expansion_state, listed);
+        }
+        nfa_add_class_transition(nfa, begin_expansion_state, chars, begin_expansion_state + 1);
         return begin_expansion_state + 1;
     }
     _regex_string_segment_t rss = {raw_regex, raw_regex_size};
@@ -522,11 +698,16 @@ size_t _regex_expand_token(Vector(char) *alphabet, Nfa(size_t, char) *nfa, size_
     assert(0 == "Invalid regex format.");
 }
 
-void _regex_add_all_alphabet_transitions_between(Vector(char) *alphabet, Nfa(size_t, char) *nfa, size_t state1, size_t state2) {
+_nfa_char_class_t _regex_alphabet_char_class(Vector(char) *alphabet) {
+    _nfa_char_class_t chars = nfa_char_class_empty();
     size_t alphabet_sz = vector_size(alphabet);
-    for(size_t i = 0; i < alphabet_sz; ++i) {
-        nfa_add_transition(nfa, state1, vector_get(alphabet, i), state2);
-    }
+    for(size_t i = 0; i < alphabet_sz; ++i)
+        nfa_char_class_insert(&chars, vector_get(alphabet, i));
+    return chars;
+}
+
+void _regex_add_all_alphabet_transitions_between(Vector(char) *alphabet, Nfa(size_t, char) *nfa, size_t state1, size_t state2) {
+    nfa_add_class_transition(nfa, state1, _regex_alphabet_char_class(alphabet), state2);
 }
 
 #define _regex_list_append_on_parse_direction(list, elm) \
@@ -587,10 +768,10 @@ List(_regex_string_segment_t)* _regex_split_by_tokens(const char *ptr, size_t si
                 bracket_level -= 1;
         } else if (')' == ptr[i]) {
             paren_level -= 1;
-        } else if ('{' == ptr[i] && 0 == paren_level) {
+        } else if ('{' == ptr[i] && 0 == paren_level && 0 == bracket_level) {
             curly_bracket_level += 1;
             capture_group_begin_offset = i;
-        } else if ('}' == ptr[i] && 0 == paren_level) {
+        } else if ('}' == ptr[i] && 0 == paren_level && 0 == bracket_level) {
             curly_bracket_level -= 1;
             _regex_list_append_on_parse_direction(tokens, _regex_string_segment_from(ptr, capture_group_begin_offset, i+1));
             if(pd == REGEX_BACKWARD) {
@@ -644,18 +825,10 @@ size_t _regex_run(_regex_t *regex, const char *str) {
         rev_str[str_sz - i - 1] = str[i];
     rev_str[str_sz] = '\0';
     
-    size_t right_bound = dfa_run_greedy(
-        regex->forward_dfa, 
-        str, 
-        str_sz
-    );
+    size_t right_bound = _regex_run_greedy(regex, forward, str, str_sz);
     if(right_bound == ~0UL)
         return 0UL;
-    size_t rev_right_bound = dfa_run_greedy(
-        regex->backward_dfa, 
-        rev_str + (str_sz - right_bound),
-        right_bound
-    );
+    size_t rev_right_bound = _regex_run_greedy(regex, backward, rev_str + (str_sz - right_bound), right_bound);
     assert(rev_right_bound != ~0UL);
     size_t left_bound = right_bound - rev_right_bound;
 
@@ -671,58 +844,130 @@ size_t _regex_run(_regex_t *regex, const char *str) {
     return accept_flag;
 }
 
-List(_regex_match_t)* _regex_find_all_regex_matches(_regex_t *regex, const char *str) {
-    if(REGEX_COMPILED != regex->state)
-        assert(0 == "A regex cannot be run without first being compiled.");
-    
-    List(_regex_match_t) *matches = list_new(_regex_match_t);
-    size_t str_sz = strlen(str);
-
+char *_regex_reverse_string(const char *str, size_t str_sz) {
     char *rev_str = (char*) malloc(sizeof(char) * (str_sz + 1));
     for(size_t i = 0; i < str_sz; ++i)
         rev_str[str_sz - i - 1] = str[i];
     rev_str[str_sz] = '\0';
+    return rev_str;
+}
+
+// The leftmost-longest match that ends at `right_bound` and begins at or after `floor`. A run
+// reads one character past its size, so the backward run is given one less than the characters
+// in [floor, right_bound).
+static inline size_t _regex_match_ending_at(_regex_t *regex, const char *rev_str, size_t str_sz,
+    size_t floor, size_t right_bound, _regex_match_t *match) {
+    match->begin = right_bound;
+    match->length = 0;
+    if(right_bound == floor)
+        return 1;
+    size_t rev_right_bound = _regex_run_greedy(regex, backward, rev_str + (str_sz - right_bound), right_bound - floor - 1);
+    assert(rev_right_bound != ~0UL);
+    match->begin -= rev_right_bound;
+    match->length = rev_right_bound;
+    return 1;
+}
+
+// Finds the leftmost-longest match after `cursor->offset` in `str[0 .. str_sz)`, without the
+// reversed string: the backward run reads `str` right to left from the end of the match. Finds
+// what `_regex_next_match` finds, and moves the cursor past the match.
+size_t _regex_cursor_next(_regex_t *regex, const char *str, size_t str_sz, _regex_cursor_t *cursor) {
+    size_t offset = cursor->offset;
+    if(offset >= str_sz)
+        return 0;
+    size_t right_bound = _regex_run_greedy(regex, forward, str + offset, str_sz - offset - 1);
+    if(right_bound == ~0UL) {
+        cursor->offset = str_sz;
+        return 0;
+    }
+    right_bound += offset;
+    size_t rev_right_bound = _regex_run_greedy_reverse(regex, str + right_bound - 1, right_bound - 1);
+    assert(rev_right_bound != ~0UL);
+    cursor->match.begin = right_bound - rev_right_bound;
+    cursor->match.length = rev_right_bound;
+    cursor->offset = right_bound;
+    return 1;
+}
+
+// Writes the next matches of `cursor` to `matches`, until `capacity` of them or the end of `str`.
+size_t _regex_cursor_next_batch(_regex_t *regex, const char *str, size_t str_sz, _regex_cursor_t *cursor,
+    _regex_match_t *matches, size_t capacity) {
+    size_t size = 0;
+    while(size < capacity && _regex_cursor_next(regex, str, str_sz, cursor))
+        matches[size++] = cursor->match;
+    return size;
+}
 
+// Finds the leftmost-longest match that ends after `offset` (`rev_str` is `str` reversed).
+// Returns 0 if there is none. The result only depends on `offset`, which is what lets
+// `_regex_find_matches_between` run on several parts of the same string at once.
+size_t _regex_next_match(_regex_t *regex, const char *str, const char *rev_str, size_t str_sz,
+    size_t offset, _regex_match_t *match) {
+    if(offset >= str_sz)
+        return 0;
+    size_t right_bound = _regex_run_greedy(regex, forward, str + offset, str_sz - offset - 1);
+    if(right_bound == ~0UL)
+        return 0;
+    return _regex_match_ending_at(regex, rev_str, str_sz, 0, right_bound + offset, match);
+}
+
+// `_regex_next_match`, but the match begins at or after `offset` (instead of extending to before it).
+size_t _regex_next_match_from(_regex_t *regex, const char *str, const char *rev_str, size_t str_sz,
+    size_t offset, _regex_match_t *match) {
+    if(offset >= str_sz)
+        return 0;
+    size_t right_bound = _regex_run_greedy(regex, forward, str + offset, str_sz - offset - 1);
+    if(right_bound == ~0UL)
+        return 0;
+    return _regex_match_ending_at(regex, rev_str, str_sz, offset, right_bound + offset, match);
+}
+
+// Appends the matches found by searching from `offset`, then from the end of each match,
+// for as long as the search starts before `end`. Returns the offset the next search would
+// start at, or ~0 if a search found no match.
+size_t _regex_find_matches_between(_regex_t *regex, const char *str, const char *rev_str, size_t str_sz,
+    size_t offset, size_t end, List(_regex_match_t) *matches) {
     _regex_match_t match;
-    size_t right_bound, offset = 0, left_bound, rev_right_bound;
-    do {
-        if(offset >= str_sz) break;
-        right_bound = dfa_run_greedy(
-            regex->forward_dfa, 
-            str + offset, 
-            str_sz - offset
-        );
-        if(right_bound == ~0UL) break;
-        right_bound += offset;
-        rev_right_bound = dfa_run_greedy(
-            regex->backward_dfa, 
-            rev_str + (str_sz - right_bound),
-            right_bound
-        );
-        assert(rev_right_bound != ~0UL);
-        left_bound = right_bound - rev_right_bound;
-        // printf("[%zu, %zu) rrb=%zu\n", left_bound, right_bound, rev_right_bound);
-        match.begin = left_bound;
-        match.length = right_bound - left_bound;
+    while(offset < end && offset < str_sz) {
+        if(!_regex_next_match(regex, str, rev_str, str_sz, offset, &match))
+            return ~0UL;
         list_push_back(matches, match);
-        offset = right_bound;
-    } while(1);
-
-    free(rev_str);
+        offset = match.begin + match.length;
+    }
+    return offset;
+}
 
+List(_regex_match_t)* _regex_find_all_regex_matches(_regex_t *regex, const char *str) {
+    if(REGEX_COMPILED != regex->state)
+        assert(0 == "A regex cannot be run without first being compiled.");
+    
+    List(_regex_match_t) *matches = list_new(_regex_match_t);
+    size_t str_sz = strlen(str);
+    _regex_cursor_t cursor = regex_cursor_init();
+    while(_regex_cursor_next(regex, str, str_sz, &cursor))
+        list_push_back(matches, cursor.match);
     return matches;
 }
 
 void _regex_destroy(_regex_t *regex) {
     free((void*) regex->raw_regex);
-    if(regex->state == REGEX_RAW_LOADED) {
-        free(regex);
-        return;
-    }
-    nfa_free(regex->forward_nfa);
-    nfa_free(regex->backward_nfa);
-    dfa_free(regex->forward_dfa);
-    dfa_free(regex->backward_dfa);
+    // Regexes loaded from serialized DFAs never had NFAs.
+    if(NULL != regex->forward_nfa)
+        nfa_free(regex->forward_nfa);
+    if(NULL != regex->backward_nfa)
+        nfa_free(regex->backward_nfa);
+    if(NULL != regex->forward_lazy_dfa)
+        lazy_dfa_free(regex->forward_lazy_dfa);
+    if(NULL != regex->backward_lazy_dfa)
+        lazy_dfa_free(regex->backward_lazy_dfa);
+    if(NULL != regex->forward_nfa_sim)
+        nfa_sim_free(regex->forward_nfa_sim);
+    if(NULL != regex->backward_nfa_sim)
+        nfa_sim_free(regex->backward_nfa_sim);
+    if(NULL != regex->forward_dfa)
+        dfa_free(regex->forward_dfa);
+    if(NULL != regex->backward_dfa)
+        dfa_free(regex->backward_dfa);
     free(regex);
 }
 
@@ -0,0 +1,299 @@
+#ifndef LAZY_DFA_H
+#define LAZY_DFA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "../util/stats.h"
+#include "nfa_sim.h"
+
+/**
+ * A DFA that is determinized while it runs (as in RE2), instead of by a full subset
+ * construction up front.
+ *
+ * `lazy_dfa_from_nfa` only copies the NFA into flat arrays (an `NfaSim`), so building one is
+ * linear in the size of the NFA and its epsilon-closures. A DFA state (a set of NFA states) is created the first time a run reaches
+ * it, and each of its transitions the first time it is taken; both are cached for the
+ * following runs. `lazy_dfa_run_greedy` returns what `dfa_run_greedy` returns for the full
+ * DFA of the same NFA, except that bytes >= 128 (outside of the regex alphabet) never have a
+ * transition.
+ *
+ * The cache holds at most `LAZY_DFA_CACHE_STATES` states. When it is full it is replaced by an
+ * empty one, which the run continues in; after `LAZY_DFA_MAX_CACHE_RESETS` resets the cache is
+ * considered to thrash, and every later run simulates the NFA directly (see nfa_sim.h;
+ * nothing is cached).
+ *
+ * Runs may share a lazy DFA across threads: cached transitions are read without locking and
+ * new ones are added under a mutex. A replaced cache is kept (runs may still be reading it)
+ * until the DFA is freed; since the cache is replaced at most `LAZY_DFA_MAX_CACHE_RESETS`
+ * times (but for runs that were in progress then), so is the memory.
+ *
+ * ----- Usage -----
+ *   LazyDfa *dfa = lazy_dfa_from_nfa(nfa: Nfa(size_t, char)*);   (the NFA is only read)
+ *     - lazy_dfa_run_greedy(dfa, ptr: const char*, ptr_sz)  -> size_t ( as `dfa_run_greedy` )
+ *     - lazy_dfa_run_greedy_reverse(dfa, ptr, ptr_sz)      -> size_t ( on ptr[0], ptr[-1], ..., ptr[-ptr_sz] )
+ *     - lazy_dfa_num_states(dfa)                           -> size_t ( # of states in the cache )
+ *     - lazy_dfa_uses_nfa(dfa)                             -> size_t ( 1 once the cache thrashed )
+ *     - lazy_dfa_free(dfa)                                 -> void
+ */
+
+#define LazyDfa                                 _lazy_dfa_t
+#define lazy_dfa_from_nfa(nfa)                  (_lazy_dfa_from_nfa((nfa)))
+#define lazy_dfa_run_greedy(dfa, ptr, ptr_sz)   (_lazy_dfa_run_greedy((dfa), (ptr), (ptr_sz)))
+#define lazy_dfa_run_greedy_reverse(dfa, ptr, ptr_sz) (_lazy_dfa_run_greedy_reverse((dfa), (ptr), (ptr_sz)))
+#define lazy_dfa_num_states(dfa)                (__atomic_load_n(&(dfa)->cache, __ATOMIC_ACQUIRE)->num_states)
+#define lazy_dfa_uses_nfa(dfa)                  ((size_t) __atomic_load_n(&(dfa)->nfa_fallback, __ATOMIC_ACQUIRE))
+#define lazy_dfa_free(dfa)                      (_lazy_dfa_free((dfa)))
+
+// At least 2: the begin state and the state a run is in.
+#ifndef LAZY_DFA_CACHE_STATES
+#define LAZY_DFA_CACHE_STATES 256
+#endif
+
+#ifndef LAZY_DFA_MAX_CACHE_RESETS
+#define LAZY_DFA_MAX_CACHE_RESETS 8
+#endif
+
+#define LAZY_DFA_ALPHABET_SIZE      128
+// A transition is stored as `((to << 1) | accept) + 1` (as in a flat DFA, offset by one), so
+// that a zeroed row means "not computed yet".
+#define LAZY_DFA_UNKNOWN            0
+#define LAZY_DFA_NO_TRANSITION      (-1)
+
+typedef struct _lazy_dfa_state_ {
+    int next[LAZY_DFA_ALPHABET_SIZE];
+    int accept;
+    uint32_t *set;                  // the NFA states, sorted
+    size_t set_size;
+} _lazy_dfa_state_t;
+
+// A cache of states. State 0 is always the epsilon-closure of the NFA's begin state.
+typedef struct _lazy_dfa_cache_ {
+    _lazy_dfa_state_t *states;
+    size_t num_states;
+    int *table;                     // open addressing from a set's hash to its state, -1 if empty
+    size_t table_mask;
+    struct _lazy_dfa_cache_ *retired;   // the cache this one replaced
+} _lazy_dfa_cache_t;
+
+typedef struct _lazy_dfa_ {
+    // The NFA (its edges and epsilon-closures), which also runs once the cache thrashed.
+    _nfa_sim_t *nfa;
+    // The cache new states are added to. A reset replaces it; the replaced caches are only freed
+    // with the DFA, since runs that started in them may still read them.
+    _lazy_dfa_cache_t *cache;
+    size_t cache_resets;
+    int nfa_fallback;
+    // Scratch space for adding states (guarded by `add_lock`).
+    uint32_t *scratch;
+    uint32_t *marks;
+    uint32_t mark;
+    pthread_mutex_t add_lock;       // held while adding states and transitions
+} _lazy_dfa_t;
+
+static int _lazy_dfa_compare_states(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t*) a, y = *(const uint32_t*) b;
+    return (x > y) - (x < y);
+}
+
+static size_t _lazy_dfa_hash_set(const uint32_t *set, size_t set_size) {
+    size_t hash = 14695981039346656037UL;
+    for(size_t i = 0; i < set_size; ++i) {
+        hash ^= set[i];
+        hash *= 1099511628211UL;
+    }
+    return hash;
+}
+
+static uint32_t _lazy_dfa_next_mark(_lazy_dfa_t *dfa) {
+    if(0 == ++dfa->mark) {
+        memset(dfa->marks, 0, sizeof(uint32_t) * dfa->nfa->num_states);
+        dfa->mark = 1;
+    }
+    return dfa->mark;
+}
+
+/* Returns the state of the sorted `set`, adding it if it is new; ~0 if the cache is full. */
+static size_t _lazy_dfa_intern_state(_lazy_dfa_cache_t *cache, const uint32_t *set, size_t set_size, int accept) {
+    size_t slot = _lazy_dfa_hash_set(set, set_size) & cache->table_mask;
+    for(; -1 != cache->table[slot]; slot = (slot + 1) & cache->table_mask) {
+        _lazy_dfa_state_t *state = &cache->states[cache->table[slot]];
+        if(set_size == state->set_size && 0 == memcmp(set, state->set, sizeof(uint32_t) * set_size))
+            return (size_t) cache->table[slot];
+    }
+    size_t index = cache->num_states;
+    if(LAZY_DFA_CACHE_STATES == index)
+        return ~0UL;
+    _lazy_dfa_state_t *state = &cache->states[index];
+    state->accept = accept;
+    state->set = (uint32_t*) malloc(sizeof(uint32_t) * (set_size ? set_size : 1));
+    memcpy(state->set, set, sizeof(uint32_t) * set_size);
+    state->set_size = set_size;
+    cache->table[slot] = (int) index;
+    cache->num_states = index + 1;
+    apli_stat_inc(lazy_dfa_states);
+    return index;
+}
+
+/* Returns an empty cache but for the begin state. */
+static _lazy_dfa_cache_t *_lazy_dfa_new_cache(_lazy_dfa_t *dfa) {
+    _lazy_dfa_cache_t *cache = (_lazy_dfa_cache_t*) malloc(sizeof(_lazy_dfa_cache_t));
+    // The rows are zeroed (`LAZY_DFA_UNKNOWN`) pages, so only the states that are used cost memory.
+    cache->states = (_lazy_dfa_state_t*) calloc(LAZY_DFA_CACHE_STATES, sizeof(_lazy_dfa_state_t));
+    cache->num_states = 0;
+    size_t table_size = 1;
+    while(table_size < 2 * LAZY_DFA_CACHE_STATES)
+        table_size <<= 1;
+    cache->table = (int*) malloc(sizeof(int) * table_size);
+    for(size_t i = 0; i < table_size; ++i)
+        cache->table[i] = -1;
+    cache->table_mask = table_size - 1;
+    cache->retired = NULL;
+    const _nfa_sim_t *nfa = dfa->nfa;
+    size_t begin = nfa->closure_begin[nfa->begin_state];
+    size_t size = nfa->closure_begin[nfa->begin_state + 1] - begin;
+    int accept = 0;
+    for(size_t i = 0; i < size; ++i) {
+        dfa->scratch[i] = nfa->closures[begin + i];
+        accept |= nfa->accept[dfa->scratch[i]];
+    }
+    qsort(dfa->scratch, size, sizeof(uint32_t), &_lazy_dfa_compare_states);
+    _lazy_dfa_intern_state(cache, dfa->scratch, size, accept);
+    return cache;
+}
+
+static void _lazy_dfa_free_cache(_lazy_dfa_cache_t *cache) {
+    for(size_t i = 0; i < cache->num_states; ++i)
+        free(cache->states[i].set);
+    free(cache->states);
+    free(cache->table);
+    free(cache);
+}
+
+/* Replaces the full cache with an empty one (after the last reset, later runs simulate the NFA). */
+static void _lazy_dfa_reset_cache(_lazy_dfa_t *dfa) {
+    _lazy_dfa_cache_t *cache = _lazy_dfa_new_cache(dfa);
+    cache->retired = dfa->cache;
+    dfa->cache_resets += 1;
+    apli_stat_inc(lazy_dfa_cache_resets);
+    if(LAZY_DFA_MAX_CACHE_RESETS <= dfa->cache_resets)
+        __atomic_store_n(&dfa->nfa_fallback, 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&dfa->cache, cache, __ATOMIC_RELEASE);
+}
+
+/**
+ * Computes (and caches) the transition of the state `*state` of `*cache` on `c`. If `*cache`
+ * is not the current cache (anymore), the state is first moved to the current cache, and
+ * `*cache` and `*state` are updated.
+ */
+static int _lazy_dfa_add_transition(_lazy_dfa_t *dfa, _lazy_dfa_cache_t **cache, size_t *state, unsigned char c) {
+    pthread_mutex_lock(&dfa->add_lock);
+    int next;
+    for(;;) {
+        _lazy_dfa_state_t *from = &(*cache)->states[*state];
+        if(*cache != dfa->cache) {
+            size_t moved = _lazy_dfa_intern_state(dfa->cache, from->set, from->set_size, from->accept);
+            if(~0UL == moved) {
+                _lazy_dfa_reset_cache(dfa);
+                continue;
+            }
+            *cache = dfa->cache;
+            *state = moved;
+            continue;
+        }
+        next = from->next[c];
+        if(LAZY_DFA_UNKNOWN != next)
+            break;
+        int accept, moved;
+        size_t size = _nfa_sim_step(dfa->nfa, from->set, from->set_size, c, dfa->scratch,
+            dfa->marks, _lazy_dfa_next_mark(dfa), &accept, &moved);
+        if(!moved) {
+            next = LAZY_DFA_NO_TRANSITION;
+        } else {
+            qsort(dfa->scratch, size, sizeof(uint32_t), &_lazy_dfa_compare_states);
+            size_t to = _lazy_dfa_intern_state(*cache, dfa->scratch, size, accept);
+            if(~0UL == to) {
+                // `from` moves to the new cache on the next iteration.
+                _lazy_dfa_reset_cache(dfa);
+                continue;
+            }
+            next = (int) ((to << 1) | accept) + 1;
+        }
+        // Publishes the transition after the state it leads to is filled in.
+        __atomic_store_n(&from->next[c], next, __ATOMIC_RELEASE);
+        break;
+    }
+    pthread_mutex_unlock(&dfa->add_lock);
+    return next;
+}
+
+/* Runs the DFA as `_flat_dfa_run_greedy` runs a flat DFA, on ptr[0], ptr[step], ..., ptr[ptr_sz * step]. */
+static inline __attribute__((always_inline)) size_t _lazy_dfa_run_greedy_step(_lazy_dfa_t *dfa,
+    const char *ptr, size_t ptr_sz, ptrdiff_t step) {
+    if(__atomic_load_n(&dfa->nfa_fallback, __ATOMIC_ACQUIRE))
+        return (1 == step) ? nfa_sim_run_greedy(dfa->nfa, ptr, ptr_sz) : nfa_sim_run_greedy_reverse(dfa->nfa, ptr, ptr_sz);
+    apli_stat_inc(dfa_runs);
+    _lazy_dfa_cache_t *cache = __atomic_load_n(&dfa->cache, __ATOMIC_ACQUIRE);
+    size_t current_state = 0;
+    size_t offset = 0UL;
+    size_t max_right_bound = ~0UL;
+    while(offset <= ptr_sz) {
+        size_t real_state = current_state >> 1;
+        unsigned char c = (unsigned char) ptr[(ptrdiff_t) offset * step];
+        int next = (c < LAZY_DFA_ALPHABET_SIZE)
+            ? __atomic_load_n(&cache->states[real_state].next[c], __ATOMIC_ACQUIRE) : LAZY_DFA_NO_TRANSITION;
+        if(LAZY_DFA_UNKNOWN == next)
+            next = _lazy_dfa_add_transition(dfa, &cache, &real_state, c);
+        if(LAZY_DFA_NO_TRANSITION == next) {
+            apli_stat_inc(dfa_begin_resets);
+            current_state = 0;
+        } else {
+            current_state = (size_t) (next - 1);
+        }
+        ++offset;
+        if(0 == real_state && max_right_bound != ~0UL) {
+            break;
+        } else if(current_state & 1) {
+            max_right_bound = offset;
+        }
+    }
+    apli_stat_add(dfa_transitions, offset);
+    return max_right_bound;
+}
+
+size_t _lazy_dfa_run_greedy(_lazy_dfa_t *dfa, const char *ptr, size_t ptr_sz) {
+    return _lazy_dfa_run_greedy_step(dfa, ptr, ptr_sz, 1);
+}
+
+size_t _lazy_dfa_run_greedy_reverse(_lazy_dfa_t *dfa, const char *ptr, size_t ptr_sz) {
+    return _lazy_dfa_run_greedy_step(dfa, ptr, ptr_sz, -1);
+}
+
+_lazy_dfa_t* _lazy_dfa_from_nfa(Nfa(size_t, char) *nfa) {
+    _lazy_dfa_t *dfa = (_lazy_dfa_t*) malloc(sizeof(_lazy_dfa_t));
+    dfa->nfa = nfa_sim_from_nfa(nfa);
+    dfa->cache_resets = 0;
+    dfa->nfa_fallback = 0;
+    dfa->scratch = (uint32_t*) malloc(sizeof(uint32_t) * dfa->nfa->num_states);
+    dfa->marks = (uint32_t*) calloc(dfa->nfa->num_states, sizeof(uint32_t));
+    dfa->mark = 0;
+    pthread_mutex_init(&dfa->add_lock, NULL);
+    dfa->cache = _lazy_dfa_new_cache(dfa);
+    return dfa;
+}
+
+void _lazy_dfa_free(_lazy_dfa_t *dfa) {
+    for(_lazy_dfa_cache_t *cache = dfa->cache, *retired; NULL != cache; cache = retired) {
+        retired = cache->retired;
+        _lazy_dfa_free_cache(cache);
+    }
+    nfa_sim_free(dfa->nfa);
+    free(dfa->scratch);
+    free(dfa->marks);
+    pthread_mutex_destroy(&dfa->add_lock);
+    free(dfa);
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include "greedy_regex.h"
+#include "../util/trace.h"
 // #include "lexer.h" // for syntax-completion
 
 define_vector(_token_rule_t);
@@ -9,6 +10,14 @@ define_vector(_matches_ptr);
 TokenRules* _token_rules_new() {
     TokenRules *new_tr = (TokenRules*) malloc(sizeof(TokenRules));
     new_tr->rules = vector_new(_token_rule_t);
+    new_tr->literals = aho_corasick_new();
+    new_tr->keywords = NULL;
+    new_tr->num_keywords = 0;
+    new_tr->keywords_capacity = 0;
+    new_tr->modes = (const char**) malloc(sizeof(const char*));
+    new_tr->modes[0] = TOKEN_RULES_INITIAL_MODE;
+    new_tr->num_modes = 1;
+    new_tr->current_mode = 0;
     return new_tr;
 }
 
@@ -16,47 +25,532 @@ static void _token_rules_free(TokenRules *tr) {
     size_t size = vector_size(tr->rules);
     for(size_t i = 0; i < size; ++i) {
         regex_free(vector_get(tr->rules, i).regex);
+        free(vector_get(tr->rules, i).literal);
     }
     vector_free(tr->rules);
+    aho_corasick_free(tr->literals);
+    free(tr->keywords);
+    free(tr->modes);
     free(tr);
 }
 
-void _token_rules_add_rule(TokenRules *tr, const char *name, size_t pre, size_t post, const char *raw_regex) {
-    _token_rule_t new_tr_instance = {name, pre, post, regex_from(raw_regex)};
+// The text `raw_regex` matches if it is a literal (NULL otherwise), with its escapes replaced
+// as `_regex_expand_token` reads them.
+static char* _token_rules_literal(const char *raw_regex, size_t *length) {
+    size_t raw_size = strlen(raw_regex);
+    char *literal = (char*) malloc(raw_size + 1);
+    size_t size = 0;
+    for(size_t i = 0; i < raw_size; ++i) {
+        char c = raw_regex[i];
+        if('\\' == c && i + 1 < raw_size) {
+            c = raw_regex[++i];
+            c = ('n' == c) ? '\n' : ('r' == c) ? '\r' : ('t' == c) ? '\t' : c;
+        } else if(NULL != strchr("\\()[]{}*+?|.^$", c)) {
+            free(literal);
+            return NULL;
+        }
+        // Only the characters of the regexes' alphabet are matched.
+        if(0 == c || (unsigned char) c >= (1 << _flat_dfa_offset_constant)) {
+            free(literal);
+            return NULL;
+        }
+        literal[size++] = c;
+    }
+    if(0 == size) {
+        free(literal);
+        return NULL;
+    }
+    literal[size] = '\0';
+    *length = size;
+    return literal;
+}
+
+void _token_rules_add_rule_action(TokenRules *tr, const char *name, size_t pre, size_t post, const char *raw_regex,
+    _token_rule_action_t action, size_t push_mode) {
+    _token_rule_t new_tr_instance = {name, pre, post, regex_from(raw_regex), NULL, 0, ~0UL, 0,
+        tr->current_mode, action, push_mode, 0};
+    new_tr_instance.literal = _token_rules_literal(raw_regex, &new_tr_instance.literal_length);
+    if(NULL != new_tr_instance.literal)
+        new_tr_instance.literal_id = aho_corasick_add(tr->literals, new_tr_instance.literal, new_tr_instance.literal_length);
     vector_push_back(tr->rules, new_tr_instance);
 }
 
+void _token_rules_add_rule(TokenRules *tr, const char *name, size_t pre, size_t post, const char *raw_regex) {
+    _token_rules_add_rule_action(tr, name, pre, post, raw_regex, TOKEN_RULE_NO_ACTION, 0);
+}
+
+void _token_rules_skip(TokenRules *tr, const char *rule_name) {
+    size_t size = vector_size(tr->rules);
+    for(size_t i = 0; i < size; ++i) {
+        _token_rule_t rule = vector_get(tr->rules, i);
+        if(0 != strcmp(rule_name, rule.name))
+            continue;
+        rule.skip = 1;
+        vector_set(tr->rules, i, rule);
+    }
+}
+
+// The id of the mode named `mode`, which is added if there is none.
+size_t _token_rules_mode(TokenRules *tr, const char *mode) {
+    for(size_t k = 0; k < tr->num_modes; ++k)
+        if(0 == strcmp(mode, tr->modes[k]))
+            return k;
+    tr->modes = (const char**) realloc(tr->modes, sizeof(const char*) * (tr->num_modes + 1));
+    tr->modes[tr->num_modes] = mode;
+    return tr->num_modes++;
+}
+
+size_t _token_rules_begin_mode(TokenRules *tr, const char *mode) {
+    tr->current_mode = _token_rules_mode(tr, mode);
+    return tr->current_mode;
+}
+
+// FNV-1a over a keyword and its rule.
+static inline size_t _token_rules_keyword_hash(size_t rule, const char *word, size_t length) {
+    size_t hash = 14695981039346656037UL ^ rule;
+    for(size_t i = 0; i < length; ++i) {
+        hash ^= (255UL & word[i]);
+        hash *= 1099511628211UL;
+    }
+    return hash;
+}
+
+static void _token_rules_insert_keyword(TokenRules *tr, _token_keyword_t keyword) {
+    size_t mask = tr->keywords_capacity - 1;
+    size_t slot = _token_rules_keyword_hash(keyword.rule, keyword.word, keyword.word_length) & mask;
+    while(NULL != tr->keywords[slot].name)
+        slot = (slot + 1) & mask;
+    tr->keywords[slot] = keyword;
+}
+
+void _token_rules_add_keyword(TokenRules *tr, const char *name, const char *word, const char *rule_name) {
+    size_t size = vector_size(tr->rules), rule = 0;
+    while(rule < size && 0 != strcmp(rule_name, vector_get(tr->rules, rule).name))
+        ++rule;
+    if(rule == size)
+        assert(0 == "A keyword renames the tokens of a rule that was added before it.");
+    // At most half full.
+    if(2 * (tr->num_keywords + 1) > tr->keywords_capacity) {
+        _token_keyword_t *old_keywords = tr->keywords;
+        size_t old_capacity = tr->keywords_capacity;
+        tr->keywords_capacity = (0 == old_capacity) ? 16 : 2 * old_capacity;
+        tr->keywords = (_token_keyword_t*) calloc(tr->keywords_capacity, sizeof(_token_keyword_t));
+        for(size_t i = 0; i < old_capacity; ++i)
+            if(NULL != old_keywords[i].name)
+                _token_rules_insert_keyword(tr, old_keywords[i]);
+        free(old_keywords);
+    }
+    _token_keyword_t keyword = {name, word, strlen(word), rule};
+    _token_rules_insert_keyword(tr, keyword);
+    tr->num_keywords += 1;
+    _token_rule_t keyword_rule = vector_get(tr->rules, rule);
+    keyword_rule.has_keywords = 1;
+    vector_set(tr->rules, rule, keyword_rule);
+}
+
+// The name of a token of rule `i`: the rule's, unless the token is one of its keywords.
+static inline const char* _token_rules_token_name(TokenRules *tr, size_t i, const char *ptr, size_t length) {
+    _token_rule_t rule = vector_get(tr->rules, i);
+    if(!rule.has_keywords)
+        return rule.name;
+    size_t mask = tr->keywords_capacity - 1;
+    for(size_t slot = _token_rules_keyword_hash(i, ptr, length) & mask; NULL != tr->keywords[slot].name; slot = (slot + 1) & mask) {
+        _token_keyword_t keyword = tr->keywords[slot];
+        if(i == keyword.rule && length == keyword.word_length && 0 == memcmp(ptr, keyword.word, length))
+            return keyword.name;
+    }
+    return rule.name;
+}
+
 #ifdef MULTITHREADED
-    #include "pthread.h"
-    define_vector(pthread_t);
-    void *compile_regex_thread_fn(void *regex) {
-        regex_compile((_regex_t*) regex);
-        return NULL;
+    #include "../util/thread_pool.h"
+
+    typedef struct _regex_compile_task_ {
+        _regex_t *regex;
+        _regex_parse_direction_t direction;
+    } _regex_compile_task_t;
+
+    static void _compile_regex_direction_task(void *arg) {
+        _regex_compile_task_t *task = (_regex_compile_task_t*) arg;
+        apli_trace_begin_detail("lexer", REGEX_FORWARD == task->direction ? "regex_compile_forward"
+            : "regex_compile_backward", task->regex->raw_regex);
+        _regex_compile_direction(task->regex, task->direction);
+        apli_trace_end("lexer", REGEX_FORWARD == task->direction ? "regex_compile_forward"
+            : "regex_compile_backward");
+    }
+
+    // Compiles one rule: its forward and backward DFAs are built as two more tasks.
+    static void _compile_regex_task(void *regex) {
+        _regex_t *r = (_regex_t*) regex;
+        apli_trace_begin_detail("lexer", "regex_compile", r->raw_regex);
+        ThreadPool *pool = thread_pool_default();
+        TaskGroup directions = task_group_init();
+        _regex_compile_task_t tasks[2] = {{r, REGEX_FORWARD}, {r, REGEX_BACKWARD}};
+        thread_pool_submit(pool, &directions, &_compile_regex_direction_task, &tasks[0]);
+        thread_pool_submit(pool, &directions, &_compile_regex_direction_task, &tasks[1]);
+        thread_pool_wait(pool, &directions);
+        if(NULL == r->forward_nfa || NULL == r->backward_nfa)
+            assert(0 == "The regex of a token rule is too large to compile (see `nfa_is_too_large`).");
+        r->state = REGEX_COMPILED;
+        apli_trace_end("lexer", "regex_compile");
     }
 #endif
 
 void _token_rules_compile(TokenRules *tr) {
-#ifdef MULTITHREADED
+    apli_alloc_push_tag(APLI_ALLOC_REGEX_COMPILE);
+    apli_trace_begin("lexer", "token_rules_compile");
     size_t size = vector_size(tr->rules);
-    pthread_t *threads = (pthread_t*) malloc(sizeof(pthread_t) * size);
-    for(size_t i = 0; i < size; ++i) {
-        pthread_create(&threads[i], NULL, compile_regex_thread_fn, (void*) vector_get(tr->rules, i).regex);
-    }
+#ifdef MULTITHREADED
+    ThreadPool *pool = thread_pool_default();
+    TaskGroup rules = task_group_init();
     for(size_t i = 0; i < size; ++i) {
-        pthread_join(threads[i], NULL);
+        _regex_t *r = vector_get(tr->rules, i).regex;
+        if(r->state == REGEX_RAW_LOADED)
+            thread_pool_submit(pool, &rules, &_compile_regex_task, r);
     }
-    free(threads);
+    thread_pool_wait(pool, &rules);
 #else
-    size_t size = vector_size(tr->rules);
     for(size_t i = 0; i < size; ++i) {
         _regex_t *r = vector_get(tr->rules, i).regex;
-        if(r->state == REGEX_RAW_LOADED)
-            regex_compile(r);
+        if(r->state == REGEX_RAW_LOADED) {
+            apli_trace_begin_detail("lexer", "regex_compile", r->raw_regex);
+            if(NULL == regex_compile(r))
+                assert(0 == "The regex of a token rule is too large to compile (see `nfa_is_too_large`).");
+            apli_trace_end("lexer", "regex_compile");
+        }
     }
 #endif
+    aho_corasick_build(tr->literals);
+    apli_trace_end("lexer", "token_rules_compile");
+    apli_alloc_pop_tag();
 }
 
 size_t _token_rules_matches_vector_has_matches(Vector(_matches_ptr) *matches);
+#ifndef NON_GREEDY
+static List(_token_t)* _token_rules_tokenize_modes(TokenRules *tr, const char *input);
+#endif
+
+#if defined(MULTITHREADED) && !defined(NON_GREEDY)
+/**
+ * Inputs of at least `LEXER_PARALLEL_THRESHOLD` bytes are tokenized in chunks of at least
+ * `LEXER_MIN_CHUNK_SIZE` bytes (about `LEXER_CHUNKS_PER_THREAD` per worker). Chunk boundaries
+ * are moved just past a newline, where a new token usually starts.
+ *
+ * Both passes of the tokenizer are chains whose next step only depends on a position: a
+ * regex's next match depends on where its previous match ended, and the merge's next token
+ * depends on where the previous token ended. So every chunk speculatively starts both chains
+ * at its own boundary, in parallel, and the chunks are then stitched in order: from the
+ * position the previous chunk really ended at, the chain is redone serially until it reaches
+ * a position of the speculative chain (usually right away), from where the speculative result
+ * is kept. The tokens are exactly the ones of the serial tokenizer.
+ */
+#ifndef LEXER_PARALLEL_THRESHOLD
+#define LEXER_PARALLEL_THRESHOLD (256UL << 10)
+#endif
+#ifndef LEXER_MIN_CHUNK_SIZE
+#define LEXER_MIN_CHUNK_SIZE (64UL << 10)
+#endif
+#define LEXER_CHUNKS_PER_THREAD 4
+
+typedef struct _lexer_rule_matches_ {
+    _regex_match_t *matches;        // sorted by `begin`
+    size_t size;
+    size_t capacity;
+} _lexer_rule_matches_t;
+
+typedef struct _lexer_chunk_task_ {
+    TokenRules *tr;
+    size_t rule;
+    const char *str;
+    const char *rev_str;
+    size_t str_sz;
+    size_t begin;
+    size_t end;
+    List(_regex_match_t) *matches;  // the speculative chain of the rule's regex
+    size_t exit;                    // where that chain continues after the chunk (~0: it ended)
+} _lexer_chunk_task_t;
+
+typedef struct _lexer_stitch_task_ {
+    _lexer_chunk_task_t *chunks;    // the rule's chunks, in order
+    size_t num_chunks;
+    _lexer_rule_matches_t *out;
+} _lexer_stitch_task_t;
+
+typedef struct _lexer_merge_task_ {
+    TokenRules *tr;
+    const char *input;
+    _lexer_rule_matches_t *rule_matches;
+    size_t begin;
+    size_t end;
+    List(_token_t) *tokens;         // the speculative tokens that start in the chunk
+    size_t exit;                    // the end of the last of them
+} _lexer_merge_task_t;
+
+typedef struct _lexer_literals_task_ {
+    TokenRules *tr;
+    const char *input;
+    size_t input_size;
+    List(_regex_match_t) **matches;  // by literal id
+} _lexer_literals_task_t;
+
+static inline void _lexer_rule_matches_push(_lexer_rule_matches_t *rm, _regex_match_t match) {
+    if(rm->size == rm->capacity) {
+        rm->capacity = (0 == rm->capacity) ? 64 : 2 * rm->capacity;
+        rm->matches = (_regex_match_t*) realloc(rm->matches, sizeof(_regex_match_t) * rm->capacity);
+    }
+    rm->matches[rm->size++] = match;
+}
+
+static void _lexer_chunk_task(void *arg) {
+    _lexer_chunk_task_t *task = (_lexer_chunk_task_t*) arg;
+    _token_rule_t rule = vector_get(task->tr->rules, task->rule);
+    apli_trace_begin_detail("lexer", "regex_find_chunk", rule.name);
+    task->matches = list_new(_regex_match_t);
+    task->exit = _regex_find_matches_between(rule.regex, task->str, task->rev_str, task->str_sz,
+        task->begin, task->end, task->matches);
+    apli_trace_end("lexer", "regex_find_chunk");
+}
+
+// Appends the true matches of `task`'s chunk to `out`, given the offset the chain really
+// reaches the chunk at (`entry`), and returns the offset it leaves the chunk at.
+static size_t _lexer_stitch_chunk(_lexer_chunk_task_t *task, size_t entry, _lexer_rule_matches_t *out) {
+    _regex_t *regex = vector_get(task->tr->rules, task->rule).regex;
+    List(_regex_match_t) *speculative = task->matches;
+    size_t offset = task->begin;    // the offset the speculative chain's next search starts at
+    _regex_match_t match;
+    while(~0UL != entry) {
+        while(offset < entry) {
+            if(0 == list_size(speculative)) {
+                offset = task->exit;
+                break;
+            }
+            offset = list_get_front(speculative).begin + list_get_front(speculative).length;
+            list_pop_front(speculative);
+        }
+        if(offset == entry) {
+            for(Iterator(_regex_match_t) *iter = list_get_iterator(speculative); iter_is_not_null(iter); iter = iter_next(iter))
+                _lexer_rule_matches_push(out, iter_val(iter));
+            entry = task->exit;
+            break;
+        }
+        if(entry >= task->end || entry >= task->str_sz)
+            break;
+        if(!_regex_next_match(regex, task->str, task->rev_str, task->str_sz, entry, &match)) {
+            entry = ~0UL;
+            break;
+        }
+        _lexer_rule_matches_push(out, match);
+        entry = match.begin + match.length;
+    }
+    list_free(speculative);
+    return entry;
+}
+
+// The matches of all the literals, in one pass over the whole input.
+static void _lexer_literals_task(void *arg) {
+    _lexer_literals_task_t *task = (_lexer_literals_task_t*) arg;
+    apli_trace_begin("lexer", "literals_find_all");
+    aho_corasick_find_all(task->tr->literals, task->input, task->input_size, task->matches);
+    apli_trace_end("lexer", "literals_find_all");
+}
+
+static void _lexer_stitch_task(void *arg) {
+    _lexer_stitch_task_t *task = (_lexer_stitch_task_t*) arg;
+    size_t entry = 0;
+    for(size_t k = 0; k < task->num_chunks; ++k)
+        entry = _lexer_stitch_chunk(&task->chunks[k], entry, task->out);
+}
+
+// The index of the first match of rule `i` that starts a token at or after `position`.
+static size_t _lexer_lower_bound(TokenRules *tr, _lexer_rule_matches_t *rule_matches, size_t i, size_t position) {
+    size_t pre = vector_get(tr->rules, i).pre_offset, lo = 0, hi = rule_matches[i].size;
+    while(lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if(rule_matches[i].matches[mid].begin + pre < position)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// The merge loop of `_token_rules_tokenize` over arrays: appends (at most `max_tokens` of)
+// the tokens that start in [position, end) to `tokens`, consuming the skipped matches in
+// between. `cursors` are the indices of the rules' next matches. Returns the end of the last
+// match consumed.
+static size_t _lexer_merge(TokenRules *tr, const char *input, _lexer_rule_matches_t *rule_matches,
+    size_t *cursors, size_t position, size_t end, List(_token_t) *tokens, size_t max_tokens) {
+    size_t size = vector_size(tr->rules);
+    for(size_t n = 0; n < max_tokens;) {
+        size_t min_ind = 0, min_val = ~0UL;
+        for(size_t i = 0; i < size; ++i) {
+            size_t pre = vector_get(tr->rules, i).pre_offset;
+            while(cursors[i] < rule_matches[i].size && rule_matches[i].matches[cursors[i]].begin + pre < position)
+                cursors[i] += 1;
+            if(cursors[i] < rule_matches[i].size && rule_matches[i].matches[cursors[i]].begin + pre < min_val)
+                (min_ind = i, min_val = rule_matches[i].matches[cursors[i]].begin + pre);
+        }
+        if(min_val >= end)
+            break;
+        _token_rule_t rule = vector_get(tr->rules, min_ind);
+        _regex_match_t match = rule_matches[min_ind].matches[cursors[min_ind]];
+        position = match.begin + match.length - rule.post_offset;
+        cursors[min_ind] += 1;
+        if(rule.skip)
+            continue;
+        size_t length = match.length - rule.pre_offset - rule.post_offset;
+        _token_t next_token = {_token_rules_token_name(tr, min_ind, input + min_val, length), input + min_val, length};
+        list_push_back(tokens, next_token);
+        n += 1;
+    }
+    return position;
+}
+
+static void _lexer_merge_task(void *arg) {
+    _lexer_merge_task_t *task = (_lexer_merge_task_t*) arg;
+    apli_trace_begin("lexer", "merge_chunk");
+    size_t size = vector_size(task->tr->rules);
+    size_t *cursors = (size_t*) malloc(sizeof(size_t) * size);
+    for(size_t i = 0; i < size; ++i)
+        cursors[i] = _lexer_lower_bound(task->tr, task->rule_matches, i, task->begin);
+    task->tokens = list_new(_token_t);
+    task->exit = _lexer_merge(task->tr, task->input, task->rule_matches, cursors, task->begin, task->end,
+        task->tokens, ~0UL);
+    free(cursors);
+    apli_trace_end("lexer", "merge_chunk");
+}
+
+// Appends the true tokens of `task`'s chunk to `tokens`, given the position the previous
+// chunk's tokens really end at, and returns the position the chunk's tokens end at.
+static size_t _lexer_stitch_merge(_lexer_merge_task_t *task, size_t entry, List(_token_t) *tokens) {
+    List(_token_t) *speculative = task->tokens;
+    // No token starts between a position before the chunk and the chunk's begin.
+    if(entry < task->begin)
+        entry = task->begin;
+    size_t position = task->begin;  // the position the speculative chain's next token follows
+    size_t size = vector_size(task->tr->rules);
+    size_t *cursors = (size_t*) malloc(sizeof(size_t) * size);
+    for(;;) {
+        while(position < entry) {
+            if(0 == list_size(speculative)) {
+                position = task->exit;
+                break;
+            }
+            _token_t token = list_get_front(speculative);
+            position = (size_t) (token.ptr - task->input) + token.length;
+            list_pop_front(speculative);
+        }
+        if(position == entry) {
+            list_splice_back(tokens, speculative);
+            entry = task->exit;
+            break;
+        }
+        if(entry >= task->end)
+            break;
+        for(size_t i = 0; i < size; ++i)
+            cursors[i] = _lexer_lower_bound(task->tr, task->rule_matches, i, entry);
+        // The chains meet at the end of a token (skipped matches are not in `speculative`).
+        size_t tokens_size = list_size(tokens);
+        entry = _lexer_merge(task->tr, task->input, task->rule_matches, cursors, entry, task->end, tokens, 1);
+        if(tokens_size == list_size(tokens))
+            break;
+    }
+    free(cursors);
+    list_free(speculative);
+    return entry;
+}
+
+// Runs both passes on chunks of `input`, in parallel, and stitches the chunks together.
+static List(_token_t)* _token_rules_tokenize_parallel(TokenRules *tr, const char *input, size_t input_size) {
+    ThreadPool *pool = thread_pool_default();
+    size_t num_chunks = thread_pool_size(pool) * LEXER_CHUNKS_PER_THREAD;
+    if(input_size / LEXER_MIN_CHUNK_SIZE < num_chunks)
+        num_chunks = input_size / LEXER_MIN_CHUNK_SIZE;
+    if(0 == num_chunks)
+        num_chunks = 1;
+    size_t *bounds = (size_t*) malloc(sizeof(size_t) * (num_chunks + 1));
+    bounds[0] = 0;
+    bounds[num_chunks] = input_size;
+    for(size_t k = 1; k < num_chunks; ++k) {
+        size_t bound = k * (input_size / num_chunks);
+        const char *newline = (const char*) memchr(input + bound, '\n', input_size / num_chunks);
+        bounds[k] = (NULL != newline) ? (size_t) (newline - input) + 1 : bound;
+        if(bounds[k] < bounds[k - 1])
+            bounds[k] = bounds[k - 1];
+    }
+
+    // Pass 1: every rule's matches.
+    char *rev_input = _regex_reverse_string(input, input_size);
+    size_t size = vector_size(tr->rules);
+    _lexer_chunk_task_t *chunk_tasks = (_lexer_chunk_task_t*) malloc(sizeof(_lexer_chunk_task_t) * size * num_chunks);
+    TaskGroup group = task_group_init();
+    size_t num_literals = aho_corasick_size(tr->literals);
+    _lexer_literals_task_t literals_task = {tr, input, input_size,
+        (List(_regex_match_t)**) malloc(sizeof(List(_regex_match_t)*) * (num_literals + 1))};
+    for(size_t k = 0; k < num_literals; ++k)
+        literals_task.matches[k] = list_new(_regex_match_t);
+    if(0 < num_literals)
+        thread_pool_submit(pool, &group, &_lexer_literals_task, &literals_task);
+    for(size_t i = 0; i < size; ++i) {
+        if(NULL != vector_get(tr->rules, i).literal)
+            continue;
+        for(size_t k = 0; k < num_chunks; ++k) {
+            _lexer_chunk_task_t task = {tr, i, input, rev_input, input_size, bounds[k], bounds[k + 1], NULL, 0};
+            chunk_tasks[i * num_chunks + k] = task;
+            thread_pool_submit(pool, &group, &_lexer_chunk_task, &chunk_tasks[i * num_chunks + k]);
+        }
+    }
+    thread_pool_wait(pool, &group);
+    _lexer_rule_matches_t *rule_matches = (_lexer_rule_matches_t*) calloc(size, sizeof(_lexer_rule_matches_t));
+    _lexer_stitch_task_t *stitch_tasks = (_lexer_stitch_task_t*) malloc(sizeof(_lexer_stitch_task_t) * size);
+    for(size_t i = 0; i < size; ++i) {
+        _token_rule_t rule = vector_get(tr->rules, i);
+        if(NULL != rule.literal) {
+            List(_regex_match_t) *literal_matches = literals_task.matches[rule.literal_id];
+            for(Iterator(_regex_match_t) *iter = list_get_iterator(literal_matches); iter_is_not_null(iter); iter = iter_next(iter))
+                _lexer_rule_matches_push(&rule_matches[i], iter_val(iter));
+            continue;
+        }
+        _lexer_stitch_task_t task = {&chunk_tasks[i * num_chunks], num_chunks, &rule_matches[i]};
+        stitch_tasks[i] = task;
+        thread_pool_submit(pool, &group, &_lexer_stitch_task, &stitch_tasks[i]);
+    }
+    thread_pool_wait(pool, &group);
+    for(size_t k = 0; k < num_literals; ++k)
+        list_free(literals_task.matches[k]);
+    free(literals_task.matches);
+    free(stitch_tasks);
+    free(chunk_tasks);
+    free(rev_input);
+
+    // Pass 2: the tokens.
+    _lexer_merge_task_t *merge_tasks = (_lexer_merge_task_t*) malloc(sizeof(_lexer_merge_task_t) * num_chunks);
+    for(size_t k = 0; k < num_chunks; ++k) {
+        _lexer_merge_task_t task = {tr, input, rule_matches, bounds[k], bounds[k + 1], NULL, 0};
+        merge_tasks[k] = task;
+        thread_pool_submit(pool, &group, &_lexer_merge_task, &merge_tasks[k]);
+    }
+    thread_pool_wait(pool, &group);
+    List(_token_t) *tokens = list_new(_token_t);
+    size_t entry = 0;
+    for(size_t k = 0; k < num_chunks; ++k)
+        entry = _lexer_stitch_merge(&merge_tasks[k], entry, tokens);
+
+    // Every match is either a token or discarded.
+    size_t num_matches = 0;
+    for(size_t i = 0; i < size; ++i) {
+        num_matches += rule_matches[i].size;
+        free(rule_matches[i].matches);
+    }
+    apli_stat_add(regex_matches, num_matches);
+    apli_stat_add(tokens, list_size(tokens));
+    apli_stat_add(matches_discarded, num_matches - list_size(tokens));
+    free(rule_matches);
+    free(merge_tasks);
+    free(bounds);
+    return tokens;
+}
+#endif
 
 void _token_rules_ignore_token(List(_token_t)* tokens, const char* token_name) {
     Iterator(_token_t) *iter = list_get_iterator(tokens);
@@ -71,11 +565,48 @@ void _token_rules_ignore_token(List(_token_t)* tokens, const char* token_name) {
 }
 
 List(_token_t)* _token_rules_tokenize(TokenRules *tr, const char *input) {
+    apli_alloc_push_tag(APLI_ALLOC_LEXER);
+    apli_trace_begin("lexer", "tokenize");
+#ifndef NON_GREEDY
+    if(1 < tr->num_modes) {
+        List(_token_t) *tokens = _token_rules_tokenize_modes(tr, input);
+        apli_trace_end("lexer", "tokenize");
+        apli_alloc_pop_tag();
+        return tokens;
+    }
+#endif
+#if defined(MULTITHREADED) && !defined(NON_GREEDY)
+    size_t input_size = strlen(input);
+    if(LEXER_PARALLEL_THRESHOLD <= input_size) {
+        List(_token_t) *tokens = _token_rules_tokenize_parallel(tr, input, input_size);
+        apli_trace_end("lexer", "tokenize");
+        apli_alloc_pop_tag();
+        return tokens;
+    }
+#endif
     Vector(_matches_ptr) *matches = vector_new(_matches_ptr);
     vector_resize_val(matches, vector_size(tr->rules), NULL);
     size_t size = vector_size(tr->rules);
+    // The literals' matches, in one pass.
+    size_t num_literals = aho_corasick_size(tr->literals);
+    _matches_ptr *literal_matches = (_matches_ptr*) malloc(sizeof(_matches_ptr) * (num_literals + 1));
+    for(size_t k = 0; k < num_literals; ++k)
+        literal_matches[k] = list_new(_regex_match_t);
+    if(0 < num_literals) {
+        apli_trace_begin("lexer", "literals_find_all");
+        aho_corasick_find_all(tr->literals, input, strlen(input), literal_matches);
+        apli_trace_end("lexer", "literals_find_all");
+    }
     for(size_t i = 0; i < size; ++i) {
-        vector_set(matches, i, regex_find_all(vector_get(tr->rules, i).regex, input));
+        _token_rule_t rule = vector_get(tr->rules, i);
+        if(NULL != rule.literal) {
+            vector_set(matches, i, literal_matches[rule.literal_id]);
+        } else {
+            apli_trace_begin_detail("lexer", "regex_find_all", rule.name);
+            vector_set(matches, i, regex_find_all(rule.regex, input));
+            apli_trace_end("lexer", "regex_find_all");
+        }
+        apli_stat_add(regex_matches, list_size(vector_get(matches, i)));
 #ifdef PRINT_LEXING_LOG
         printf("Finished lexing! %zu/%zu\n", i + 1, size);
 #endif
@@ -99,6 +630,7 @@ List(_token_t)* _token_rules_tokenize(TokenRules *tr, const char *input) {
                     // buf[sz] = '\0';
                     // printf("discarding: \"%s\"\n", buf);
                     // ----
+                    apli_stat_inc(matches_discarded);
                     list_pop_front(next_match);
             }
             if(0 < list_size(next_match) && min_val > list_get_front(next_match).begin + vector_get(tr->rules, i).pre_offset)
@@ -106,21 +638,389 @@ List(_token_t)* _token_rules_tokenize(TokenRules *tr, const char *input) {
         }
         if (min_val == 0UL - 1) // If the minimum value has not changed.
             break;
+        min_beginning = list_get_front(vector_get(matches, min_ind)).begin + list_get_front(vector_get(matches, min_ind)).length - vector_get(tr->rules, min_ind).post_offset;
+        if(vector_get(tr->rules, min_ind).skip) {
+            list_pop_front(vector_get(matches, min_ind));
+            continue;
+        }
         const char* token_ptr = input + list_get_front(vector_get(matches, min_ind)).begin + vector_get(tr->rules, min_ind).pre_offset;
         size_t token_length = list_get_front(vector_get(matches, min_ind)).length - vector_get(tr->rules, min_ind).pre_offset - vector_get(tr->rules, min_ind).post_offset;
         _token_t next_token = {
-            vector_get(tr->rules, min_ind).name, 
+            _token_rules_token_name(tr, min_ind, token_ptr, token_length),
             token_ptr,
             token_length
         };
-        min_beginning = list_get_front(vector_get(matches, min_ind)).begin + list_get_front(vector_get(matches, min_ind)).length - vector_get(tr->rules, min_ind).post_offset;
         list_pop_front(vector_get(matches, min_ind));
         // if(0 == list_size(tokens) || list_get_back(tokens).ptr + list_get_back(tokens).length <= next_token.ptr)
         list_push_back(tokens, next_token);
+        apli_stat_inc(tokens);
     }
+    for(size_t i = 0; i < size; ++i)
+        list_free(vector_get(matches, i));
+    vector_free(matches);
+    free(literal_matches);
+    apli_trace_end("lexer", "tokenize");
+    apli_alloc_pop_tag();
     return tokens;
 }
 
+#ifndef NON_GREEDY
+// The next match of a rule and where its regex's search continues after it.
+typedef struct _token_stream_rule_ {
+    _regex_match_t match;
+    size_t has_match;
+    size_t offset;
+} _token_stream_rule_t;
+
+struct _token_stream_ {
+    TokenRules *tr;
+    const char *input;
+    char *rev_input;
+    size_t input_size;
+    size_t position;                // the end of the last token
+    _token_stream_rule_t *rules;
+    size_t *modes;                  // the mode stack (`modes[depth - 1]` is the current mode)
+    size_t depth;
+    size_t modes_capacity;
+};
+typedef struct _token_stream_ _token_stream_t;
+
+// The first occurrence of `literal` at or after `offset`.
+static size_t _token_stream_find_literal(_token_stream_t *ts, _token_rule_t *rule, size_t offset, _regex_match_t *match) {
+    while(offset + rule->literal_length <= ts->input_size) {
+        const char *first = (const char*) memchr(ts->input + offset, rule->literal[0],
+            ts->input_size - rule->literal_length + 1 - offset);
+        if(NULL == first)
+            return 0;
+        offset = (size_t) (first - ts->input);
+        if(0 == memcmp(first, rule->literal, rule->literal_length)) {
+            match->begin = offset;
+            match->length = rule->literal_length;
+            return 1;
+        }
+        ++offset;
+    }
+    return 0;
+}
+
+// Finds rule `i`'s next match. A search from where a mode was entered (`from_offset`) does not
+// match before it.
+static inline void _token_stream_search(_token_stream_t *ts, size_t i, size_t from_offset) {
+    _token_stream_rule_t *rule = &ts->rules[i];
+    _token_rule_t token_rule = vector_get(ts->tr->rules, i);
+    if(NULL != token_rule.literal)
+        rule->has_match = _token_stream_find_literal(ts, &token_rule, rule->offset, &rule->match);
+    else if(from_offset)
+        rule->has_match = _regex_next_match_from(token_rule.regex, ts->input, ts->rev_input,
+            ts->input_size, rule->offset, &rule->match);
+    else
+        rule->has_match = _regex_next_match(token_rule.regex, ts->input, ts->rev_input,
+            ts->input_size, rule->offset, &rule->match);
+    if(rule->has_match) {
+        rule->offset = rule->match.begin + rule->match.length;
+        apli_stat_inc(regex_matches);
+    }
+}
+
+static inline void _token_stream_advance(_token_stream_t *ts, size_t i) {
+    _token_stream_search(ts, i, 0);
+}
+
+// Restarts the searches of the current mode's rules at the stream's position.
+static void _token_stream_enter_mode(_token_stream_t *ts) {
+    size_t size = vector_size(ts->tr->rules), mode = ts->modes[ts->depth - 1];
+    for(size_t i = 0; i < size; ++i) {
+        if(mode != vector_get(ts->tr->rules, i).mode)
+            continue;
+        ts->rules[i].offset = ts->position;
+        _token_stream_search(ts, i, 0 < ts->position);
+    }
+}
+
+// Pushes or pops the mode stack after a token of `rule`.
+static void _token_stream_apply_action(_token_stream_t *ts, _token_rule_t rule) {
+    if(TOKEN_RULE_PUSH_MODE == rule.action) {
+        if(ts->depth == ts->modes_capacity) {
+            ts->modes_capacity *= 2;
+            ts->modes = (size_t*) realloc(ts->modes, sizeof(size_t) * ts->modes_capacity);
+        }
+        ts->modes[ts->depth++] = rule.push_mode;
+    } else if(1 < ts->depth) {
+        ts->depth -= 1;
+    }
+    _token_stream_enter_mode(ts);
+}
+
+_token_stream_t* _token_stream_new(TokenRules *tr, const char *input) {
+    _token_stream_t *ts = (_token_stream_t*) malloc(sizeof(_token_stream_t));
+    size_t size = vector_size(tr->rules);
+    ts->tr = tr;
+    ts->input = input;
+    ts->input_size = strlen(input);
+    ts->rev_input = _regex_reverse_string(input, ts->input_size);
+    ts->position = 0;
+    ts->rules = (_token_stream_rule_t*) malloc(sizeof(_token_stream_rule_t) * size);
+    ts->modes_capacity = 8;
+    ts->modes = (size_t*) malloc(sizeof(size_t) * ts->modes_capacity);
+    ts->modes[0] = 0;
+    ts->depth = 1;
+    for(size_t i = 0; i < size; ++i)
+        ts->rules[i].has_match = 0;
+    _token_stream_enter_mode(ts);
+    return ts;
+}
+
+// The merge loop of `_token_rules_tokenize`, one token at a time, over the current mode's rules.
+size_t _token_stream_next(_token_stream_t *ts, _token_t *token) {
+    size_t size = vector_size(ts->tr->rules);
+    for(;;) {
+        size_t mode = ts->modes[ts->depth - 1], min_ind = 0, min_val = ~0UL;
+        for(size_t i = 0; i < size; ++i) {
+            if(mode != vector_get(ts->tr->rules, i).mode)
+                continue;
+            size_t pre = vector_get(ts->tr->rules, i).pre_offset;
+            while(ts->rules[i].has_match && ts->rules[i].match.begin + pre < ts->position) {
+                apli_stat_inc(matches_discarded);
+                _token_stream_advance(ts, i);
+            }
+            if(ts->rules[i].has_match && ts->rules[i].match.begin + pre < min_val)
+                (min_ind = i, min_val = ts->rules[i].match.begin + pre);
+        }
+        if(~0UL == min_val)
+            return 0;
+        _token_rule_t rule = vector_get(ts->tr->rules, min_ind);
+        _regex_match_t match = ts->rules[min_ind].match;
+        token->ptr = ts->input + min_val;
+        token->length = match.length - rule.pre_offset - rule.post_offset;
+        ts->position = match.begin + match.length - rule.post_offset;
+        if(TOKEN_RULE_NO_ACTION == rule.action)
+            _token_stream_advance(ts, min_ind);
+        else
+            _token_stream_apply_action(ts, rule);
+        if(rule.skip)
+            continue;
+        token->name = _token_rules_token_name(ts->tr, min_ind, token->ptr, token->length);
+        apli_stat_inc(tokens);
+        return 1;
+    }
+}
+
+void _token_stream_free(_token_stream_t *ts) {
+    free(ts->rev_input);
+    free(ts->rules);
+    free(ts->modes);
+    free(ts);
+}
+
+static List(_token_t)* _token_rules_tokenize_modes(TokenRules *tr, const char *input) {
+    List(_token_t) *tokens = list_new(_token_t);
+    _token_stream_t *ts = _token_stream_new(tr, input);
+    _token_t token;
+    while(_token_stream_next(ts, &token))
+        list_push_back(tokens, token);
+    _token_stream_free(ts);
+    return tokens;
+}
+#endif
+
+#ifndef NON_GREEDY
+size_t _token_rules_load_cache(TokenRules *tr, const _regex_cache_entry_t *cache, size_t cache_size) {
+    size_t size = vector_size(tr->rules), uncompiled = 0;
+    for(size_t i = 0; i < size; ++i) {
+        _token_rule_t rule = vector_get(tr->rules, i);
+        if(REGEX_RAW_LOADED != rule.regex->state)
+            continue;
+        size_t hash = regex_source_hash(rule.regex->raw_regex);
+        size_t j = 0;
+        while(j < cache_size && !(0 == strcmp(rule.name, cache[j].name) && hash == cache[j].source_hash))
+            ++j;
+        if(j < cache_size)
+            regex_load(rule.regex, cache[j].forward, cache[j].backward);
+        else
+            ++uncompiled;
+    }
+    aho_corasick_build(tr->literals);
+    return uncompiled;
+}
+
+static void _token_rules_write_c_string(FILE *fp, const char *str) {
+    fputc('"', fp);
+    for(; '\0' != *str; ++str) {
+        if('"' == *str || '\\' == *str)
+            fprintf(fp, "\\%c", *str);
+        else if('\n' == *str)
+            fprintf(fp, "\\n");
+        else if((unsigned char) *str < 0x20 || 0x7F <= (unsigned char) *str)
+            fprintf(fp, "\\%03o", (unsigned char) *str);
+        else
+            fputc(*str, fp);
+    }
+    fputc('"', fp);
+}
+
+static void _token_rules_write_flat_dfa(FILE *fp, const char *prefix, size_t index, const char *direction,
+    _flat_dfa_t *dfa) {
+    if(NULL == dfa)
+        assert(0 == "DFA caches are written from full DFAs (compile without LAZY_DFA, within REGEX_DFA_STATE_BUDGET).");
+    const char *str = flat_dfa_serialize(dfa);
+    size_t last = (dfa->state_size << _flat_dfa_offset_constant) + (sizeof(size_t) << 1);
+    // Aligned, since the header of a serialized DFA is read as `size_t`s.
+    fprintf(fp, "static const char _%s_regex_cache_%zu_%s[] __attribute__((aligned(sizeof(size_t)))) = {",
+        prefix, index, direction);
+    for(size_t i = 0; i < last; ++i)
+        fprintf(fp, "%s'\\x%02hhX'%s", (0 == i % 16) ? "\n" : "", str[i], (i != last - 1) ? ", " : "\n");
+    fprintf(fp, "};\n\n");
+    free((void*) str);
+}
+
+void _token_rules_write_cache(TokenRules *tr, FILE *fp, const char *prefix) {
+    token_rules_compile(tr);
+    size_t size = vector_size(tr->rules);
+    fprintf(fp, "// Serialized DFAs of the `%s` token rules, written by `token_rules_write_cache`\n", prefix);
+    fprintf(fp, "// (see tools/regex_cache_gen.c). Do not edit: regenerate it when a regex changes.\n\n");
+    fprintf(fp, "#ifndef _%s_REGEX_CACHE_\n#define _%s_REGEX_CACHE_\n\n", prefix, prefix);
+    for(size_t i = 0; i < size; ++i) {
+        _regex_t *regex = vector_get(tr->rules, i).regex;
+        _token_rules_write_flat_dfa(fp, prefix, i, "forward", regex->forward_dfa);
+        _token_rules_write_flat_dfa(fp, prefix, i, "backward", regex->backward_dfa);
+    }
+    fprintf(fp, "static const _regex_cache_entry_t %s_regex_cache[] = {\n", prefix);
+    for(size_t i = 0; i < size; ++i) {
+        _token_rule_t rule = vector_get(tr->rules, i);
+        fprintf(fp, "    {");
+        _token_rules_write_c_string(fp, rule.name);
+        fprintf(fp, ", ");
+        _token_rules_write_c_string(fp, rule.regex->raw_regex);
+        fprintf(fp, ", 0x%016zXUL,\n        _%s_regex_cache_%zu_forward, _%s_regex_cache_%zu_backward}%s\n",
+            regex_source_hash(rule.regex->raw_regex), prefix, i, prefix, i, (i + 1 < size) ? "," : "");
+    }
+    fprintf(fp, "};\n\n#endif\n");
+}
+
+size_t _token_rules_load_scanners(TokenRules *tr, const _regex_scanner_entry_t *scanners, size_t scanners_size) {
+    size_t size = vector_size(tr->rules), missing = 0;
+    for(size_t i = 0; i < size; ++i) {
+        _token_rule_t rule = vector_get(tr->rules, i);
+        size_t hash = regex_source_hash(rule.regex->raw_regex);
+        size_t j = 0;
+        while(j < scanners_size && !(0 == strcmp(rule.name, scanners[j].name) && hash == scanners[j].source_hash))
+            ++j;
+        if(j < scanners_size) {
+            rule.regex->forward_scanner = scanners[j].forward;
+            rule.regex->backward_scanner = scanners[j].backward;
+        } else {
+            ++missing;
+        }
+    }
+    return missing;
+}
+
+// The transition of `state` on `c` as `_flat_dfa_run_greedy` reads it (`0xFF`: none).
+static unsigned char _token_rules_flat_dfa_transition(_flat_dfa_t *dfa, size_t state, unsigned char c) {
+    size_t index = _flat_dfa_offset_into_transition(state, c);
+    return (index < (dfa->state_size << _flat_dfa_offset_constant)) ? (unsigned char) dfa->transition[index] : 0xFF;
+}
+
+// Writes `case` labels for the characters that `state` reads into `value`.
+static void _token_rules_write_cases(FILE *fp, _flat_dfa_t *dfa, size_t state, unsigned char value) {
+    for(size_t c = 0; c < 256; ++c) {
+        if(value != _token_rules_flat_dfa_transition(dfa, state, c))
+            continue;
+        size_t last = c;
+        while(last + 1 < 256 && value == _token_rules_flat_dfa_transition(dfa, state, last + 1))
+            ++last;
+        if(c == last)
+            fprintf(fp, "        case 0x%02zX:\n", c);
+        else
+            fprintf(fp, "        case 0x%02zX ... 0x%02zX:\n", c, last);
+        c = last;
+    }
+}
+
+/**
+ * Writes a function that returns what `_flat_dfa_run_greedy` returns for `dfa`. State `k` is
+ * the label `s<k>`; a transition into an accepting state goes to `a<k>`, which records the
+ * match end first. Without a transition the search restarts at `s0`, and once `s0` is
+ * reached after a match, the match is returned.
+ */
+static void _token_rules_write_scanner(FILE *fp, const char *prefix, size_t index, const char *direction,
+    _flat_dfa_t *dfa) {
+    if(NULL == dfa)
+        assert(0 == "Scanners are written from full DFAs (compile without LAZY_DFA, within REGEX_DFA_STATE_BUDGET).");
+    size_t num_states = dfa->state_size;
+    // Which labels are jumped to (`s0` always is).
+    char *targeted = (char*) calloc(2 * num_states, sizeof(char));
+    targeted[0] = 1;
+    for(size_t state = 0; state < num_states; ++state)
+        for(size_t c = 0; c < 256; ++c) {
+            unsigned char value = _token_rules_flat_dfa_transition(dfa, state, c);
+            if(0xFF != value && value < 2 * num_states)
+                targeted[value] = 1;
+        }
+
+    fprintf(fp, "static size_t _%s_regex_scanner_%zu_%s(const char *ptr, size_t ptr_sz) {\n", prefix, index, direction);
+    fprintf(fp, "    size_t offset = 0UL;\n    size_t max_right_bound = ~0UL;\n    apli_stat_inc(dfa_runs);\n");
+    if(targeted[1])
+        fprintf(fp, "    goto s0;\n");
+    for(size_t state = 0; state < num_states; ++state) {
+        if(!targeted[state << 1] && !targeted[(state << 1) | 1])
+            continue;
+        if(targeted[(state << 1) | 1])
+            fprintf(fp, "a%zu:\n    max_right_bound = offset;\n", state);
+        if(targeted[state << 1])
+            fprintf(fp, "s%zu:\n", state);
+        fprintf(fp, "    if(ptr_sz < offset)\n        goto end;\n");
+        if(0 == state)
+            fprintf(fp, "    if(~0UL != max_right_bound)\n        goto found;\n");
+        fprintf(fp, "    switch((unsigned char) ptr[offset++]) {\n");
+        for(size_t value = 0; value < 2 * num_states; ++value) {
+            size_t used = 0;
+            for(size_t c = 0; c < 256 && !used; ++c)
+                used = (value == _token_rules_flat_dfa_transition(dfa, state, c));
+            if(!used)
+                continue;
+            _token_rules_write_cases(fp, dfa, state, (unsigned char) value);
+            fprintf(fp, "            goto %c%zu;\n", (value & 1) ? 'a' : 's', value >> 1);
+        }
+        fprintf(fp, "        default:\n            apli_stat_inc(dfa_begin_resets);\n            goto s0;\n    }\n");
+    }
+    // `_flat_dfa_run_greedy` reads one more character before it returns a match found earlier.
+    fprintf(fp, "found:\n#ifdef APLI_STATS\n    switch((unsigned char) ptr[offset]) {\n");
+    for(size_t value = 0; value < 2 * num_states; ++value) {
+        size_t used = 0;
+        for(size_t c = 0; c < 256 && !used; ++c)
+            used = (value == _token_rules_flat_dfa_transition(dfa, 0, c));
+        if(used)
+            _token_rules_write_cases(fp, dfa, 0, (unsigned char) value);
+    }
+    fprintf(fp, "            break;\n        default:\n            apli_stat_inc(dfa_begin_resets);\n    }\n#endif\n");
+    fprintf(fp, "    offset += 1;\nend:\n    apli_stat_add(dfa_transitions, offset);\n    return max_right_bound;\n}\n\n");
+    free(targeted);
+}
+
+void _token_rules_write_scanners(TokenRules *tr, FILE *fp, const char *prefix) {
+    token_rules_compile(tr);
+    size_t size = vector_size(tr->rules);
+    fprintf(fp, "// Direct-coded scanners of the `%s` token rules, written by `token_rules_write_scanners`\n", prefix);
+    fprintf(fp, "// (see tools/regex_cache_gen.c). Do not edit: regenerate it when a regex changes.\n\n");
+    fprintf(fp, "#ifndef _%s_REGEX_SCANNERS_\n#define _%s_REGEX_SCANNERS_\n\n", prefix, prefix);
+    for(size_t i = 0; i < size; ++i) {
+        _regex_t *regex = vector_get(tr->rules, i).regex;
+        _token_rules_write_scanner(fp, prefix, i, "forward", regex->forward_dfa);
+        _token_rules_write_scanner(fp, prefix, i, "backward", regex->backward_dfa);
+    }
+    fprintf(fp, "static const _regex_scanner_entry_t %s_regex_scanners[] = {\n", prefix);
+    for(size_t i = 0; i < size; ++i) {
+        _token_rule_t rule = vector_get(tr->rules, i);
+        fprintf(fp, "    {");
+        _token_rules_write_c_string(fp, rule.name);
+        fprintf(fp, ", 0x%016zXUL, _%s_regex_scanner_%zu_forward, _%s_regex_scanner_%zu_backward}%s\n",
+            regex_source_hash(rule.regex->raw_regex), prefix, i, prefix, i, (i + 1 < size) ? "," : "");
+    }
+    fprintf(fp, "};\n\n#endif\n");
+}
+#endif
+
 size_t _token_rules_matches_vector_has_matches(Vector(_matches_ptr) *matches) {
     for(size_t i = 0; i < vector_size(matches); ++i)
         if(0 < list_size(vector_get(matches, i)))
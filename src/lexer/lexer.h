@@ -16,7 +16,9 @@
     #include "regex.h"
 #else
     #include "greedy_regex.h"
+    #include "regex_set.h"
 #endif
+#include "aho_corasick.h"
 
 /**
  * Token rules are defined as a mapping from a "token name" (const char*)
@@ -33,20 +35,167 @@
 #define token_rules_compile(tr)                                      (_token_rules_fns_impl._compile((tr)))
 #define token_rules_tokenize(tr, input)                              (_token_rules_fns_impl._tokenize((tr), (input)))
 
+/**
+ * Rules whose regex is a literal (no operators, only escaped characters such as `\\(`) are
+ * also added to an Aho-Corasick automaton shared by the rules, and `token_rules_tokenize` finds
+ * the matches of all of them in one pass over the input instead of one search per rule. The
+ * automaton is built once, by `token_rules_compile` or `token_rules_load_cache`. Their regexes
+ * are still compiled, cached and scanned as usual.
+ *
+ * Keywords are renamed tokens of another rule: a token of rule `rule_name` whose text is `word`
+ * is named `name` instead. They are looked up in a hash table once a token is matched, so that
+ * the keywords of a language need not be rules (or alternatives of an identifier's regex).
+ *
+ * ----- Usage -----
+ *     - token_rules_add_keyword(tr, name, word, rule_name)   -> void ( all `const char*` )
+ */
+#define token_rules_add_keyword(tr, name, word, rule_name)           (_token_rules_add_keyword((tr), (name), (word), (rule_name)))
+
+/**
+ * The matches of skipped rules (ie. whitespace or comments) are consumed like tokens, but
+ * no token is made of them: `token_rules_tokenize` and token streams leave them out.
+ *
+ * ----- Usage -----
+ *     - token_rules_skip(tr, rule_name: const char*)   -> void ( skips every rule named `rule_name` )
+ */
+#define token_rules_skip(tr, rule_name)                              (_token_rules_skip((tr), (rule_name)))
+
+/**
+ * Start conditions (as in lex) split the rules into named modes: only the rules of the mode on
+ * top of a mode stack are matched, so a context such as a string or a comment has its own
+ * small rules instead of alternatives in the rules of every other context. Rules are added to
+ * the mode of the last `token_rules_begin_mode` ("INITIAL" before any). A token of a rule
+ * added with `token_rules_add_rule_push` pushes its mode, and one of a rule added with
+ * `token_rules_add_rule_pop` pops the current mode (the initial mode is never popped). When
+ * the mode changes, the rules of the new mode search from the end of the token.
+ *
+ * Token rules with more than one mode are tokenized serially, one token at a time.
+ *
+ * ----- Usage -----
+ *     - token_rules_begin_mode(tr, mode: const char*)                      -> size_t ( the mode's id )
+ *     - token_rules_add_rule_push(tr, name, raw_regex, mode: const char*)  -> void
+ *     - token_rules_add_rule_pop(tr, name, raw_regex)                      -> void
+ */
+#define TOKEN_RULES_INITIAL_MODE                                     "INITIAL"
+#define token_rules_begin_mode(tr, mode)                             (_token_rules_begin_mode((tr), (mode)))
+#define token_rules_add_rule_push(tr, name, raw_regex, mode) \
+    (_token_rules_add_rule_action((tr), (name), 0, 0, (raw_regex), TOKEN_RULE_PUSH_MODE, _token_rules_mode((tr), (mode))))
+#define token_rules_add_rule_pop(tr, name, raw_regex) \
+    (_token_rules_add_rule_action((tr), (name), 0, 0, (raw_regex), TOKEN_RULE_POP_MODE, 0))
+
+/**
+ * A token stream produces the tokens of `token_rules_tokenize` one at a time, searching each
+ * rule's regex only as far as the next token needs, so that no token list is built.
+ *
+ * ----- Usage -----
+ *   TokenStream *ts = token_stream_new(tr, input);
+ *     - token_stream_next(ts, token: Token*)  -> size_t ( 0 at the end of the input or 1 )
+ *     - token_stream_free(ts)                 -> void
+ */
+#define TokenStream                                                  _token_stream_t
+#define token_stream_new(tr, input)                                  (_token_stream_new((tr), (input)))
+#define token_stream_next(ts, token_ptr)                             (_token_stream_next((ts), (token_ptr)))
+#define token_stream_free(ts)                                        (_token_stream_free((ts)))
+
+/**
+ * A DFA cache holds the serialized forward and backward DFAs of token rules, so that they are
+ * loaded instead of compiled at startup. `token_rules_write_cache` compiles the rules and
+ * writes the cache as a C header that defines `<prefix>_regex_cache` (tools/regex_cache_gen.c
+ * does this for a list of rules). `token_rules_load_cache` loads the entry of every rule that
+ * has one with the rule's name and the hash of its regex; the rules left uncompiled (no entry,
+ * or a regex that changed since the cache was written) are compiled by `token_rules_compile`.
+ * The serialized DFAs depend on the size and endianness of `size_t`.
+ *
+ * ----- Usage -----
+ *     - token_rules_write_cache(tr, fp: FILE*, prefix: const char*)    -> void
+ *     - token_rules_load_cache(tr, cache: const RegexCacheEntry[])     -> size_t ( # of rules left uncompiled )
+ */
+#define RegexCacheEntry                                              _regex_cache_entry_t
+#define token_rules_write_cache(tr, fp, prefix)                      (_token_rules_write_cache((tr), (fp), (prefix)))
+#define token_rules_load_cache(tr, cache)                            (_token_rules_load_cache((tr), (cache), sizeof((cache)) / sizeof((cache)[0])))
+
+struct _regex_cache_entry_ {
+    const char *name;
+    const char *raw_regex;
+    size_t source_hash;             // `regex_source_hash(raw_regex)`
+    const char *forward;
+    const char *backward;
+};
+typedef struct _regex_cache_entry_ _regex_cache_entry_t;
+
+/**
+ * Direct-coded scanners replace the table-driven `dfa_run_greedy` of token rules with
+ * generated C code: every DFA state is a label and its transitions are the cases of a
+ * `switch` that `goto` the next state, so the compiler sees (and can optimize) each state.
+ * `token_rules_write_scanners` writes the scanners of the (compiled) rules as a C header that
+ * defines `<prefix>_regex_scanners`; `token_rules_load_scanners` attaches them to the rules
+ * with the same name and regex hash. A rule keeps its DFAs (which must be compiled or loaded
+ * as usual), and rules without a scanner keep using them to tokenize.
+ *
+ * ----- Usage -----
+ *     - token_rules_write_scanners(tr, fp: FILE*, prefix: const char*)     -> void
+ *     - token_rules_load_scanners(tr, scanners: const RegexScannerEntry[])  -> size_t ( # of rules without a scanner )
+ */
+#define RegexScannerEntry                                            _regex_scanner_entry_t
+#define token_rules_write_scanners(tr, fp, prefix)                   (_token_rules_write_scanners((tr), (fp), (prefix)))
+#define token_rules_load_scanners(tr, scanners) \
+    (_token_rules_load_scanners((tr), (scanners), sizeof((scanners)) / sizeof((scanners)[0])))
+
+#ifndef NON_GREEDY
+struct _regex_scanner_entry_ {
+    const char *name;
+    size_t source_hash;             // `regex_source_hash` of the rule's regex
+    _regex_scanner_t forward;
+    _regex_scanner_t backward;
+};
+typedef struct _regex_scanner_entry_ _regex_scanner_entry_t;
+#endif
+
+enum _token_rule_action_ {
+    TOKEN_RULE_NO_ACTION,
+    TOKEN_RULE_PUSH_MODE,
+    TOKEN_RULE_POP_MODE
+};
+typedef enum _token_rule_action_ _token_rule_action_t;
+
 struct _token_rule_ {
     const char *name;
     size_t pre_offset;
     size_t post_offset;
     Regex *regex;
+    char *literal;                  // the text the regex matches if it is a literal (or NULL)
+    size_t literal_length;
+    size_t literal_id;              // the literal's id in the rules' `literals`
+    size_t has_keywords;
+    size_t mode;                    // the mode the rule is matched in
+    _token_rule_action_t action;
+    size_t push_mode;               // the mode a TOKEN_RULE_PUSH_MODE rule pushes
+    size_t skip;                    // whether its matches are left out of the tokens
 };
 typedef struct _token_rule_ _token_rule_t;
 
+struct _token_keyword_ {
+    const char *name;               // (NULL: an empty slot)
+    const char *word;
+    size_t word_length;
+    size_t rule;
+};
+typedef struct _token_keyword_ _token_keyword_t;
+
 /**
- * A `_token_rules_' struct contains a vector of 
+ * A `_token_rules_' struct contains a vector of rules, the Aho-Corasick automaton of their
+ * literals, an open-addressing table of keywords and the names of the modes.
  */
 typedef struct __token_rule_t_vector_ __token_rule_t_vector_t;
 struct _token_rules_ {
     Vector(_token_rule_t) *rules;
+    AhoCorasick *literals;
+    _token_keyword_t *keywords;
+    size_t num_keywords;
+    size_t keywords_capacity;       // a power of two
+    const char **modes;             // mode `k` is named `modes[k]` (mode 0 is the initial mode)
+    size_t num_modes;
+    size_t current_mode;            // the mode rules are added to
 };
 typedef struct _token_rules_ _token_rules_t;
 
@@ -1,6 +1,8 @@
 #ifndef NFA_OPT_H
 #define NFA_OPT_H
 
+#include <stdint.h>
+#include <string.h>
 #include "flat_dfa.c"
 #include "../util/set.h"
 #include "../util/bitset.h"
@@ -16,6 +18,8 @@
  *     - nfa_add_transition(nfa, ST, char, ST)         ->   void
  *     - nfa_add_epsilon_transition(nfa, ST, ST)     ->   void
  *     - nfa_add_alphabet(nfa, ST, ST)               ->   void
+ *     - nfa_add_class_transition(nfa, ST, chars, ST)  ->   void (chars: _nfa_char_class_t)
+ *     - nfa_add_dead_class_transition(nfa, ST, chars) ->   void (to the empty set of states)
  *     - nfa_remove_transition(nfa, ST, char, ST)      ->   size_t
  *     - nfa_remove_epsilon_transition(nfa, ST, ST)  ->   size_t
  *     - nfa_remove_alphabet(nfa, ST, ST)            ->   size_t
@@ -24,6 +28,8 @@
  *     - nfa_free(nfa)                               ->   void
  *     - nfa_to_dfa(nfa)                             ->   dfa_t*
  *       ^^^ automatically frees the nfa ^^^
+ *     - nfa_to_dfa_bounded(nfa, alphabet, max_states) ->  dfa_t* (NULL past `max_states` states)
+ *     - nfa_freeze(nfa, alphabet)                   ->   _nfa_frozen_t* (see below)
  */
 
 #define Nfa(state_type, transition_type)                        _##state_type##_##transition_type##_nfa_t
@@ -31,18 +37,167 @@
 #define nfa_add_transition(nfa, from, transition, to)           ((nfa)->fns->add_transition((nfa), (from), (transition), (to)))
 #define nfa_add_epsilon_transition(nfa, from, to)               ((nfa)->fns->add_epsilon_transition((nfa), (from), (to)))
 #define nfa_add_alphabet_transition(nfa, from, to)              ((nfa)->fns->add_alphabet_transition((nfa), (from), (to)))
+#define nfa_add_class_transition(nfa, from, chars, to)          ((nfa)->fns->add_class_transition((nfa), (from), (chars), (to)))
+#define nfa_add_dead_class_transition(nfa, from, chars)         ((nfa)->fns->add_class_transition((nfa), (from), (chars), _NFA_DEAD_STATE))
 #define nfa_remove_transition(nfa, from, transition, to)        ((nfa)->fns->remove_transition((nfa), (from), (transition), (to)))
 #define nfa_remove_epsilon_transition(nfa, from, to)            ((nfa)->fns->remove_epsilon_transition((nfa), (from), (to)))
 #define nfa_remove_alphabet_transition(nfa, from, to)           ((nfa)->fns->remove_alphabet_transition((nfa), (from), (to)))
 #define nfa_add_accept_state(nfa, state)                        ((nfa)->fns->add_accept_state((nfa), (state)))
 #define nfa_remove_accept_state(nfa, state)                     ((nfa)->fns->remove_accept_state((nfa), (state)))
 #define nfa_to_dfa(nfa, alphabet)                               ((nfa)->fns->nfa_to_dfa((nfa), (alphabet)))
+#define nfa_to_dfa_bounded(nfa, alphabet, max_states)           ((nfa)->fns->nfa_to_dfa_bounded((nfa), (alphabet), (max_states)))
 #define nfa_free(nfa)                                           ((nfa)->fns->destroy((nfa)))
 
+/**
+ * Character classes (ie. `[a-z]` or `[^"]`) are single edges labelled with a 256-bit set of
+ * characters instead of one edge per character. A class edge to `_NFA_DEAD_STATE` is a
+ * transition to the empty set of states, as left behind by `nfa_remove_transition`.
+ *
+ * ----- Char class -----
+ *   _nfa_char_class_t chars = nfa_char_class_empty();
+ *     - nfa_char_class_insert(&chars, char)          ->   void
+ *     - nfa_char_class_insert_range(&chars, lo, hi)  ->   void (inclusive, as unsigned chars)
+ *     - nfa_char_class_count(&chars, char)           ->   int
+ */
+
+#define nfa_char_class_empty()                                  (_nfa_char_class_empty())
+#define nfa_char_class_insert(chars, c)                         (_nfa_char_class_insert((chars), (unsigned char) (c)))
+#define nfa_char_class_insert_range(chars, lo, hi)              (_nfa_char_class_insert_range((chars), (unsigned char) (lo), (unsigned char) (hi)))
+#define nfa_char_class_count(chars, c)                          (_nfa_char_class_count((chars), (unsigned char) (c)))
+
+#define _NFA_CHAR_CLASS_WORDS   4
+#define _NFA_DEAD_STATE         (~0UL)
+
+typedef struct _nfa_char_class_ {
+    uint64_t bits[_NFA_CHAR_CLASS_WORDS];
+} _nfa_char_class_t;
+
+static inline _nfa_char_class_t _nfa_char_class_empty() {
+    _nfa_char_class_t chars = {{0, 0, 0, 0}};
+    return chars;
+}
+
+static inline void _nfa_char_class_insert(_nfa_char_class_t *chars, unsigned char c) {
+    chars->bits[c >> 6] |= 1ULL << (c & 63);
+}
+
+static inline void _nfa_char_class_insert_range(_nfa_char_class_t *chars, unsigned char lo, unsigned char hi) {
+    for(size_t c = lo; c <= hi; ++c)
+        _nfa_char_class_insert(chars, (unsigned char) c);
+}
+
+static inline int _nfa_char_class_count(const _nfa_char_class_t *chars, unsigned char c) {
+    return (int) ((chars->bits[c >> 6] >> (c & 63)) & 1);
+}
+
+static inline int _nfa_char_class_equals(const _nfa_char_class_t *chars1, const _nfa_char_class_t *chars2) {
+    for(size_t i = 0; i < _NFA_CHAR_CLASS_WORDS; ++i)
+        if(chars1->bits[i] != chars2->bits[i])
+            return 0;
+    return 1;
+}
+
+struct _nfa_class_edge_ {
+    size_t from;
+    _nfa_char_class_t chars;
+    size_t to;                  // `_NFA_DEAD_STATE` for the empty set of states
+};
+typedef struct _nfa_class_edge_ _nfa_class_edge_t;
+define_vector(_nfa_class_edge_t);
+
+/**
+ * A counter is a bounded repetition (ie. `[0-9]{1,1000}`) whose body is built once, instead of
+ * once per repetition. The states `begin .. end` (numbered consecutively) are the body, which is
+ * entered at `begin` with the count at 1. Leaving `end`, a run goes back to `begin` with the count
+ * incremented while it is below `max`, and goes on to `exit` once it is at least `min`. The
+ * subset construction does not know about counters: NFAs with counters are simulated (see nfa_sim.h).
+ *
+ * ----- Counter -----
+ *     - nfa_add_counter(nfa, begin, end, exit, min, max)   ->   void (max: `_NFA_UNBOUNDED` for `{min,}`)
+ *     - nfa_num_counters(nfa)                              ->   size_t
+ *
+ * The states of an NFA are numbered below `_NFA_MAX_STATES` (the size of its sets of states). A
+ * builder that would need more marks the NFA as too large instead, and its users reject it.
+ *
+ * ----- Size -----
+ *     - nfa_set_too_large(nfa)                             ->   void
+ *     - nfa_is_too_large(nfa)                              ->   size_t
+ */
+
+#define nfa_add_counter(nfa, begin, end, exit, min, max)        (_size_t_char_nfa_add_counter((nfa), (begin), (end), (exit), (min), (max)))
+#define nfa_num_counters(nfa)                                   (vector_size((nfa)->counters))
+#define nfa_set_too_large(nfa)                                  ((void) ((nfa)->too_large = 1))
+#define nfa_is_too_large(nfa)                                   ((nfa)->too_large)
+
+#define _NFA_UNBOUNDED          (~0UL)
+#define _NFA_MAX_STATES         (BITSET_SIZE << BITSET_CHUNK_SIZE)
+
+struct _nfa_counter_ {
+    size_t begin;
+    size_t end;
+    size_t exit;
+    size_t min;
+    size_t max;
+};
+typedef struct _nfa_counter_ _nfa_counter_t;
+define_vector(_nfa_counter_t);
+
+/**
+ * A frozen NFA is the read-only form that the subset construction runs over. Its states are indices
+ * into contiguous arrays: the out-edges and the epsilon edges of every state are compressed sparse
+ * rows (the edges of `s` are `edges[edge_begin[s] .. edge_begin[s + 1])`), the epsilon-closure of
+ * every state is a precomputed bitset, and every edge is labelled with a character class and already
+ * leads to the union of its targets' closures. Determinizing it needs no maps or lists.
+ *
+ * ----- Frozen NFA -----
+ *   _nfa_frozen_t *frozen = nfa_freeze(nfa, alphabet);   (the NFA is not modified)
+ *     - nfa_frozen_to_flat_dfa(frozen, max_states)  ->   _flat_dfa_t* (NULL past `max_states` states)
+ *     - nfa_frozen_free(frozen)                      ->   void
+ */
+
+#define nfa_freeze(nfa, alphabet)                               ((nfa)->fns->freeze((nfa), (alphabet)))
+#define nfa_frozen_to_flat_dfa(frozen, max_states)              (_nfa_frozen_to_flat_dfa((frozen), (max_states)))
+#define nfa_frozen_free(frozen)                                 (_nfa_frozen_free((frozen)))
+
+// A flat DFA entry is `(state << 1) | accept` in a char, and 0xFF is no transition.
+#define _NFA_FROZEN_MAX_FLAT_DFA_STATES     127
+
+typedef struct _nfa_frozen_state_set_ {
+    size_t words[BITSET_SIZE];
+} _nfa_frozen_state_set_t;
+
+static inline void _nfa_frozen_state_set_union(_nfa_frozen_state_set_t *set, const _nfa_frozen_state_set_t *other) {
+    for(size_t i = 0; i < BITSET_SIZE; ++i)
+        set->words[i] |= other->words[i];
+}
+
+typedef struct _nfa_frozen_edge_ {
+    _nfa_char_class_t chars;
+    _nfa_frozen_state_set_t to;         // the union of the targets' epsilon-closures
+} _nfa_frozen_edge_t;
+
+typedef struct _nfa_frozen_ {
+    size_t num_states;
+    size_t begin_state;
+    size_t *edge_begin;
+    _nfa_frozen_edge_t *edges;
+    size_t *epsilon_begin;
+    size_t *epsilons;
+    _nfa_frozen_state_set_t *closures;
+    _nfa_frozen_state_set_t accept;
+} _nfa_frozen_t;
+
+/* A block of the partition of the characters under the out-edges of a set of states. */
+typedef struct _nfa_frozen_block_ {
+    _nfa_char_class_t chars;
+    int has_to;
+    _nfa_frozen_state_set_t to;
+} _nfa_frozen_block_t;
+
 /**
  * Powerset transformation algorithm:
- *   (1) Construct a [st -> Set(size_t)] map for epsilon reachable states.
- *   (2) Construct a [st -> [char -> List(size_t)]] map for all possible transitions from a given state
+ *   (1) Freeze the NFA (see below), which precomputes the epsilon reachable states (ERS) of every state.
+ *   (2) Group all possible transitions from a given state into its row of the frozen NFA.
  *   (3) Run BFS from the ERS(root) and construct a DFA via the following rule:
  *     - For each transition [state_1 -> {transition, state_2}], a transition from:
  *                   ERS_1  -----transition----> ERS_2 exists, where
@@ -50,6 +205,9 @@
  *       iff state_i in ERS_1 and state_i -----transition----> state_j exists, then state_j is
  *       in ERS_2.
  *     ** Run DFS/BFS from ERS(root) to construct this! **
+ *   Every NFA edge (a character, "any character" or a class) is labelled with a set of characters,
+ *   so the out-edges of an ERS are split into the partition of the alphabet that they induce, and
+ *   each block of the partition makes one target ERS (instead of one per character).
  * 
  */
 
@@ -84,12 +242,15 @@ struct _size_t_char_nfa_fns_ {
     void (*add_transition)(struct _size_t_char_nfa_*, size_t, char, size_t);
     void (*add_epsilon_transition)(struct _size_t_char_nfa_*, size_t, size_t);
     void (*add_alphabet_transition)(struct _size_t_char_nfa_*, size_t, size_t);
+    void (*add_class_transition)(struct _size_t_char_nfa_*, size_t, _nfa_char_class_t, size_t);
     size_t (*remove_transition)(struct _size_t_char_nfa_*, size_t, char, size_t);
     size_t (*remove_epsilon_transition)(struct _size_t_char_nfa_*, size_t, size_t);
     size_t (*remove_alphabet_transition)(struct _size_t_char_nfa_*, size_t, size_t);
     void (*add_accept_state)(struct _size_t_char_nfa_*, size_t);
     size_t (*remove_accept_state)(struct _size_t_char_nfa_*, size_t);
     Dfa(size_t_set_ptr_t, char)* (*nfa_to_dfa)(struct _size_t_char_nfa_*, Vector(char)*);
+    Dfa(size_t_set_ptr_t, char)* (*nfa_to_dfa_bounded)(struct _size_t_char_nfa_*, Vector(char)*, size_t);
+    _nfa_frozen_t* (*freeze)(struct _size_t_char_nfa_*, Vector(char)*);
     void (*destroy)(struct _size_t_char_nfa_*);
 };
 
@@ -101,6 +262,9 @@ struct _size_t_char_nfa_ {
     size_t_set_ptr_t accept_states;
     size_t_set_ptr_t all_states;
     Map(size_t, size_t_set_ptr_t) *epsilon_map;
+    Vector(_nfa_class_edge_t) *class_edges;
+    Vector(_nfa_counter_t) *counters;
+    size_t too_large;
     List(size_t_set_ptr_t) *free_state_set_list;
     struct _size_t_char_nfa_fns_ *fns;
 };
@@ -148,6 +312,23 @@ void _size_t_char_nfa_add_alphabet_transition(_size_t_char_nfa_t *nfa, size_t fr
     set_insert(map_at(map_at(nfa->transition_map, from), nfa->tmp_all_transition), to);
 }
 
+/* Adds a character class transition (to the empty set of states if `to` is `_NFA_DEAD_STATE`). */
+void _size_t_char_nfa_add_class_transition(_size_t_char_nfa_t *nfa, size_t from, _nfa_char_class_t chars, size_t to) {
+    set_insert(nfa->all_states, from);
+    if(_NFA_DEAD_STATE != to)
+        set_insert(nfa->all_states, to);
+    _nfa_class_edge_t edge = {from, chars, to};
+    vector_push_back(nfa->class_edges, edge);
+}
+
+/* Adds a counter over the body `begin .. end`. */
+void _size_t_char_nfa_add_counter(_size_t_char_nfa_t *nfa, size_t begin, size_t end, size_t exit, size_t min, size_t max) {
+    assert(begin <= end && 0 < min && min <= max);
+    set_insert(nfa->all_states, begin); set_insert(nfa->all_states, end); set_insert(nfa->all_states, exit);
+    _nfa_counter_t counter = {begin, end, exit, min, max};
+    vector_push_back(nfa->counters, counter);
+}
+
 /* Removes the transition from the transition map. */
 size_t _size_t_char_nfa_remove_transition(_size_t_char_nfa_t *nfa, size_t from, char transition, size_t to) {
     nfa->tmp_transition.transition_type = NONE;
@@ -183,165 +364,350 @@ size_t _size_t_char_nfa_remove_accept_state(_size_t_char_nfa_t *nfa, size_t stat
     return set_erase(nfa->accept_states, state);
 }
 
-/* Creates the ERS map */
-void _size_t_char_fill_epsilon_reachable_map(_size_t_char_nfa_t *nfa, Map(size_t, size_t_set_ptr_t) *epsilon_reachable_map) {
-    List(size_t) *list_of_states = set_get_list(nfa->all_states);
-    Iterator(size_t) *iterator_of_states = list_get_iterator(list_of_states);
-    while(iterator_of_states != NULL) {
-        size_t root = iter_val(iterator_of_states);
-        _bitset_t* seen = bitset_new();
-        list_push_back(nfa->free_state_set_list, seen); /* this set belongs to the nfa, and should be freed with the nfa. */
-        List(size_t) *stk = list_new(size_t); list_push_back(stk, root);
-        while(0 < list_size(stk)) {
-            size_t nxt = list_get_first(stk); list_pop_front(stk);
-            if(0 == set_count(seen, nxt))
-                set_insert(seen, nxt);
-            else
-                continue;
-            if(0 == map_count(nfa->epsilon_map, nxt)) continue;
-            _bitset_t* set_of_adj = map_at(nfa->epsilon_map, nxt);
-            List(size_t) *list_of_adj = set_get_list(set_of_adj);
-            Iterator(size_t) *iter_of_adj = list_get_iterator(list_of_adj);
-            while(NULL != iter_of_adj) {
-                list_push_back(stk, iter_val(iter_of_adj));
-                iter_of_adj = iter_next(iter_of_adj);
+/* The epsilon-closures of a frozen NFA's states: a DFS over the epsilon CSR lists, as bitsets. */
+void _nfa_frozen_fill_closures(_nfa_frozen_t *frozen) {
+    size_t n = frozen->num_states;
+    size_t *stack = (size_t*) malloc(sizeof(size_t) * (n ? n : 1));
+    frozen->closures = (_nfa_frozen_state_set_t*) calloc(n ? n : 1, sizeof(_nfa_frozen_state_set_t));
+    for(size_t s = 0; s < n; ++s) {
+        size_t *closure = frozen->closures[s].words, stack_size = 0;
+        stack[stack_size++] = s;
+        closure[BITSET_INDEX(s)] |= BITSET_OFFSET(s);
+        while(0 < stack_size) {
+            size_t t = stack[--stack_size];
+            for(size_t i = frozen->epsilon_begin[t]; i < frozen->epsilon_begin[t + 1]; ++i) {
+                size_t u = frozen->epsilons[i];
+                if(!(closure[BITSET_INDEX(u)] & BITSET_OFFSET(u))) {
+                    closure[BITSET_INDEX(u)] |= BITSET_OFFSET(u);
+                    stack[stack_size++] = u;
+                }
             }
-            list_free(list_of_adj);
         }
-        map_insert(epsilon_reachable_map, root, seen);
-        list_free(stk);
-        iterator_of_states = iter_next(iterator_of_states);
     }
-    list_free(list_of_states);
+    free(stack);
 }
 
-void _size_t_char_add_all_transitions_to_nfa(_size_t_char_nfa_t *nfa, Vector(char) *alphabet_set, size_t from, _bitset_t* to) {
-    List(size_t) *to_states = set_get_list(to);
-    while(0 < list_size(to_states)) {
-        size_t alphabet_size = vector_size(alphabet_set);
-        for(size_t i = 0; i < alphabet_size; ++i) {
-            nfa_add_transition(nfa, from, vector_get(alphabet_set, i), list_get_front(to_states));
-        }
-        list_pop_front(to_states);
+/* Moves the out-edges, grouped by their source state `from[i]`, into CSR lists. */
+void _nfa_frozen_group(size_t num_states, size_t num_edges, const size_t *from, size_t *begin, size_t *order) {
+    memset(begin, 0, sizeof(size_t) * (num_states + 1));
+    for(size_t i = 0; i < num_edges; ++i)
+        ++begin[from[i] + 1];
+    for(size_t s = 0; s < num_states; ++s)
+        begin[s + 1] += begin[s];
+    size_t *next = (size_t*) malloc(sizeof(size_t) * (num_states ? num_states : 1));
+    memcpy(next, begin, sizeof(size_t) * num_states);
+    for(size_t i = 0; i < num_edges; ++i)
+        order[next[from[i]]++] = i;
+    free(next);
+}
+
+void _nfa_frozen_push_edge(size_t **from, _nfa_frozen_edge_t **edges, size_t *num_edges, size_t *capacity,
+    size_t source, const _nfa_frozen_edge_t *edge) {
+    if(*num_edges == *capacity) {
+        *capacity = (0 == *capacity) ? 16 : 2 * (*capacity);
+        *from = (size_t*) realloc(*from, sizeof(size_t) * (*capacity));
+        *edges = (_nfa_frozen_edge_t*) realloc(*edges, sizeof(_nfa_frozen_edge_t) * (*capacity));
     }
-    list_free(to_states);
+    (*from)[*num_edges] = source;
+    (*edges)[(*num_edges)++] = *edge;
 }
 
-void _size_t_char_replace_all_transitions_with_alphabet_set_transitions(_size_t_char_nfa_t *nfa, Vector(char) *alphabet_set) {
-    List(_size_t__size_t_char_nfa_transition_map_t_map_match_t) *state_transition_matches = map_get_list(nfa->transition_map);
-    while(0 < list_size(state_transition_matches)) {
-        List(__char_nfa_transition_t_size_t_set_ptr_t_map_match_t) *transition_state_matches = map_get_list(map_at(nfa->transition_map,
-            list_get_front(state_transition_matches).key));
-        while(0 < list_size(transition_state_matches)) {
-            if(ALL == list_get_front(transition_state_matches).key.transition_type)
-                _size_t_char_add_all_transitions_to_nfa(nfa, alphabet_set, list_get_front(state_transition_matches).key,
-                    list_get_front(transition_state_matches).value);
-            list_pop_front(transition_state_matches);
+/* Freezes the NFA: every character, "any character" (every character of `alphabet_set`) and class
+    transition becomes one edge labelled with its set of characters, whose target is the union of the
+    epsilon-closures of its NFA targets (empty for a transition to the empty set of states). */
+_nfa_frozen_t* _size_t_char_nfa_freeze(_size_t_char_nfa_t *nfa, Vector(char) *alphabet_set) {
+    _nfa_frozen_t *frozen = (_nfa_frozen_t*) malloc(sizeof(_nfa_frozen_t));
+    size_t num_states = nfa->begin_state + 1;
+    List(size_t) *states = set_get_list(nfa->all_states);
+    for(Iterator(size_t) *it = list_get_iterator(states); NULL != it; it = iter_next(it))
+        if(num_states <= iter_val(it))
+            num_states = iter_val(it) + 1;
+    list_free(states);
+    assert(num_states <= _NFA_MAX_STATES);
+    frozen->num_states = num_states;
+    frozen->begin_state = nfa->begin_state;
+    memset(&frozen->accept, 0, sizeof(_nfa_frozen_state_set_t));
+    for(size_t i = 0; i < BITSET_SIZE; ++i)
+        frozen->accept.words[i] = nfa->accept_states->arr[i];
+
+    // Epsilon edges.
+    size_t num_epsilons = 0, capacity = 16;
+    size_t *from = (size_t*) malloc(sizeof(size_t) * capacity), *to = (size_t*) malloc(sizeof(size_t) * capacity);
+    List(_size_t_size_t_set_ptr_t_map_match_t) *epsilon_matches = map_get_list(nfa->epsilon_map);
+    for(Iterator(_size_t_size_t_set_ptr_t_map_match_t) *it = list_get_iterator(epsilon_matches); NULL != it; it = iter_next(it)) {
+        _bitset_t *targets = iter_val(it).value;
+        for(size_t i = 0; i < targets->size; ++i) {
+            for(size_t word = targets->arr[i]; 0 != word; word &= word - 1) {
+                if(num_epsilons == capacity) {
+                    capacity *= 2;
+                    from = (size_t*) realloc(from, sizeof(size_t) * capacity);
+                    to = (size_t*) realloc(to, sizeof(size_t) * capacity);
+                }
+                from[num_epsilons] = iter_val(it).key;
+                to[num_epsilons++] = (i << BITSET_CHUNK_SIZE) + __builtin_ctzl(word);
+            }
         }
-        list_free(transition_state_matches);
-        list_pop_front(state_transition_matches);
     }
-    list_free(state_transition_matches);
+    list_free(epsilon_matches);
+    size_t *order = (size_t*) malloc(sizeof(size_t) * (num_epsilons ? num_epsilons : 1));
+    frozen->epsilon_begin = (size_t*) malloc(sizeof(size_t) * (num_states + 1));
+    _nfa_frozen_group(num_states, num_epsilons, from, frozen->epsilon_begin, order);
+    frozen->epsilons = (size_t*) malloc(sizeof(size_t) * (num_epsilons ? num_epsilons : 1));
+    for(size_t i = 0; i < num_epsilons; ++i)
+        frozen->epsilons[i] = to[order[i]];
+    free(order);
+    free(from);
+    free(to);
+    from = NULL;
+    _nfa_frozen_fill_closures(frozen);
+
+    // Character edges.
+    _nfa_char_class_t alphabet_chars = nfa_char_class_empty();
+    size_t alphabet_size = vector_size(alphabet_set);
+    for(size_t i = 0; i < alphabet_size; ++i)
+        nfa_char_class_insert(&alphabet_chars, vector_get(alphabet_set, i));
+    size_t num_edges = 0;
+    capacity = 0;
+    _nfa_frozen_edge_t *edges = NULL, edge;
+    List(_size_t__size_t_char_nfa_transition_map_t_map_match_t) *state_matches = map_get_list(nfa->transition_map);
+    for(Iterator(_size_t__size_t_char_nfa_transition_map_t_map_match_t) *state_it = list_get_iterator(state_matches);
+        NULL != state_it; state_it = iter_next(state_it)) {
+        List(__char_nfa_transition_t_size_t_set_ptr_t_map_match_t) *transition_matches = map_get_list(iter_val(state_it).value);
+        for(Iterator(__char_nfa_transition_t_size_t_set_ptr_t_map_match_t) *it = list_get_iterator(transition_matches);
+            NULL != it; it = iter_next(it)) {
+            _char_nfa_transition_t transition = iter_val(it).key;
+            _bitset_t *targets = iter_val(it).value;
+            edge.chars = alphabet_chars;
+            if(NONE == transition.transition_type) {
+                edge.chars = nfa_char_class_empty();
+                nfa_char_class_insert(&edge.chars, transition.val);
+            }
+            memset(&edge.to, 0, sizeof(_nfa_frozen_state_set_t));
+            for(size_t i = 0; i < targets->size; ++i)
+                for(size_t word = targets->arr[i]; 0 != word; word &= word - 1)
+                    _nfa_frozen_state_set_union(&edge.to, &frozen->closures[(i << BITSET_CHUNK_SIZE) + __builtin_ctzl(word)]);
+            _nfa_frozen_push_edge(&from, &edges, &num_edges, &capacity, iter_val(state_it).key, &edge);
+        }
+        list_free(transition_matches);
+    }
+    list_free(state_matches);
+    size_t num_class_edges = vector_size(nfa->class_edges);
+    for(size_t i = 0; i < num_class_edges; ++i) {
+        _nfa_class_edge_t class_edge = vector_get(nfa->class_edges, i);
+        edge.chars = class_edge.chars;
+        memset(&edge.to, 0, sizeof(_nfa_frozen_state_set_t));
+        if(_NFA_DEAD_STATE != class_edge.to)
+            edge.to = frozen->closures[class_edge.to];
+        _nfa_frozen_push_edge(&from, &edges, &num_edges, &capacity, class_edge.from, &edge);
+    }
+    order = (size_t*) malloc(sizeof(size_t) * (num_edges ? num_edges : 1));
+    frozen->edge_begin = (size_t*) malloc(sizeof(size_t) * (num_states + 1));
+    _nfa_frozen_group(num_states, num_edges, from, frozen->edge_begin, order);
+    frozen->edges = (_nfa_frozen_edge_t*) malloc(sizeof(_nfa_frozen_edge_t) * (num_edges ? num_edges : 1));
+    for(size_t i = 0; i < num_edges; ++i)
+        frozen->edges[i] = edges[order[i]];
+    free(order);
+    free(edges);
+    free(from);
+    return frozen;
 }
 
-_bitset_t* _size_t_char_compute_transition_set(_size_t_char_nfa_t *nfa, Map(size_t, size_t_set_ptr_t) *epsilon_reachable_map,
-    _bitset_t *next_set, _char_nfa_transition_t transition) {
-    _bitset_t *transition_set = bitset_new();
-    list_push_back(nfa->free_state_set_list, transition_set); /* the nfa owns this set! */
-    List(size_t) *state_list = set_get_list(next_set);
-    while(0 < list_size(state_list)) {
-        size_t current_state = list_get_front(state_list);
-        if(0 == map_count(nfa->transition_map, current_state)
-            || 0 == map_count(map_at(nfa->transition_map, current_state), transition)) {
-            list_pop_front(state_list);
-            continue;
+void _nfa_frozen_free(_nfa_frozen_t *frozen) {
+    free(frozen->edge_begin);
+    free(frozen->edges);
+    free(frozen->epsilon_begin);
+    free(frozen->epsilons);
+    free(frozen->closures);
+    free(frozen);
+}
+
+/* Splits the characters into the blocks that lead every state of `states` to the same NFA states, and
+    returns the number of blocks; a block without an edge has `has_to` 0. */
+size_t _nfa_frozen_partition(const _nfa_frozen_t *frozen, const _nfa_frozen_state_set_t *states,
+    _nfa_frozen_block_t *blocks) {
+    size_t num_blocks = 1;
+    memset(&blocks[0], 0, sizeof(_nfa_frozen_block_t));
+    for(size_t i = 0; i < _NFA_CHAR_CLASS_WORDS; ++i)
+        blocks[0].chars.bits[i] = ~0ULL;
+    for(size_t i = 0; i < BITSET_SIZE; ++i) {
+        for(size_t word = states->words[i]; 0 != word; word &= word - 1) {
+            size_t state = (i << BITSET_CHUNK_SIZE) + __builtin_ctzl(word);
+            if(frozen->num_states <= state)
+                continue;
+            for(size_t e = frozen->edge_begin[state]; e < frozen->edge_begin[state + 1]; ++e) {
+                const _nfa_frozen_edge_t *edge = &frozen->edges[e];
+                for(size_t b = 0, old_num_blocks = num_blocks; b < old_num_blocks; ++b) {
+                    _nfa_char_class_t inside, outside;
+                    uint64_t any_inside = 0, any_outside = 0;
+                    for(size_t k = 0; k < _NFA_CHAR_CLASS_WORDS; ++k) {
+                        inside.bits[k] = blocks[b].chars.bits[k] & edge->chars.bits[k];
+                        outside.bits[k] = blocks[b].chars.bits[k] & ~edge->chars.bits[k];
+                        any_inside |= inside.bits[k];
+                        any_outside |= outside.bits[k];
+                    }
+                    if(0 == any_inside)
+                        continue;
+                    if(0 != any_outside) {
+                        blocks[num_blocks] = blocks[b];
+                        blocks[num_blocks++].chars = outside;
+                        blocks[b].chars = inside;
+                    }
+                    blocks[b].has_to = 1;
+                    _nfa_frozen_state_set_union(&blocks[b].to, &edge->to);
+                }
+            }
         }
-        _bitset_t* direct_transition_states = map_at(map_at(nfa->transition_map, current_state), transition);
-        List(size_t) *dts_list = set_get_list(direct_transition_states);
-        while(0 < list_size(dts_list)) {
-            set_union(transition_set, map_at(epsilon_reachable_map, list_get_front(dts_list)));
-            list_pop_front(dts_list);
+    }
+    return num_blocks;
+}
+
+/* An open-addressing table of the sets of states found by the subset construction, numbered in the
+    order they were found. */
+typedef struct _nfa_frozen_seen_ {
+    _nfa_frozen_state_set_t *sets;
+    size_t num_sets;
+    size_t *slots;              // ~0UL for an empty slot, otherwise an index into `sets`
+    size_t mask;
+} _nfa_frozen_seen_t;
+
+static size_t _nfa_frozen_state_set_hash(const _nfa_frozen_state_set_t *set) {
+    size_t hash = 14695981039346656037UL;
+    for(size_t i = 0; i < BITSET_SIZE; ++i)
+        hash = (hash ^ set->words[i]) * 1099511628211UL;
+    return hash ^ (hash >> 29);
+}
+
+/* Returns the number of `set`, numbering it `seen->num_sets` if it was not found yet. */
+size_t _nfa_frozen_seen_insert(_nfa_frozen_seen_t *seen, const _nfa_frozen_state_set_t *set) {
+    if(2 * (seen->num_sets + 1) > seen->mask + 1) {
+        seen->mask = 2 * seen->mask + 1;
+        seen->slots = (size_t*) realloc(seen->slots, sizeof(size_t) * (seen->mask + 1));
+        memset(seen->slots, 0xFF, sizeof(size_t) * (seen->mask + 1));
+        for(size_t k = 0; k < seen->num_sets; ++k) {
+            size_t slot = _nfa_frozen_state_set_hash(&seen->sets[k]) & seen->mask;
+            while(~0UL != seen->slots[slot])
+                slot = (slot + 1) & seen->mask;
+            seen->slots[slot] = k;
         }
-        list_free(dts_list);
-        list_pop_front(state_list);
+        seen->sets = (_nfa_frozen_state_set_t*) realloc(seen->sets, sizeof(_nfa_frozen_state_set_t) * (seen->mask + 1));
     }
-    list_free(state_list);
-    return transition_set;
+    size_t slot = _nfa_frozen_state_set_hash(set) & seen->mask;
+    for(; ~0UL != seen->slots[slot]; slot = (slot + 1) & seen->mask)
+        if(0 == memcmp(&seen->sets[seen->slots[slot]], set, sizeof(_nfa_frozen_state_set_t)))
+            return seen->slots[slot];
+    seen->sets[seen->num_sets] = *set;
+    seen->slots[slot] = seen->num_sets;
+    return seen->num_sets++;
 }
 
-void _size_t_char_load_dfa_with_transition(Dfa(size_t_set_ptr_t, char) *new_dfa,
-    _bitset_t *from, _char_nfa_transition_t transition, _bitset_t *to) {
-    if(NONE == transition.transition_type) {
-        /* construct_int_char_transition_string(from, transition.val, to); TODO delete this!! */
-        dfa_add_transition(new_dfa, from, transition.val, to);
+static inline int _nfa_frozen_is_accept(const _nfa_frozen_t *frozen, const _nfa_frozen_state_set_t *set) {
+    for(size_t i = 0; i < BITSET_SIZE; ++i)
+        if(set->words[i] & frozen->accept.words[i])
+            return 1;
+    return 0;
+}
+
+/* The subset construction over a frozen NFA, straight into a flat DFA (NULL past `max_states`
+    states). The sets of states are numbered in the order they are found, so the begin set is state 0. */
+_flat_dfa_t* _nfa_frozen_to_flat_dfa(const _nfa_frozen_t *frozen, size_t max_states) {
+    assert(max_states <= _NFA_FROZEN_MAX_FLAT_DFA_STATES);
+    _nfa_frozen_seen_t seen = {NULL, 0, NULL, 0};
+    _nfa_frozen_block_t *blocks = (_nfa_frozen_block_t*) malloc(sizeof(_nfa_frozen_block_t) * 64 * _NFA_CHAR_CLASS_WORDS);
+    size_t capacity = 16;
+    char *transition = (char*) malloc(capacity << _flat_dfa_offset_constant);
+    _nfa_frozen_seen_insert(&seen, &frozen->closures[frozen->begin_state]);
+    size_t state = 0;
+    for(; state < seen.num_sets && seen.num_sets <= max_states; ++state) {
+        if(capacity <= state) {
+            capacity *= 2;
+            transition = (char*) realloc(transition, capacity << _flat_dfa_offset_constant);
+        }
+        char *row = &transition[state << _flat_dfa_offset_constant];
+        memset(row, 0xFF, 1 << _flat_dfa_offset_constant);
+        _nfa_frozen_state_set_t set = seen.sets[state];
+        size_t num_blocks = _nfa_frozen_partition(frozen, &set, blocks);
+        for(size_t b = 0; b < num_blocks; ++b) {
+            if(!blocks[b].has_to)
+                continue;
+            size_t to = _nfa_frozen_seen_insert(&seen, &blocks[b].to);
+            char entry = (char) ((to << 1) | _nfa_frozen_is_accept(frozen, &blocks[b].to));
+            // The flat DFA only has rows of the 128 ASCII characters.
+            for(size_t c = 0; c < (1 << _flat_dfa_offset_constant); ++c)
+                if(nfa_char_class_count(&blocks[b].chars, c))
+                    row[c] = entry;
+        }
     }
+    _flat_dfa_t *flat_dfa = NULL;
+    if(seen.num_sets <= max_states) {
+        flat_dfa = flat_dfa_new(seen.num_sets);
+        memcpy(flat_dfa->transition, transition, seen.num_sets << _flat_dfa_offset_constant);
+    }
+    free(transition);
+    free(blocks);
+    free(seen.sets);
+    free(seen.slots);
+    return flat_dfa;
 }
 
 void _size_t_char_update_accept_status_in_dfa(Dfa(size_t_set_ptr_t, char) *new_dfa, _size_t_char_nfa_t *nfa,
     _bitset_t *states) {
-    List(size_t) *list_of_states = set_get_list(states);
-    while(0 < list_size(list_of_states)) {
-        if(1 == set_count(nfa->accept_states, list_get_front(list_of_states))) {
+    for(size_t i = 0; i < states->size; ++i) {
+        if(states->arr[i] & nfa->accept_states->arr[i]) {
             dfa_add_accept_state(new_dfa, states);
-            list_free(list_of_states);
             return;
         }
-        list_pop_front(list_of_states);
     }
-    list_free(list_of_states);
-}
-
-void _size_t_char_process_next_state_set(Dfa(size_t_set_ptr_t, char) *new_dfa,
-    _size_t_char_nfa_t *nfa, Map(size_t, size_t_set_ptr_t) *epsilon_reachable_map, List(size_t_set_ptr_t)* state_queue,
-    _bitset_t* next_set) {
-    List(size_t) *state_list = set_get_list(next_set);
-    _size_t_char_update_accept_status_in_dfa(new_dfa, nfa, next_set);
-    Set(_char_nfa_transition_t) *seen_transitions = set_new(_char_nfa_transition_t);
-    while(0 < list_size(state_list)) {
-        if(0 == map_count(nfa->transition_map, list_get_front(state_list))) {
-            list_pop_front(state_list);
-            continue;
-        }
-        List(__char_nfa_transition_t_size_t_set_ptr_t_map_match_t) *transition_list
-            = map_get_list(map_at(nfa->transition_map, list_get_front(state_list)));
-        while(0 < list_size(transition_list)) {
-            if(1 == set_count(seen_transitions, list_get_front(transition_list).key)) {
-                list_pop_front(transition_list);
-                continue;
-            }
-            set_insert(seen_transitions, list_get_front(transition_list).key);
-            _bitset_t* transition_state = _size_t_char_compute_transition_set(nfa,
-                epsilon_reachable_map, next_set, list_get_front(transition_list).key);
-            _size_t_char_load_dfa_with_transition(new_dfa, next_set, list_get_front(transition_list).key,
-                transition_state);
-            _size_t_char_update_accept_status_in_dfa(new_dfa, nfa, transition_state);
-            list_push_back(state_queue, transition_state);
-            list_pop_front(transition_list);
-        }
-        list_pop_front(state_list);
-        list_free(transition_list);
-    }
-    set_free(seen_transitions);
-    list_free(state_list);
 }
 
-void _size_t_char_construct_dfa_with_transitions_and_epsilon_reachable_map(Dfa(size_t_set_ptr_t, char) *new_dfa,
-    _size_t_char_nfa_t *nfa, Map(size_t, size_t_set_ptr_t) *epsilon_reachable_map) {
+/* Returns a new set of NFA states, which the NFA owns. */
+_bitset_t* _size_t_char_nfa_state_set(_size_t_char_nfa_t *nfa, const _nfa_frozen_state_set_t *set) {
+    _bitset_t *states = bitset_new();
+    list_push_back(nfa->free_state_set_list, states);
+    for(size_t i = 0; i < BITSET_SIZE; ++i)
+        states->arr[i] = set->words[i];
+    return states;
+}
+
+/* Returns 0 (and stops) once more than `max_states` states were constructed. */
+int _size_t_char_construct_dfa_from_frozen_nfa(Dfa(size_t_set_ptr_t, char) *new_dfa, _size_t_char_nfa_t *nfa,
+    const _nfa_frozen_t *frozen, size_t max_states) {
+    int within_bound = 1;
+    _nfa_frozen_block_t *blocks = (_nfa_frozen_block_t*) malloc(sizeof(_nfa_frozen_block_t) * 64 * _NFA_CHAR_CLASS_WORDS);
     List(size_t_set_ptr_t) *state_queue = list_new(size_t_set_ptr_t);
     Set(size_t_set_ptr_t) *seen = set_new(size_t_set_ptr_t);
     set_set_hash(seen, &_bitset_collection_hash);
     set_set_value_equals(seen, &_bitset_equals_);
-    list_push_back(state_queue, map_at(epsilon_reachable_map, nfa->begin_state));
+    list_push_back(state_queue, new_dfa->begin_state);
     while(0 < list_size(state_queue)) {
         _bitset_t *next_set = list_get_front(state_queue);
-        if(0 == set_count(seen, next_set)) {
-            _size_t_char_process_next_state_set(new_dfa, nfa, epsilon_reachable_map, state_queue, next_set);
-            set_insert(seen, next_set);
-        }
         list_pop_front(state_queue);
+        if(1 == set_count(seen, next_set))
+            continue;
+        if(max_states <= set_size(seen)) {
+            within_bound = 0;
+            break;
+        }
+        set_insert(seen, next_set);
+        _size_t_char_update_accept_status_in_dfa(new_dfa, nfa, next_set);
+        _nfa_frozen_state_set_t set;
+        for(size_t i = 0; i < BITSET_SIZE; ++i)
+            set.words[i] = next_set->arr[i];
+        size_t num_blocks = _nfa_frozen_partition(frozen, &set, blocks);
+        for(size_t b = 0; b < num_blocks; ++b) {
+            if(!blocks[b].has_to)
+                continue;
+            _bitset_t *transition_state = _size_t_char_nfa_state_set(nfa, &blocks[b].to);
+            for(size_t k = 0; k < _NFA_CHAR_CLASS_WORDS; ++k)
+                for(uint64_t word = blocks[b].chars.bits[k]; 0 != word; word &= word - 1)
+                    dfa_add_transition(new_dfa, next_set, (char) ((k << 6) + __builtin_ctzll(word)), transition_state);
+            _size_t_char_update_accept_status_in_dfa(new_dfa, nfa, transition_state);
+            list_push_back(state_queue, transition_state);
+        }
     }
     list_free(state_queue);
     set_free(seen);
+    free(blocks);
+    return within_bound;
 }
 
 /* Hash and equals overrides for the transition. */
@@ -361,19 +727,28 @@ void _size_t_char_override_dfa_tranisition_map_equals(Dfa(size_t_set_ptr_t, char
     set_set_value_equals(new_dfa->accept_states, &_bitset_equals_);
 }
 
-/* Converts an NFA into a DFA using the powerset algorithm. This mutates the current NFA, so this algorithm can
-    only be called *once*. */
-Dfa(size_t_set_ptr_t, char)* _size_t_char_nfa_to_dfa(_size_t_char_nfa_t *nfa, Vector(char) *alphabet_set) {
-    Map(size_t, size_t_set_ptr_t) *epsilon_reachable_map = map_new(size_t, size_t_set_ptr_t);
-    _size_t_char_fill_epsilon_reachable_map(nfa, epsilon_reachable_map);
-    _size_t_char_replace_all_transitions_with_alphabet_set_transitions(nfa, alphabet_set);
-    Dfa(size_t_set_ptr_t, char) *new_dfa = dfa_new(size_t_set_ptr_t, char, map_at(epsilon_reachable_map, nfa->begin_state));
+/* Converts an NFA into a DFA using the powerset algorithm (over the frozen NFA), unless the DFA has more
+    than `max_states` states (then NULL). "Any character" transitions stand for every character of
+    `alphabet_set`. The NFA owns the DFA's sets of states, so it must outlive the DFA. */
+Dfa(size_t_set_ptr_t, char)* _size_t_char_nfa_to_dfa_bounded(_size_t_char_nfa_t *nfa, Vector(char) *alphabet_set,
+    size_t max_states) {
+    _nfa_frozen_t *frozen = _size_t_char_nfa_freeze(nfa, alphabet_set);
+    Dfa(size_t_set_ptr_t, char) *new_dfa = dfa_new(size_t_set_ptr_t, char,
+        _size_t_char_nfa_state_set(nfa, &frozen->closures[frozen->begin_state]));
     _size_t_char_override_dfa_tranisition_map_equals(new_dfa);
-    _size_t_char_construct_dfa_with_transitions_and_epsilon_reachable_map(new_dfa, nfa, epsilon_reachable_map);
-    map_free(epsilon_reachable_map);
+    int within_bound = _size_t_char_construct_dfa_from_frozen_nfa(new_dfa, nfa, frozen, max_states);
+    _nfa_frozen_free(frozen);
+    if(!within_bound) {
+        dfa_free(new_dfa);
+        return NULL;
+    }
     return new_dfa;
 }
 
+Dfa(size_t_set_ptr_t, char)* _size_t_char_nfa_to_dfa(_size_t_char_nfa_t *nfa, Vector(char) *alphabet_set) {
+    return _size_t_char_nfa_to_dfa_bounded(nfa, alphabet_set, ~0UL);
+}
+
 void _size_t_char_nfa_free(_size_t_char_nfa_t *nfa) {
     /* TODO this acharempt at freeing the nfa is INCOMPLETE! */
     /* (1) Free the transition map */
@@ -412,6 +787,8 @@ void _size_t_char_nfa_free(_size_t_char_nfa_t *nfa) {
         list_pop_front(nfa->free_state_set_list);
     }
     list_free(nfa->free_state_set_list);
+    vector_free(nfa->class_edges);
+    vector_free(nfa->counters);
     
     /* (5) Free the original nfa */
     free(nfa);
@@ -419,10 +796,11 @@ void _size_t_char_nfa_free(_size_t_char_nfa_t *nfa) {
 
 struct _size_t_char_nfa_fns_ size_t_char_nfa_fns = {
     &_size_t_char_nfa_add_transition, &_size_t_char_nfa_add_epsilon_transition,
-    &_size_t_char_nfa_add_alphabet_transition, &_size_t_char_nfa_remove_transition,
+    &_size_t_char_nfa_add_alphabet_transition, &_size_t_char_nfa_add_class_transition,
+    &_size_t_char_nfa_remove_transition,
     &_size_t_char_nfa_remove_epsilon_transition, &_size_t_char_nfa_remove_alphabet_transition,
     &_size_t_char_nfa_add_accept_state, &_size_t_char_nfa_remove_accept_state,
-    &_size_t_char_nfa_to_dfa, &_size_t_char_nfa_free
+    &_size_t_char_nfa_to_dfa, &_size_t_char_nfa_to_dfa_bounded, &_size_t_char_nfa_freeze, &_size_t_char_nfa_free
 };
 
 _size_t_char_nfa_t* _size_t_char_nfa_new(size_t begin_state) {
@@ -432,6 +810,9 @@ _size_t_char_nfa_t* _size_t_char_nfa_new(size_t begin_state) {
     new_nfa->all_states = bitset_new();
     new_nfa->accept_states = bitset_new();
     new_nfa->epsilon_map = map_new(size_t, size_t_set_ptr_t);
+    new_nfa->class_edges = vector_new(_nfa_class_edge_t);
+    new_nfa->counters = vector_new(_nfa_counter_t);
+    new_nfa->too_large = 0;
     new_nfa->free_state_set_list = list_new(size_t_set_ptr_t);
     map_insert(new_nfa->epsilon_map, begin_state, bitset_new());
     new_nfa->fns = &size_t_char_nfa_fns;
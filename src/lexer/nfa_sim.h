@@ -0,0 +1,621 @@
+#ifndef NFA_SIM_H
+#define NFA_SIM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../util/stats.h"
+
+/**
+ * Runs an NFA by simulating it (as a Thompson / Pike VM does), for regexes whose DFAs are too
+ * large to build.
+ *
+ * A run keeps the set of NFA states it is in and steps every state of the set on each
+ * character, so it is linear in the length of the input (times the size of the NFA), and
+ * building a simulator is linear in the size of the NFA (plus its epsilon-closures).
+ * `nfa_sim_run_greedy` returns what `dfa_run_greedy` returns for the full DFA of the same NFA
+ * (a set of NFA states plays the part of a DFA state), except that bytes >= 128 (outside of the
+ * regex alphabet) never have a transition.
+ *
+ * NFAs of at most 64 states are simulated bit-parallel: a set is a 64-bit word, characters with
+ * the same edges share a class, and the epsilon-closed successors of every state on every class
+ * are precomputed, so a step is one OR per state in the set. Larger NFAs step sparse sets along
+ * precomputed epsilon-closures.
+ *
+ * With counters (bounded repetitions such as `[0-9]{1,1000}`, see `nfa_add_counter`), a run is in
+ * a set of threads instead: a state and how many times its counter's body was entered, so that
+ * the body is in the NFA once whatever the bound.
+ *
+ * A simulator is only read by its runs, so runs on any number of threads can share it.
+ *
+ * ----- Usage -----
+ *   NfaSim *sim = nfa_sim_from_nfa(nfa: Nfa(size_t, char)*);   (the NFA is only read)
+ *     - nfa_sim_run_greedy(sim, ptr: const char*, ptr_sz)  -> size_t ( as `dfa_run_greedy` )
+ *     - nfa_sim_run_greedy_reverse(sim, ptr, ptr_sz)      -> size_t ( on ptr[0], ptr[-1], ..., ptr[-ptr_sz] )
+ *     - nfa_sim_is_bit_parallel(sim)                      -> size_t ( 0 or 1 )
+ *     - nfa_sim_free(sim)                                 -> void
+ */
+
+#define NfaSim                                  _nfa_sim_t
+#define nfa_sim_from_nfa(nfa)                   (_nfa_sim_from_nfa((nfa)))
+#define nfa_sim_run_greedy(sim, ptr, ptr_sz)    (_nfa_sim_run_greedy((sim), (ptr), (ptr_sz)))
+#define nfa_sim_run_greedy_reverse(sim, ptr, ptr_sz) (_nfa_sim_run_greedy_reverse((sim), (ptr), (ptr_sz)))
+#define nfa_sim_is_bit_parallel(sim)            ((size_t) (NULL != (sim)->follow))
+#define nfa_sim_free(sim)                       (_nfa_sim_free((sim)))
+
+#define NFA_SIM_ALPHABET_SIZE       128
+#define NFA_SIM_WORD_STATES         64
+// Runs on NFAs of at most this many states keep their sets on the stack.
+#define NFA_SIM_STACK_STATES        256
+// The target of an edge whose NFA transition has no states left (ie. `\n` in `[^\n]`). As in
+// `nfa_to_dfa`, taking it leads to the empty (dead) set of states rather than to no transition.
+#define NFA_SIM_DEAD_EDGE           UINT32_MAX
+
+typedef struct _nfa_sim_edge_ {
+    unsigned char lo;               // the edge is taken on [lo, hi]
+    unsigned char hi;
+    uint32_t to;
+} _nfa_sim_edge_t;
+
+typedef struct _nfa_sim_ {
+    // The edges of state `s` are `edges[edge_begin[s] .. edge_begin[s + 1])`, and its
+    // epsilon-closure (`s` included) is `closures[closure_begin[s] .. closure_begin[s + 1])`.
+    size_t num_states;
+    uint32_t begin_state;
+    size_t *edge_begin;
+    _nfa_sim_edge_t *edges;
+    size_t *closure_begin;
+    uint32_t *closures;
+    unsigned char *accept;
+    // Bit-parallel tables (`follow` is NULL above 64 states): `moves[k]` are the states with an
+    // edge on the characters of class `k`, and `follow[(k << 6) + s]` the closed set `s` moves to.
+    unsigned char char_class[NFA_SIM_ALPHABET_SIZE];
+    uint64_t *moves;
+    uint64_t *follow;
+    uint64_t begin_mask;
+    uint64_t accept_mask;
+    // Counted repetitions (see `nfa_add_counter`): `body[s]` is 1 + the counter whose body `s`
+    // is in, or 0. NFAs with counters are never bit-parallel.
+    size_t num_counters;
+    _nfa_counter_t *counters;
+    uint32_t *body;
+} _nfa_sim_t;
+
+/**
+ * Writes the states reached from `set` on `c` (epsilon-closed) that are not marked with `mark`
+ * yet to `out`, marks them, and returns how many there are. `*moved` is set if `set` has a
+ * transition on `c` at all (possibly to the dead set), and `*accept` if a state reached accepts.
+ */
+static size_t _nfa_sim_step(const _nfa_sim_t *sim, const uint32_t *set, size_t set_size, unsigned char c,
+    uint32_t *out, uint32_t *marks, uint32_t mark, int *accept, int *moved) {
+    size_t size = 0;
+    *accept = 0;
+    *moved = 0;
+    for(size_t i = 0; i < set_size; ++i) {
+        uint32_t s = set[i];
+        for(size_t e = sim->edge_begin[s]; e < sim->edge_begin[s + 1]; ++e) {
+            if(sim->edges[e].lo > c || c > sim->edges[e].hi)
+                continue;
+            *moved = 1;
+            uint32_t to = sim->edges[e].to;
+            if(NFA_SIM_DEAD_EDGE == to)
+                continue;
+            for(size_t k = sim->closure_begin[to]; k < sim->closure_begin[to + 1]; ++k) {
+                uint32_t t = sim->closures[k];
+                if(mark != marks[t]) {
+                    marks[t] = mark;
+                    out[size++] = t;
+                    *accept |= sim->accept[t];
+                }
+            }
+        }
+    }
+    return size;
+}
+
+static inline __attribute__((always_inline)) size_t _nfa_sim_run_bits(const _nfa_sim_t *sim, const char *ptr, size_t ptr_sz,
+    ptrdiff_t step) {
+    uint64_t current = sim->begin_mask;
+    size_t offset = 0UL;
+    size_t max_right_bound = ~0UL;
+    while(offset <= ptr_sz) {
+        int at_begin = (current == sim->begin_mask);
+        unsigned char c = (unsigned char) ptr[(ptrdiff_t) offset * step];
+        uint64_t from = (c < NFA_SIM_ALPHABET_SIZE) ? current & sim->moves[sim->char_class[c]] : 0;
+        int accept = 0;
+        if(0 != from) {
+            const uint64_t *follow = &sim->follow[(size_t) sim->char_class[c] << 6];
+            uint64_t next = 0;
+            for(; 0 != from; from &= from - 1)
+                next |= follow[__builtin_ctzll(from)];
+            current = next;
+            accept = (0 != (next & sim->accept_mask));
+        } else {
+            apli_stat_inc(dfa_begin_resets);
+            current = sim->begin_mask;
+        }
+        ++offset;
+        if(at_begin && max_right_bound != ~0UL) {
+            break;
+        } else if(accept) {
+            max_right_bound = offset;
+        }
+    }
+    apli_stat_add(dfa_transitions, offset);
+    return max_right_bound;
+}
+
+static inline __attribute__((always_inline)) size_t _nfa_sim_run_sets(const _nfa_sim_t *sim, const char *ptr, size_t ptr_sz,
+    ptrdiff_t step) {
+    size_t n = sim->num_states;
+    uint32_t local[3 * NFA_SIM_STACK_STATES];
+    uint32_t *buffer = (n <= NFA_SIM_STACK_STATES) ? local : (uint32_t*) malloc(sizeof(uint32_t) * 3 * n);
+    uint32_t *marks = buffer, *sets[2] = {buffer + n, buffer + 2 * n};
+    uint32_t mark = 0;
+    memset(marks, 0, sizeof(uint32_t) * n);
+    const uint32_t *begin = &sim->closures[sim->closure_begin[sim->begin_state]];
+    size_t begin_size = sim->closure_begin[sim->begin_state + 1] - sim->closure_begin[sim->begin_state];
+    const uint32_t *current = begin;
+    size_t current_size = begin_size;
+    int at_begin = 1;
+    size_t next_set = 0;            // `sets[next_set]` is never `current`
+    size_t offset = 0UL;
+    size_t max_right_bound = ~0UL;
+    while(offset <= ptr_sz) {
+        int was_at_begin = at_begin;
+        unsigned char c = (unsigned char) ptr[(ptrdiff_t) offset * step];
+        int accept = 0, moved = 0;
+        size_t size = 0;
+        if(c < NFA_SIM_ALPHABET_SIZE) {
+            if(0 == ++mark) {
+                memset(marks, 0, sizeof(uint32_t) * n);
+                mark = 1;
+            }
+            size = _nfa_sim_step(sim, current, current_size, c, sets[next_set], marks, mark, &accept, &moved);
+        }
+        if(moved) {
+            current = sets[next_set];
+            current_size = size;
+            next_set ^= 1;
+            // The set is the begin set if it has the same size and every begin state is marked.
+            at_begin = (size == begin_size);
+            for(size_t i = 0; at_begin && i < begin_size; ++i)
+                at_begin = (mark == marks[begin[i]]);
+        } else {
+            apli_stat_inc(dfa_begin_resets);
+            current = begin;
+            current_size = begin_size;
+            at_begin = 1;
+        }
+        ++offset;
+        if(was_at_begin && max_right_bound != ~0UL) {
+            break;
+        } else if(accept) {
+            max_right_bound = offset;
+        }
+    }
+    apli_stat_add(dfa_transitions, offset);
+    if(local != buffer)
+        free(buffer);
+    return max_right_bound;
+}
+
+// A set of threads: the NFA states of a run with counters, each with the count of the counter
+// whose body it is in (0 outside of bodies). The same state may be in the set with several counts.
+typedef struct _nfa_sim_thread_ {
+    uint32_t state;
+    uint32_t count;
+} _nfa_sim_thread_t;
+
+typedef struct _nfa_sim_threads_ {
+    _nfa_sim_thread_t *threads;
+    size_t *slot_of;                // the slot of every thread, to empty the table quickly
+    size_t size;
+    size_t capacity;
+    uint64_t *slots;                // open addressing of `((state << 32) | count) + 1`, 0 if empty
+    size_t slot_mask;
+} _nfa_sim_threads_t;
+
+static void _nfa_sim_threads_init(_nfa_sim_threads_t *set) {
+    set->size = 0;
+    set->capacity = 16;
+    set->threads = (_nfa_sim_thread_t*) malloc(sizeof(_nfa_sim_thread_t) * set->capacity);
+    set->slot_of = (size_t*) malloc(sizeof(size_t) * set->capacity);
+    set->slots = (uint64_t*) calloc(2 * set->capacity, sizeof(uint64_t));
+    set->slot_mask = 2 * set->capacity - 1;
+}
+
+static void _nfa_sim_threads_free(_nfa_sim_threads_t *set) {
+    free(set->threads);
+    free(set->slot_of);
+    free(set->slots);
+}
+
+static void _nfa_sim_threads_clear(_nfa_sim_threads_t *set) {
+    for(size_t i = 0; i < set->size; ++i)
+        set->slots[set->slot_of[i]] = 0;
+    set->size = 0;
+}
+
+static inline uint64_t _nfa_sim_thread_key(uint32_t state, uint32_t count) {
+    return (((uint64_t) state << 32) | count) + 1;
+}
+
+/* The slot of the thread, or the empty slot it would go to. */
+static inline size_t _nfa_sim_threads_slot(const _nfa_sim_threads_t *set, uint64_t key) {
+    size_t slot = (size_t) ((key * 0x9E3779B97F4A7C15ULL) >> 32) & set->slot_mask;
+    while(0 != set->slots[slot] && key != set->slots[slot])
+        slot = (slot + 1) & set->slot_mask;
+    return slot;
+}
+
+static inline int _nfa_sim_threads_contains(const _nfa_sim_threads_t *set, uint32_t state, uint32_t count) {
+    uint64_t key = _nfa_sim_thread_key(state, count);
+    return key == set->slots[_nfa_sim_threads_slot(set, key)];
+}
+
+/* Adds the thread; returns 0 if it was in the set already. */
+static int _nfa_sim_threads_insert(_nfa_sim_threads_t *set, uint32_t state, uint32_t count) {
+    uint64_t key = _nfa_sim_thread_key(state, count);
+    size_t slot = _nfa_sim_threads_slot(set, key);
+    if(key == set->slots[slot])
+        return 0;
+    if(set->size == set->capacity) {
+        set->capacity *= 2;
+        set->threads = (_nfa_sim_thread_t*) realloc(set->threads, sizeof(_nfa_sim_thread_t) * set->capacity);
+        set->slot_of = (size_t*) realloc(set->slot_of, sizeof(size_t) * set->capacity);
+        free(set->slots);
+        set->slots = (uint64_t*) calloc(2 * set->capacity, sizeof(uint64_t));
+        set->slot_mask = 2 * set->capacity - 1;
+        for(size_t i = 0; i < set->size; ++i) {
+            uint64_t other = _nfa_sim_thread_key(set->threads[i].state, set->threads[i].count);
+            set->slot_of[i] = _nfa_sim_threads_slot(set, other);
+            set->slots[set->slot_of[i]] = other;
+        }
+        slot = _nfa_sim_threads_slot(set, key);
+    }
+    set->slots[slot] = key;
+    set->slot_of[set->size] = slot;
+    set->threads[set->size].state = state;
+    set->threads[set->size].count = count;
+    set->size += 1;
+    return 1;
+}
+
+/* The count that `to` has when it is reached from `from` (with `count`) by an edge or an epsilon-closure. */
+static inline uint32_t _nfa_sim_count_into(const _nfa_sim_t *sim, uint32_t from, uint32_t count, uint32_t to) {
+    uint32_t body = sim->body[to];
+    return (0 == body) ? 0 : (body == sim->body[from]) ? count : 1;
+}
+
+/**
+ * Adds the epsilon-closure of the thread (`state`, `count`) to `set`, going around the counters
+ * whose bodies end in it (`stack` is scratch space). Returns whether a thread added accepts.
+ */
+static int _nfa_sim_add_closure(const _nfa_sim_t *sim, _nfa_sim_threads_t *set, _nfa_sim_threads_t *stack,
+    uint32_t state, uint32_t count) {
+    int accept = 0;
+    stack->size = 0;
+    _nfa_sim_thread_t root = {state, count};
+    stack->threads[stack->size++] = root;
+    while(0 < stack->size) {
+        root = stack->threads[--stack->size];
+        for(size_t k = sim->closure_begin[root.state]; k < sim->closure_begin[root.state + 1]; ++k) {
+            uint32_t t = sim->closures[k], n = _nfa_sim_count_into(sim, root.state, root.count, t);
+            if(!_nfa_sim_threads_insert(set, t, n))
+                continue;
+            accept |= sim->accept[t];
+            if(0 == sim->body[t] || t != sim->counters[sim->body[t] - 1].end)
+                continue;
+            const _nfa_counter_t *counter = &sim->counters[sim->body[t] - 1];
+            if(stack->size + 2 > stack->capacity) {
+                stack->capacity *= 2;
+                stack->threads = (_nfa_sim_thread_t*) realloc(stack->threads, sizeof(_nfa_sim_thread_t) * stack->capacity);
+            }
+            // Past `min`, the counts of `{min,}` are all the same.
+            if(n < counter->max) {
+                _nfa_sim_thread_t again = {(uint32_t) counter->begin,
+                    (_NFA_UNBOUNDED == counter->max && n >= counter->min) ? n : n + 1};
+                stack->threads[stack->size++] = again;
+            }
+            if(n >= counter->min) {
+                _nfa_sim_thread_t out = {(uint32_t) counter->exit, 0};
+                stack->threads[stack->size++] = out;
+            }
+        }
+    }
+    return accept;
+}
+
+/* As `_nfa_sim_run_sets`, for an NFA with counters: the run is in a set of threads. */
+static inline __attribute__((always_inline)) size_t _nfa_sim_run_counted(const _nfa_sim_t *sim, const char *ptr, size_t ptr_sz,
+    ptrdiff_t step) {
+    _nfa_sim_threads_t begin, sets[2], stack;
+    _nfa_sim_threads_init(&begin);
+    _nfa_sim_threads_init(&sets[0]);
+    _nfa_sim_threads_init(&sets[1]);
+    _nfa_sim_threads_init(&stack);
+    _nfa_sim_add_closure(sim, &begin, &stack, sim->begin_state, 0);
+    const _nfa_sim_threads_t *current = &begin;
+    int at_begin = 1;
+    size_t next_set = 0;            // `sets[next_set]` is never `current`
+    size_t offset = 0UL;
+    size_t max_right_bound = ~0UL;
+    while(offset <= ptr_sz) {
+        int was_at_begin = at_begin;
+        unsigned char c = (unsigned char) ptr[(ptrdiff_t) offset * step];
+        int accept = 0, moved = 0;
+        _nfa_sim_threads_t *next = &sets[next_set];
+        _nfa_sim_threads_clear(next);
+        for(size_t i = 0; c < NFA_SIM_ALPHABET_SIZE && i < current->size; ++i) {
+            _nfa_sim_thread_t thread = current->threads[i];
+            for(size_t e = sim->edge_begin[thread.state]; e < sim->edge_begin[thread.state + 1]; ++e) {
+                if(sim->edges[e].lo > c || c > sim->edges[e].hi)
+                    continue;
+                moved = 1;
+                uint32_t to = sim->edges[e].to;
+                if(NFA_SIM_DEAD_EDGE != to)
+                    accept |= _nfa_sim_add_closure(sim, next, &stack, to, _nfa_sim_count_into(sim, thread.state, thread.count, to));
+            }
+        }
+        if(moved) {
+            current = next;
+            next_set ^= 1;
+            at_begin = (next->size == begin.size);
+            for(size_t i = 0; at_begin && i < begin.size; ++i)
+                at_begin = _nfa_sim_threads_contains(next, begin.threads[i].state, begin.threads[i].count);
+        } else {
+            apli_stat_inc(dfa_begin_resets);
+            current = &begin;
+            at_begin = 1;
+        }
+        ++offset;
+        if(was_at_begin && max_right_bound != ~0UL) {
+            break;
+        } else if(accept) {
+            max_right_bound = offset;
+        }
+    }
+    apli_stat_add(dfa_transitions, offset);
+    _nfa_sim_threads_free(&begin);
+    _nfa_sim_threads_free(&sets[0]);
+    _nfa_sim_threads_free(&sets[1]);
+    _nfa_sim_threads_free(&stack);
+    return max_right_bound;
+}
+
+size_t _nfa_sim_run_greedy(const _nfa_sim_t *sim, const char *ptr, size_t ptr_sz) {
+    apli_stat_inc(dfa_runs);
+    apli_stat_inc(nfa_sim_runs);
+    if(0 < sim->num_counters)
+        return _nfa_sim_run_counted(sim, ptr, ptr_sz, 1);
+    return (NULL != sim->follow) ? _nfa_sim_run_bits(sim, ptr, ptr_sz, 1) : _nfa_sim_run_sets(sim, ptr, ptr_sz, 1);
+}
+
+size_t _nfa_sim_run_greedy_reverse(const _nfa_sim_t *sim, const char *ptr, size_t ptr_sz) {
+    apli_stat_inc(dfa_runs);
+    apli_stat_inc(nfa_sim_runs);
+    if(0 < sim->num_counters)
+        return _nfa_sim_run_counted(sim, ptr, ptr_sz, -1);
+    return (NULL != sim->follow) ? _nfa_sim_run_bits(sim, ptr, ptr_sz, -1) : _nfa_sim_run_sets(sim, ptr, ptr_sz, -1);
+}
+
+typedef struct _nfa_sim_nfa_edge_ {
+    uint32_t from;
+    _nfa_sim_edge_t edge;
+} _nfa_sim_nfa_edge_t;
+
+static void _nfa_sim_push_edge(_nfa_sim_nfa_edge_t **edges, size_t *size, size_t *capacity,
+    size_t from, unsigned char lo, unsigned char hi, size_t to) {
+    if(*size == *capacity) {
+        *capacity = *capacity ? 2 * *capacity : 64;
+        *edges = (_nfa_sim_nfa_edge_t*) realloc(*edges, sizeof(_nfa_sim_nfa_edge_t) * *capacity);
+    }
+    _nfa_sim_nfa_edge_t edge = {(uint32_t) from, {lo, hi, (uint32_t) to}};
+    (*edges)[(*size)++] = edge;
+}
+
+/* Groups `edges` by their source state into `begin` (of size `num_states + 1`) and `out` (or `out_to`). */
+static void _nfa_sim_group_edges(_nfa_sim_nfa_edge_t *edges, size_t num_edges, size_t num_states,
+    size_t *begin, _nfa_sim_edge_t *out, uint32_t *out_to) {
+    memset(begin, 0, sizeof(size_t) * (num_states + 1));
+    for(size_t i = 0; i < num_edges; ++i)
+        begin[edges[i].from + 1] += 1;
+    for(size_t s = 0; s < num_states; ++s)
+        begin[s + 1] += begin[s];
+    size_t *fill = (size_t*) malloc(sizeof(size_t) * (num_states + 1));
+    memcpy(fill, begin, sizeof(size_t) * (num_states + 1));
+    for(size_t i = 0; i < num_edges; ++i) {
+        size_t at = fill[edges[i].from]++;
+        if(NULL != out)
+            out[at] = edges[i].edge;
+        else
+            out_to[at] = edges[i].edge.to;
+    }
+    free(fill);
+}
+
+/* Fills `closures` with the epsilon-closure of every state, from the epsilon edges `epsilons`. */
+static void _nfa_sim_fill_closures(_nfa_sim_t *sim, const size_t *epsilon_begin, const uint32_t *epsilons) {
+    size_t n = sim->num_states, size = 0, capacity = n;
+    uint32_t *stack = (uint32_t*) malloc(sizeof(uint32_t) * n);
+    uint32_t *marks = (uint32_t*) calloc(n, sizeof(uint32_t));
+    sim->closure_begin = (size_t*) malloc(sizeof(size_t) * (n + 1));
+    sim->closures = (uint32_t*) malloc(sizeof(uint32_t) * capacity);
+    for(uint32_t s = 0; s < n; ++s) {
+        sim->closure_begin[s] = size;
+        size_t stack_size = 0;
+        stack[stack_size++] = s;
+        marks[s] = s + 1;
+        while(0 < stack_size) {
+            uint32_t t = stack[--stack_size];
+            if(size == capacity) {
+                capacity *= 2;
+                sim->closures = (uint32_t*) realloc(sim->closures, sizeof(uint32_t) * capacity);
+            }
+            sim->closures[size++] = t;
+            for(size_t i = epsilon_begin[t]; i < epsilon_begin[t + 1]; ++i) {
+                if(s + 1 != marks[epsilons[i]]) {
+                    marks[epsilons[i]] = s + 1;
+                    stack[stack_size++] = epsilons[i];
+                }
+            }
+        }
+    }
+    sim->closure_begin[n] = size;
+    free(marks);
+    free(stack);
+}
+
+/* Builds the bit-parallel tables of an NFA of at most 64 states. */
+static void _nfa_sim_fill_bit_tables(_nfa_sim_t *sim) {
+    size_t n = sim->num_states, num_classes = 0;
+    // A class begins at every character where an edge begins or after one where an edge ends.
+    unsigned char starts[NFA_SIM_ALPHABET_SIZE + 1] = {0};
+    for(size_t e = 0; e < sim->edge_begin[n]; ++e) {
+        starts[sim->edges[e].lo] = 1;
+        starts[sim->edges[e].hi + 1] = 1;
+    }
+    unsigned char representative[NFA_SIM_ALPHABET_SIZE];
+    for(size_t c = 0; c < NFA_SIM_ALPHABET_SIZE; ++c) {
+        if(0 == c || starts[c])
+            representative[num_classes++] = (unsigned char) c;
+        sim->char_class[c] = (unsigned char) (num_classes - 1);
+    }
+    uint64_t *closure_masks = (uint64_t*) calloc(n, sizeof(uint64_t));
+    for(size_t s = 0; s < n; ++s) {
+        for(size_t k = sim->closure_begin[s]; k < sim->closure_begin[s + 1]; ++k)
+            closure_masks[s] |= 1ULL << sim->closures[k];
+        if(sim->accept[s])
+            sim->accept_mask |= 1ULL << s;
+    }
+    sim->begin_mask = closure_masks[sim->begin_state];
+    sim->moves = (uint64_t*) calloc(num_classes, sizeof(uint64_t));
+    sim->follow = (uint64_t*) calloc(num_classes << 6, sizeof(uint64_t));
+    for(size_t k = 0; k < num_classes; ++k) {
+        unsigned char c = representative[k];
+        for(size_t s = 0; s < n; ++s) {
+            for(size_t e = sim->edge_begin[s]; e < sim->edge_begin[s + 1]; ++e) {
+                if(sim->edges[e].lo > c || c > sim->edges[e].hi)
+                    continue;
+                sim->moves[k] |= 1ULL << s;
+                if(NFA_SIM_DEAD_EDGE != sim->edges[e].to)
+                    sim->follow[(k << 6) + s] |= closure_masks[sim->edges[e].to];
+            }
+        }
+    }
+    free(closure_masks);
+}
+
+_nfa_sim_t* _nfa_sim_from_nfa(Nfa(size_t, char) *nfa) {
+    _nfa_sim_t *sim = (_nfa_sim_t*) malloc(sizeof(_nfa_sim_t));
+    size_t num_states = nfa->begin_state + 1;
+    List(size_t) *states = set_get_list(nfa->all_states);
+    for(Iterator(size_t) *it = list_get_iterator(states); NULL != it; it = iter_next(it))
+        if(num_states <= iter_val(it))
+            num_states = iter_val(it) + 1;
+    list_free(states);
+    sim->num_states = num_states;
+    sim->begin_state = (uint32_t) nfa->begin_state;
+
+    // Character (and "any character") edges.
+    _nfa_sim_nfa_edge_t *edges = NULL;
+    size_t num_edges = 0, capacity = 0;
+    List(_size_t__size_t_char_nfa_transition_map_t_map_match_t) *from_matches = map_get_list(nfa->transition_map);
+    for(Iterator(_size_t__size_t_char_nfa_transition_map_t_map_match_t) *from = list_get_iterator(from_matches);
+        NULL != from; from = iter_next(from)) {
+        List(__char_nfa_transition_t_size_t_set_ptr_t_map_match_t) *transition_matches = map_get_list(iter_val(from).value);
+        for(Iterator(__char_nfa_transition_t_size_t_set_ptr_t_map_match_t) *transition = list_get_iterator(transition_matches);
+            NULL != transition; transition = iter_next(transition)) {
+            _char_nfa_transition_t key = iter_val(transition).key;
+            unsigned char lo = (ALL == key.transition_type) ? 0 : (unsigned char) key.val;
+            unsigned char hi = (ALL == key.transition_type) ? NFA_SIM_ALPHABET_SIZE - 1 : (unsigned char) key.val;
+            if(NFA_SIM_ALPHABET_SIZE <= lo)
+                continue;
+            List(size_t) *to = set_get_list(iter_val(transition).value);
+            if(0 == list_size(to))
+                _nfa_sim_push_edge(&edges, &num_edges, &capacity, iter_val(from).key, lo, hi, NFA_SIM_DEAD_EDGE);
+            for(Iterator(size_t) *it = list_get_iterator(to); NULL != it; it = iter_next(it))
+                _nfa_sim_push_edge(&edges, &num_edges, &capacity, iter_val(from).key, lo, hi, iter_val(it));
+            list_free(to);
+        }
+        list_free(transition_matches);
+    }
+    list_free(from_matches);
+    // Class edges, one per run of consecutive characters.
+    size_t num_class_edges = vector_size(nfa->class_edges);
+    for(size_t i = 0; i < num_class_edges; ++i) {
+        _nfa_class_edge_t class_edge = vector_get(nfa->class_edges, i);
+        uint32_t to = (_NFA_DEAD_STATE == class_edge.to) ? NFA_SIM_DEAD_EDGE : (uint32_t) class_edge.to;
+        for(size_t lo = 0; lo < NFA_SIM_ALPHABET_SIZE; ++lo) {
+            if(!nfa_char_class_count(&class_edge.chars, lo))
+                continue;
+            size_t hi = lo;
+            while(hi + 1 < NFA_SIM_ALPHABET_SIZE && nfa_char_class_count(&class_edge.chars, hi + 1))
+                ++hi;
+            _nfa_sim_push_edge(&edges, &num_edges, &capacity, class_edge.from, (unsigned char) lo, (unsigned char) hi, to);
+            lo = hi;
+        }
+    }
+    sim->edge_begin = (size_t*) malloc(sizeof(size_t) * (num_states + 1));
+    sim->edges = (_nfa_sim_edge_t*) malloc(sizeof(_nfa_sim_edge_t) * (num_edges ? num_edges : 1));
+    _nfa_sim_group_edges(edges, num_edges, num_states, sim->edge_begin, sim->edges, NULL);
+
+    // Epsilon edges, which only serve to compute the closures.
+    num_edges = 0;
+    List(_size_t_size_t_set_ptr_t_map_match_t) *epsilon_matches = map_get_list(nfa->epsilon_map);
+    for(Iterator(_size_t_size_t_set_ptr_t_map_match_t) *from = list_get_iterator(epsilon_matches);
+        NULL != from; from = iter_next(from)) {
+        List(size_t) *to = set_get_list(iter_val(from).value);
+        for(Iterator(size_t) *it = list_get_iterator(to); NULL != it; it = iter_next(it))
+            _nfa_sim_push_edge(&edges, &num_edges, &capacity, iter_val(from).key, 0, 0, iter_val(it));
+        list_free(to);
+    }
+    list_free(epsilon_matches);
+    size_t *epsilon_begin = (size_t*) malloc(sizeof(size_t) * (num_states + 1));
+    uint32_t *epsilons = (uint32_t*) malloc(sizeof(uint32_t) * (num_edges ? num_edges : 1));
+    _nfa_sim_group_edges(edges, num_edges, num_states, epsilon_begin, NULL, epsilons);
+    free(edges);
+    _nfa_sim_fill_closures(sim, epsilon_begin, epsilons);
+    free(epsilon_begin);
+    free(epsilons);
+
+    sim->accept = (unsigned char*) calloc(num_states, sizeof(unsigned char));
+    List(size_t) *accept_states = set_get_list(nfa->accept_states);
+    for(Iterator(size_t) *it = list_get_iterator(accept_states); NULL != it; it = iter_next(it))
+        sim->accept[iter_val(it)] = 1;
+    list_free(accept_states);
+
+    sim->num_counters = vector_size(nfa->counters);
+    sim->counters = (_nfa_counter_t*) malloc(sizeof(_nfa_counter_t) * (sim->num_counters ? sim->num_counters : 1));
+    sim->body = (uint32_t*) calloc(num_states, sizeof(uint32_t));
+    for(size_t k = 0; k < sim->num_counters; ++k) {
+        sim->counters[k] = vector_get(nfa->counters, k);
+        for(size_t s = sim->counters[k].begin; s <= sim->counters[k].end; ++s)
+            sim->body[s] = (uint32_t) k + 1;
+    }
+
+    sim->moves = NULL;
+    sim->follow = NULL;
+    sim->begin_mask = 0;
+    sim->accept_mask = 0;
+    if(num_states <= NFA_SIM_WORD_STATES && 0 == sim->num_counters)
+        _nfa_sim_fill_bit_tables(sim);
+    return sim;
+}
+
+void _nfa_sim_free(_nfa_sim_t *sim) {
+    free(sim->edge_begin);
+    free(sim->edges);
+    free(sim->closure_begin);
+    free(sim->closures);
+    free(sim->accept);
+    free(sim->moves);
+    free(sim->follow);
+    free(sim->counters);
+    free(sim->body);
+    free(sim);
+}
+
+#endif
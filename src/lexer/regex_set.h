@@ -0,0 +1,552 @@
+#ifndef REGEX_SET_H
+#define REGEX_SET_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "greedy_regex.h"
+
+/**
+ * A regex set matches many regexes in one pass over an input, instead of one run per regex.
+ *
+ * Every regex is parsed into its own NFA, and the set's DFA is the subset construction over all
+ * of them at once (the product of their DFAs): a state is a set of states of every NFA, and
+ * records which regexes accept in it. Two automata share that DFA. The unanchored one starts
+ * every regex again after each character, so one scan tells which regexes match somewhere in
+ * the input. The anchored one starts them once, and finds the longest match that begins at a
+ * position; of the regexes that match that much, the one added first wins (as the rules of
+ * `TokenRules` do). `^` and `$` anchor a regex to the ends of the input. `regex_set_find` scans
+ * with the unanchored automaton to the end of the first match, simulates the NFAs (from every
+ * position before it at once) to find where the leftmost match begins, and runs the anchored
+ * automaton from there: each of the three passes reads the input once.
+ *
+ * `regex_set_compile` builds the DFA up front. Past `REGEX_SET_STATE_BUDGET` states it gives
+ * up, and every run determinizes the states it reaches into a DFA of its own instead (which it
+ * empties when it is full). A compiled set is only read by its runs, so threads can share it.
+ * Matches are non-empty, as in `regex_find_all`, but for `regex_set_matches`. The runs step the
+ * NFAs without counters, so a set does not hold a regex with a repetition that `Regex` would count
+ * (one with more than `REGEX_REPEAT_COPY_BUDGET` NFA states once copied), or one that `Regex`
+ * would not compile: `regex_set_add` rejects them.
+ *
+ * ----- Usage -----
+ *   RegexSet *set = regex_set_new();
+ *     - regex_set_add(set, raw_regex: const char*)         -> size_t ( the regex's id: 0, 1, ..., or
+ *                                                                      REGEX_SET_ERROR if it counts a repetition,
+ *                                                                      or is too large )
+ *     - regex_set_compile(set)                             -> RegexSet*
+ *     - regex_set_size(set)                                -> size_t ( # of regexes )
+ *     - regex_set_matches(set, str: const char*, len)      -> uint64_t ( bit `id` is set if regex `id`
+ *                                                                        matches in str[0 .. len) )
+ *     - regex_set_match_at(set, str, len, offset, &match)  -> size_t ( the id of the regex with the
+ *                                                                      longest match at `offset`, or ~0 )
+ *     - regex_set_find(set, str, len, offset, &match)      -> size_t ( as `regex_set_match_at`, at the
+ *                                                                      first position >= `offset` with a match )
+ *     - regex_set_free(set)                                -> void
+ */
+
+#define RegexSet                                            _regex_set_t
+#define regex_set_new()                                     (_regex_set_new())
+#define regex_set_add(set, raw_regex)                       (_regex_set_add((set), (raw_regex)))
+#define regex_set_compile(set)                              (_regex_set_compile((set)))
+#define regex_set_size(set)                                 ((set)->num_regexes)
+#define regex_set_matches(set, str, len)                    (_regex_set_matches((set), (str), (len)))
+#define regex_set_match_at(set, str, len, offset, match)    (_regex_set_match_at((set), (str), (len), (offset), (match)))
+#define regex_set_find(set, str, len, offset, match)        (_regex_set_find((set), (str), (len), (offset), (match)))
+#define regex_set_free(set)                                 (_regex_set_free((set)))
+
+// The accepting regexes of a state are a 64-bit mask.
+#define REGEX_SET_MAX_REGEXES       64
+#ifndef REGEX_SET_STATE_BUDGET
+#define REGEX_SET_STATE_BUDGET      1024
+#endif
+// Bytes >= 128 are outside of the regex alphabet (no NFA state moves on them), but they have
+// their columns, as the unanchored automaton restarts on them.
+#define REGEX_SET_ALPHABET_SIZE     256
+#define REGEX_SET_UNKNOWN           UINT32_MAX
+// The id `regex_set_add` returns for a regex the set cannot hold.
+#define REGEX_SET_ERROR             (~0UL)
+
+// The begin states of the unanchored and of the anchored automaton, at the beginning of the
+// input (where `^` regexes may match) and after it.
+typedef enum {
+    REGEX_SET_UNANCHORED, REGEX_SET_UNANCHORED_INSIDE, REGEX_SET_AT_START, REGEX_SET_INSIDE, REGEX_SET_NUM_BEGINS
+} _regex_set_begin_t;
+
+typedef struct _regex_set_dfa_ {
+    size_t num_states;
+    size_t capacity;
+    uint32_t *next;                 // [state * 256 + c]: the transition (REGEX_SET_UNKNOWN until computed)
+    uint64_t *accept;               // the regexes that accept in the state
+    unsigned char *restarts;        // the state belongs to the unanchored automaton
+    // The NFA states of state `s` (sorted, numbered across the NFAs) are
+    // `sets[set_begin[s] .. set_begin[s + 1])`.
+    size_t *set_begin;
+    uint32_t *sets;
+    size_t sets_capacity;
+    int32_t *table;                 // open addressing from a set's hash to its state, -1 if empty
+    size_t table_mask;
+    uint32_t begin[REGEX_SET_NUM_BEGINS];   // REGEX_SET_UNKNOWN until interned
+    // Scratch space for computing a transition.
+    uint32_t *scratch;
+    uint32_t *marks;
+    uint32_t mark;
+} _regex_set_dfa_t;
+
+typedef struct _regex_set_ {
+    size_t num_regexes;
+    char **raw_regexes;
+    _nfa_sim_t **sims;
+    uint64_t left_rooted;
+    uint64_t right_rooted;
+    uint64_t nullable;              // the regexes that match the empty string
+    // The states of regex `k`'s NFA are numbered from `offsets[k]` to `offsets[k + 1]`, and
+    // `owners` maps them back to `k`.
+    uint32_t *offsets;
+    uint32_t *owners;
+    size_t num_nfa_states;
+    _regex_set_dfa_t *dfa;          // NULL before compiling or past the state budget
+} _regex_set_t;
+
+_regex_set_t* _regex_set_new() {
+    return (_regex_set_t*) calloc(1, sizeof(_regex_set_t));
+}
+
+size_t _regex_set_add(_regex_set_t *set, const char *raw_regex) {
+    assert(NULL == set->offsets && "A regex set cannot be added to once it is compiled.");
+    assert(set->num_regexes < REGEX_SET_MAX_REGEXES);
+    Vector(char) *alphabet = vector_new(char);
+    for(int i = 0; i < (1 << _flat_dfa_offset_constant); ++i)
+        vector_push_back(alphabet, i);
+    // As `_regex_compile_direction` builds a forward NFA.
+    Nfa(size_t, char) *nfa = nfa_new(size_t, char, 0);
+    size_t size = strlen(raw_regex);
+    size_t end = _regex_parse(alphabet, nfa, 0, raw_regex, size, REGEX_FORWARD);
+    nfa_add_accept_state(nfa, end);
+    vector_free(alphabet);
+    // The runs of a set step its NFAs without counters.
+    if(0 < nfa_num_counters(nfa) || nfa_is_too_large(nfa)) {
+        nfa_free(nfa);
+        return REGEX_SET_ERROR;
+    }
+    size_t id = set->num_regexes++;
+    set->sims = (_nfa_sim_t**) realloc(set->sims, sizeof(_nfa_sim_t*) * set->num_regexes);
+    set->sims[id] = nfa_sim_from_nfa(nfa);
+    nfa_free(nfa);
+    const _nfa_sim_t *sim = set->sims[id];
+    for(size_t i = sim->closure_begin[sim->begin_state]; i < sim->closure_begin[sim->begin_state + 1]; ++i)
+        if(sim->accept[sim->closures[i]])
+            set->nullable |= 1ULL << id;
+    set->raw_regexes = (char**) realloc(set->raw_regexes, sizeof(char*) * set->num_regexes);
+    set->raw_regexes[id] = (char*) malloc(size + 1);
+    strcpy(set->raw_regexes[id], raw_regex);
+    if(0 < size && '^' == raw_regex[0])
+        set->left_rooted |= 1ULL << id;
+    if(0 < size && '$' == raw_regex[size - 1])
+        set->right_rooted |= 1ULL << id;
+    return id;
+}
+
+static int _regex_set_compare_states(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t*) a, y = *(const uint32_t*) b;
+    return (x > y) - (x < y);
+}
+
+static uint32_t _regex_set_next_mark(const _regex_set_t *set, _regex_set_dfa_t *dfa) {
+    if(0 == ++dfa->mark) {
+        memset(dfa->marks, 0, sizeof(uint32_t) * set->num_nfa_states);
+        dfa->mark = 1;
+    }
+    return dfa->mark;
+}
+
+_regex_set_dfa_t* _regex_set_dfa_new(const _regex_set_t *set) {
+    _regex_set_dfa_t *dfa = (_regex_set_dfa_t*) calloc(1, sizeof(_regex_set_dfa_t));
+    size_t table_size = 1;
+    while(table_size < 2 * REGEX_SET_STATE_BUDGET)
+        table_size <<= 1;
+    dfa->table = (int32_t*) malloc(sizeof(int32_t) * table_size);
+    dfa->table_mask = table_size - 1;
+    dfa->set_begin = (size_t*) malloc(sizeof(size_t));
+    dfa->scratch = (uint32_t*) malloc(sizeof(uint32_t) * (set->num_nfa_states ? set->num_nfa_states : 1));
+    dfa->marks = (uint32_t*) calloc(set->num_nfa_states ? set->num_nfa_states : 1, sizeof(uint32_t));
+    dfa->mark = 0;
+    return dfa;
+}
+
+/* Forgets every state (but keeps the memory), as a new DFA. */
+static void _regex_set_dfa_clear(_regex_set_dfa_t *dfa) {
+    dfa->num_states = 0;
+    dfa->set_begin[0] = 0;
+    for(size_t i = 0; i <= dfa->table_mask; ++i)
+        dfa->table[i] = -1;
+    for(size_t i = 0; i < REGEX_SET_NUM_BEGINS; ++i)
+        dfa->begin[i] = REGEX_SET_UNKNOWN;
+}
+
+void _regex_set_dfa_free(_regex_set_dfa_t *dfa) {
+    free(dfa->next);
+    free(dfa->accept);
+    free(dfa->restarts);
+    free(dfa->set_begin);
+    free(dfa->sets);
+    free(dfa->table);
+    free(dfa->scratch);
+    free(dfa->marks);
+    free(dfa);
+}
+
+/* Returns the state of the sorted `states[0 .. size)`, adding it if it is new; ~0 if the DFA is full. */
+static size_t _regex_set_intern(const _regex_set_t *set, _regex_set_dfa_t *dfa, const uint32_t *states,
+    size_t size, int restarts) {
+    size_t hash = 14695981039346656037UL ^ (size_t) restarts;
+    for(size_t i = 0; i < size; ++i) {
+        hash ^= states[i];
+        hash *= 1099511628211UL;
+    }
+    size_t slot = hash & dfa->table_mask;
+    for(; -1 != dfa->table[slot]; slot = (slot + 1) & dfa->table_mask) {
+        size_t s = (size_t) dfa->table[slot];
+        if(restarts == dfa->restarts[s] && size == dfa->set_begin[s + 1] - dfa->set_begin[s]
+            && 0 == memcmp(states, &dfa->sets[dfa->set_begin[s]], sizeof(uint32_t) * size))
+            return s;
+    }
+    size_t s = dfa->num_states;
+    if(REGEX_SET_STATE_BUDGET == s)
+        return ~0UL;
+    if(s == dfa->capacity) {
+        dfa->capacity = dfa->capacity ? 2 * dfa->capacity : 16;
+        dfa->next = (uint32_t*) realloc(dfa->next, sizeof(uint32_t) * dfa->capacity * REGEX_SET_ALPHABET_SIZE);
+        dfa->accept = (uint64_t*) realloc(dfa->accept, sizeof(uint64_t) * dfa->capacity);
+        dfa->restarts = (unsigned char*) realloc(dfa->restarts, dfa->capacity);
+        dfa->set_begin = (size_t*) realloc(dfa->set_begin, sizeof(size_t) * (dfa->capacity + 1));
+    }
+    size_t begin = dfa->set_begin[s];
+    if(begin + size > dfa->sets_capacity) {
+        while(begin + size > dfa->sets_capacity)
+            dfa->sets_capacity = dfa->sets_capacity ? 2 * dfa->sets_capacity : 64;
+        dfa->sets = (uint32_t*) realloc(dfa->sets, sizeof(uint32_t) * dfa->sets_capacity);
+    }
+    memcpy(&dfa->sets[begin], states, sizeof(uint32_t) * size);
+    dfa->set_begin[s + 1] = begin + size;
+    for(size_t c = 0; c < REGEX_SET_ALPHABET_SIZE; ++c)
+        dfa->next[s * REGEX_SET_ALPHABET_SIZE + c] = REGEX_SET_UNKNOWN;
+    dfa->accept[s] = 0;
+    for(size_t i = 0; i < size; ++i) {
+        uint32_t k = set->owners[states[i]];
+        if(set->sims[k]->accept[states[i] - set->offsets[k]])
+            dfa->accept[s] |= 1ULL << k;
+    }
+    dfa->restarts[s] = (unsigned char) restarts;
+    dfa->table[slot] = (int32_t) s;
+    dfa->num_states = s + 1;
+    return s;
+}
+
+/* Adds the epsilon-closure of the begin state of every regex in `regexes` to the scratch set. */
+static size_t _regex_set_add_begins(const _regex_set_t *set, _regex_set_dfa_t *dfa, uint64_t regexes,
+    size_t size, uint32_t mark) {
+    for(size_t k = 0; k < set->num_regexes; ++k) {
+        if(!(regexes & (1ULL << k)))
+            continue;
+        const _nfa_sim_t *sim = set->sims[k];
+        for(size_t i = sim->closure_begin[sim->begin_state]; i < sim->closure_begin[sim->begin_state + 1]; ++i) {
+            uint32_t t = set->offsets[k] + sim->closures[i];
+            if(mark != dfa->marks[t]) {
+                dfa->marks[t] = mark;
+                dfa->scratch[size++] = t;
+            }
+        }
+    }
+    return size;
+}
+
+static uint64_t _regex_set_all(const _regex_set_t *set) {
+    return (REGEX_SET_MAX_REGEXES == set->num_regexes) ? ~0ULL : (1ULL << set->num_regexes) - 1;
+}
+
+/* The state the automaton `which` begins in; ~0 if the DFA is full. */
+static size_t _regex_set_begin(const _regex_set_t *set, _regex_set_dfa_t *dfa, _regex_set_begin_t which) {
+    if(REGEX_SET_UNKNOWN != dfa->begin[which])
+        return dfa->begin[which];
+    uint64_t regexes = (REGEX_SET_INSIDE == which || REGEX_SET_UNANCHORED_INSIDE == which)
+        ? _regex_set_all(set) & ~set->left_rooted : _regex_set_all(set);
+    size_t size = _regex_set_add_begins(set, dfa, regexes, 0, _regex_set_next_mark(set, dfa));
+    qsort(dfa->scratch, size, sizeof(uint32_t), &_regex_set_compare_states);
+    size_t s = _regex_set_intern(set, dfa, dfa->scratch, size,
+        REGEX_SET_UNANCHORED == which || REGEX_SET_UNANCHORED_INSIDE == which);
+    if(~0UL != s)
+        dfa->begin[which] = (uint32_t) s;
+    return s;
+}
+
+/**
+ * Computes the transition of `state` on `c`. Returns the state it leads to, or ~0 if the DFA is
+ * full, in which case the NFA states it leads to are left in `dfa->scratch[0 .. *size)`.
+ */
+static size_t _regex_set_transition(const _regex_set_t *set, _regex_set_dfa_t *dfa, size_t state,
+    unsigned char c, size_t *size) {
+    uint32_t mark = _regex_set_next_mark(set, dfa);
+    *size = 0;
+    for(size_t i = dfa->set_begin[state]; i < dfa->set_begin[state + 1]; ++i) {
+        uint32_t k = set->owners[dfa->sets[i]], offset = set->offsets[k];
+        const _nfa_sim_t *sim = set->sims[k];
+        uint32_t s = dfa->sets[i] - offset;
+        for(size_t e = sim->edge_begin[s]; e < sim->edge_begin[s + 1]; ++e) {
+            uint32_t to = sim->edges[e].to;
+            if(sim->edges[e].lo > c || c > sim->edges[e].hi || NFA_SIM_DEAD_EDGE == to)
+                continue;
+            for(size_t j = sim->closure_begin[to]; j < sim->closure_begin[to + 1]; ++j) {
+                uint32_t t = offset + sim->closures[j];
+                if(mark != dfa->marks[t]) {
+                    dfa->marks[t] = mark;
+                    dfa->scratch[(*size)++] = t;
+                }
+            }
+        }
+    }
+    if(dfa->restarts[state])
+        *size = _regex_set_add_begins(set, dfa, _regex_set_all(set) & ~set->left_rooted, *size, mark);
+    qsort(dfa->scratch, *size, sizeof(uint32_t), &_regex_set_compare_states);
+    size_t next = _regex_set_intern(set, dfa, dfa->scratch, *size, dfa->restarts[state]);
+    if(~0UL != next)
+        dfa->next[state * REGEX_SET_ALPHABET_SIZE + c] = (uint32_t) next;
+    return next;
+}
+
+_regex_set_t* _regex_set_compile(_regex_set_t *set) {
+    set->offsets = (uint32_t*) malloc(sizeof(uint32_t) * (set->num_regexes + 1));
+    set->offsets[0] = 0;
+    for(size_t k = 0; k < set->num_regexes; ++k)
+        set->offsets[k + 1] = set->offsets[k] + (uint32_t) set->sims[k]->num_states;
+    set->num_nfa_states = set->offsets[set->num_regexes];
+    set->owners = (uint32_t*) malloc(sizeof(uint32_t) * (set->num_nfa_states ? set->num_nfa_states : 1));
+    for(size_t k = 0; k < set->num_regexes; ++k)
+        for(uint32_t s = set->offsets[k]; s < set->offsets[k + 1]; ++s)
+            set->owners[s] = (uint32_t) k;
+
+    // Every transition of every state, in the order the states are found.
+    _regex_set_dfa_t *dfa = _regex_set_dfa_new(set);
+    _regex_set_dfa_clear(dfa);
+    size_t full = 0, size;
+    for(size_t which = 0; which < REGEX_SET_NUM_BEGINS && !full; ++which)
+        full = (~0UL == _regex_set_begin(set, dfa, (_regex_set_begin_t) which));
+    for(size_t s = 0; s < dfa->num_states && !full; ++s)
+        for(size_t c = 0; c < REGEX_SET_ALPHABET_SIZE && !full; ++c)
+            full = (~0UL == _regex_set_transition(set, dfa, s, (unsigned char) c, &size));
+    if(full)
+        _regex_set_dfa_free(dfa);
+    set->dfa = full ? NULL : dfa;
+    return set;
+}
+
+/* A run's view of the DFA: the set's, or its own past the state budget. */
+typedef struct _regex_set_run_ {
+    _regex_set_dfa_t *dfa;
+    size_t state;
+} _regex_set_run_t;
+
+/* Moves the run to the begin state of `which`. */
+static void _regex_set_run_restart(const _regex_set_t *set, _regex_set_run_t *run, _regex_set_begin_t which) {
+    run->state = _regex_set_begin(set, run->dfa, which);
+    if(~0UL == run->state) {
+        _regex_set_dfa_clear(run->dfa);
+        run->state = _regex_set_begin(set, run->dfa, which);
+    }
+}
+
+static _regex_set_run_t _regex_set_run_begin(const _regex_set_t *set, _regex_set_begin_t which) {
+    assert(NULL != set->offsets && "A regex set cannot be run without first being compiled.");
+    _regex_set_run_t run = {set->dfa, 0};
+    if(NULL == run.dfa) {
+        run.dfa = _regex_set_dfa_new(set);
+        _regex_set_dfa_clear(run.dfa);
+    }
+    _regex_set_run_restart(set, &run, which);
+    return run;
+}
+
+static void _regex_set_run_end(const _regex_set_t *set, _regex_set_run_t *run) {
+    if(run->dfa != set->dfa)
+        _regex_set_dfa_free(run->dfa);
+}
+
+/* Computes the transition the run takes on `c`. Only a run's own DFA fills up (the set's is
+   complete): then it is emptied, and the run goes on from the state it moves to. */
+static size_t _regex_set_run_transition(const _regex_set_t *set, _regex_set_run_t *run, unsigned char c) {
+    int restarts = run->dfa->restarts[run->state];
+    size_t size;
+    size_t next = _regex_set_transition(set, run->dfa, run->state, c, &size);
+    if(~0UL == next) {
+        _regex_set_dfa_clear(run->dfa);
+        next = _regex_set_intern(set, run->dfa, run->dfa->scratch, size, restarts);
+    }
+    return next;
+}
+
+/* Moves the run on `c`, and returns the regexes that accept after it. */
+static inline uint64_t _regex_set_run_step(const _regex_set_t *set, _regex_set_run_t *run, unsigned char c) {
+    uint32_t next = run->dfa->next[run->state * REGEX_SET_ALPHABET_SIZE + c];
+    run->state = (REGEX_SET_UNKNOWN != next) ? next : _regex_set_run_transition(set, run, c);
+    return run->dfa->accept[run->state];
+}
+
+// The run is in the empty set of NFA states, from which the anchored automaton never accepts.
+#define _regex_set_run_is_dead(run) ((run)->dfa->set_begin[(run)->state] == (run)->dfa->set_begin[(run)->state + 1])
+
+uint64_t _regex_set_matches(const _regex_set_t *set, const char *str, size_t len) {
+    _regex_set_run_t run = _regex_set_run_begin(set, REGEX_SET_UNANCHORED);
+    uint64_t all = _regex_set_all(set), found = 0, accept = run.dfa->accept[run.state];
+    for(size_t i = 0; i < len && all != found; ++i) {
+        // `$` regexes only match at the end.
+        found |= accept & ~set->right_rooted;
+        accept = _regex_set_run_step(set, &run, (unsigned char) str[i]);
+    }
+    found |= accept;
+    _regex_set_run_end(set, &run);
+    return found;
+}
+
+/* The longest non-empty match of the anchored automaton from `offset`, which the run begins at. */
+static size_t _regex_set_longest(const _regex_set_t *set, _regex_set_run_t *run, const char *str, size_t len,
+    size_t offset, _regex_match_t *match) {
+    size_t id = ~0UL;
+    for(size_t i = offset; i < len; ++i) {
+        uint64_t accept = _regex_set_run_step(set, run, (unsigned char) str[i]);
+        if(_regex_set_run_is_dead(run))
+            break;
+        if(i + 1 != len)
+            accept &= ~set->right_rooted;
+        if(0 != accept) {
+            id = __builtin_ctzll(accept);
+            match->begin = offset;
+            match->length = i + 1 - offset;
+        }
+    }
+    return id;
+}
+
+size_t _regex_set_match_at(const _regex_set_t *set, const char *str, size_t len, size_t offset, _regex_match_t *match) {
+    _regex_set_run_t run = _regex_set_run_begin(set, (0 == offset) ? REGEX_SET_AT_START : REGEX_SET_INSIDE);
+    size_t id = _regex_set_longest(set, &run, str, len, offset, match);
+    _regex_set_run_end(set, &run);
+    return id;
+}
+
+/* The end of the first non-empty match past `offset` of a regex that is not nullable, or ~0: one
+   scan of the unanchored automaton. The leftmost match begins before it. */
+static size_t _regex_set_first_end(const _regex_set_t *set, const char *str, size_t len, size_t offset) {
+    _regex_set_run_t run = _regex_set_run_begin(set, (0 == offset) ? REGEX_SET_UNANCHORED : REGEX_SET_UNANCHORED_INSIDE);
+    size_t end = ~0UL;
+    for(size_t i = offset; i < len && ~0UL == end; ++i) {
+        // (the run restarts every regex after each character, so nullable ones always accept)
+        uint64_t accept = _regex_set_run_step(set, &run, (unsigned char) str[i]) & ~set->nullable;
+        if(i + 1 != len)
+            accept &= ~set->right_rooted;
+        if(0 != accept)
+            end = i + 1;
+    }
+    _regex_set_run_end(set, &run);
+    return end;
+}
+
+/**
+ * The leftmost position in [offset, bound) where a non-empty match begins, or ~0. Simulates the
+ * NFAs from every such position at once, and keeps for every NFA state the leftmost position it
+ * was reached from (the states of later positions behave the same, and cannot begin before it).
+ * Stops once no state reached from before the leftmost match found so far is left.
+ */
+static size_t _regex_set_leftmost_begin(const _regex_set_t *set, const char *str, size_t len, size_t offset,
+    size_t bound) {
+    size_t n = set->num_nfa_states ? set->num_nfa_states : 1, best = ~0UL, size = 0;
+    size_t *from = (size_t*) malloc(sizeof(size_t) * 2 * n);
+    uint32_t *states = (uint32_t*) malloc(sizeof(uint32_t) * 2 * n);
+    memset(from, 0xff, sizeof(size_t) * 2 * n);
+    size_t *current_from = from, *next_from = from + n;
+    uint32_t *current = states, *next = states + n;
+    for(size_t i = offset; ; ++i) {
+        // The states were reached with at least one character, as they begin before `i`.
+        for(size_t j = 0; j < size; ++j) {
+            uint32_t t = current[j], k = set->owners[t];
+            if(current_from[t] < best && set->sims[k]->accept[t - set->offsets[k]]
+                && (i == len || !(set->right_rooted & (1ULL << k))))
+                best = current_from[t];
+        }
+        if(i == len || (0 == size && (~0UL != best || i >= bound)))
+            break;
+        if(~0UL == best && i < bound) {
+            uint64_t regexes = (0 == i) ? _regex_set_all(set) : _regex_set_all(set) & ~set->left_rooted;
+            for(size_t k = 0; k < set->num_regexes; ++k) {
+                if(!(regexes & (1ULL << k)))
+                    continue;
+                const _nfa_sim_t *sim = set->sims[k];
+                for(size_t e = sim->closure_begin[sim->begin_state]; e < sim->closure_begin[sim->begin_state + 1]; ++e) {
+                    uint32_t t = set->offsets[k] + sim->closures[e];
+                    if(~0UL == current_from[t]) {
+                        current_from[t] = i;
+                        current[size++] = t;
+                    }
+                }
+            }
+        }
+        unsigned char c = (unsigned char) str[i];
+        size_t next_size = 0;
+        for(size_t j = 0; j < size; ++j) {
+            uint32_t t = current[j], k = set->owners[t], offset_k = set->offsets[k];
+            size_t begin = current_from[t];
+            current_from[t] = ~0UL;
+            if(begin >= best)
+                continue;
+            const _nfa_sim_t *sim = set->sims[k];
+            uint32_t s = t - offset_k;
+            for(size_t e = sim->edge_begin[s]; e < sim->edge_begin[s + 1]; ++e) {
+                uint32_t to = sim->edges[e].to;
+                if(sim->edges[e].lo > c || c > sim->edges[e].hi || NFA_SIM_DEAD_EDGE == to)
+                    continue;
+                for(size_t l = sim->closure_begin[to]; l < sim->closure_begin[to + 1]; ++l) {
+                    uint32_t u = offset_k + sim->closures[l];
+                    if(~0UL == next_from[u])
+                        next[next_size++] = u;
+                    if(begin < next_from[u])
+                        next_from[u] = begin;
+                }
+            }
+        }
+        size_t *swap_from = current_from;
+        current_from = next_from;
+        next_from = swap_from;
+        uint32_t *swap = current;
+        current = next;
+        next = swap;
+        size = next_size;
+    }
+    free(from);
+    free(states);
+    return best;
+}
+
+size_t _regex_set_find(const _regex_set_t *set, const char *str, size_t len, size_t offset, _regex_match_t *match) {
+    if(offset >= len)
+        return ~0UL;
+    // Without a nullable regex, no match ends before the first end found: then none begins either.
+    size_t end = _regex_set_first_end(set, str, len, offset);
+    if(~0UL == end && 0 == set->nullable)
+        return ~0UL;
+    size_t begin = _regex_set_leftmost_begin(set, str, len, offset, (~0UL == end) ? len : end);
+    return (~0UL == begin) ? ~0UL : _regex_set_match_at(set, str, len, begin, match);
+}
+
+void _regex_set_free(_regex_set_t *set) {
+    for(size_t k = 0; k < set->num_regexes; ++k) {
+        free(set->raw_regexes[k]);
+        nfa_sim_free(set->sims[k]);
+    }
+    free(set->raw_regexes);
+    free(set->sims);
+    free(set->offsets);
+    free(set->owners);
+    if(NULL != set->dfa)
+        _regex_set_dfa_free(set->dfa);
+    free(set);
+}
+
+#endif
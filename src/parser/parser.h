@@ -2,8 +2,11 @@
 #define PARSER_H
 
 #include "../lexer/lexer.h"
+#include "../util/trace.h"
+#include "../util/spsc_queue.h"
 #include <string.h>
 #include <stdarg.h>
+#include <pthread.h>
 
 /**
  * 
@@ -31,6 +34,11 @@
 #define bnf_rules_new()                                    (_bnf_rules_new())
 #define bnf_rules_add_rule(bnf_rules, bnf_rule)            (_bnf_rules_fn_impl._add_rule((bnf_rules), (bnf_rule)))
 #define bnf_rules_construct_parse_tree(bnf_rules, tokens, type)  (_bnf_rules_fn_impl._construct_parse_tree((bnf_rules), (tokens), (type)))
+#define bnf_rules_prepare(bnf_rules, type)                 (_bnf_rules_prepare((bnf_rules), (type)))
+#define parse_tree_free(parse_tree)                        (_parse_tree_node_free((parse_tree).root))
+#define parser_set_error_handler(fn_ref)                   (_parser_error_handler = (fn_ref))
+#define bnf_rules_construct_parse_tree_pipelined(bnf_rules, token_rules, input) \
+    (_bnf_construct_parse_tree_pipelined((bnf_rules), (token_rules), (input)))
 #define bnf_rule_from(lhs, ...)                            (_bnf_rule_from((lhs), PP_NARG(__VA_ARGS__), __VA_ARGS__))
 #define bnf_rule_from_vector(lhs, rule_vec)                (_bnf_rule_from_vec((lhs), (rule_vec)))
 #define min(x,y)                                            (((x) < (y)) ? (x) : (y))
@@ -117,9 +125,21 @@ typedef void* _void_ptr_;
 define_map(_terminal_t, _void_ptr_);
 typedef Map(_terminal_t, _void_ptr_) _terminal_tree_t;
 define_map(_terminal_t, size_t);
+define_vector(size_t);
+
+typedef enum _parser_type {LEFT_TO_RIGHT, RIGHT_TO_LEFT} parser_type;
 
+/**
+ * The terminal tree, the minimum look-ahead and the rule order only depend on the rules,
+ * so they are built on the first parse and reused (ie. when one `BnfRules` parses many
+ * inputs). Adding a rule invalidates them.
+ */
 struct _bnf_rules_ {
     Vector(_bnf_rule_t) *rules;
+    _terminal_tree_t *terminal_tree;
+    size_t minimum_lookahead;
+    parser_type terminal_tree_type;
+    Vector(size_t) *sorted_rule_indices;
 };
 typedef struct _bnf_rules_ _bnf_rules_t;
 
@@ -136,9 +156,14 @@ struct _parse_tree_value_ {
 typedef struct _parse_tree_value_ _parse_tree_value_t;
 
 typedef struct __parse_tree_node_t_vector_ __parse_tree_node_t_vector_t;
+/**
+ * `annotation` is owned by the evaluator: it is NULL after parsing and can be set once (ie.
+ * by a pass over the tree before evaluation) to cache per-node data such as decoded literals.
+ */
 struct _parse_tree_node_ {
     _parse_tree_value_t root;
     Vector(_parse_tree_node_t) *children;
+    void *annotation;
 };
 typedef struct _parse_tree_node_ _parse_tree_node_t;
 define_vector(_parse_tree_node_t);
@@ -148,7 +173,27 @@ struct _parse_tree_ {
 };
 typedef struct _parse_tree_ _parse_tree_t;
 
-typedef enum _parser_type {LEFT_TO_RIGHT, RIGHT_TO_LEFT} parser_type;
+#define PARSER_TOKEN_BATCH              256
+#define PARSER_PIPELINE_CAPACITY        4096
+
+/**
+ * Where the parser reads its tokens from: a token list (consumed from the front or, when
+ * parsing RIGHT_TO_LEFT, from the back), or a queue that a lexer thread is still filling
+ * (LEFT_TO_RIGHT only). Tokens are taken from the queue in batches.
+ */
+define_spsc_queue(_token_t);
+struct _token_source_ {
+    List(_token_t) *list;
+    SpscQueue(_token_t) *queue;
+    pthread_t producer;
+    _token_t batch[PARSER_TOKEN_BATCH];
+    size_t batch_begin;
+    size_t batch_size;
+};
+typedef struct _token_source_ _token_source_t;
+static inline size_t _token_source_has_next(_token_source_t*);
+static void _token_source_finish(_token_source_t*);
+
 struct _bnf_rules_fn_ {
     _bnf_rules_t* (*_new)();
     void (*_add_rule)(_bnf_rules_t*, _bnf_rule_t);
@@ -163,19 +208,40 @@ static size_t _bnf_rules_find_minimum_lookahead(_bnf_rules_t *bnf_rules, parser_
 static size_t _bnf_rule_index_of_left_most_difference(_bnf_rule_t rule1, _bnf_rule_t rule2);
 static size_t _terminal_equals(_terminal_t terminal1, _terminal_t terminal2);
 static _terminal_tree_t *_bnf_rules_construct_terminal_tree(_bnf_rules_t*, size_t, parser_type);
+static void _bnf_rules_free_terminal_tree(_terminal_tree_t*, size_t);
 void _print_terminal(_terminal_t term);
 _parse_tree_t _bnf_rules_shift_reduce_parse(_bnf_rules_t*, List(_token_t)*, _terminal_tree_t*, size_t, parser_type);
+_parse_tree_t _bnf_rules_shift_reduce_parse_source(_bnf_rules_t*, _token_source_t*, _terminal_tree_t*, size_t, parser_type);
+void _parse_tree_node_free(_parse_tree_node_t);
+
+// Called (if set) before the parser exits on a syntax error, ie. to longjmp back into a
+// long-lived caller instead of terminating the process. The parser's own state is freed first.
+void (*_parser_error_handler)() = NULL;
 
 BnfRules* _bnf_rules_new() {
     BnfRules *bnf_rules = (BnfRules*) malloc(sizeof(BnfRules));
     bnf_rules->rules = vector_new(_bnf_rule_t);
+    bnf_rules->terminal_tree = NULL;
+    bnf_rules->minimum_lookahead = 0;
+    bnf_rules->terminal_tree_type = LEFT_TO_RIGHT;
+    bnf_rules->sorted_rule_indices = NULL;
     return bnf_rules;
 }
 
+static void _bnf_rules_invalidate(_bnf_rules_t *bnf_rules) {
+    if(NULL != bnf_rules->terminal_tree)
+        _bnf_rules_free_terminal_tree(bnf_rules->terminal_tree, bnf_rules->minimum_lookahead);
+    if(NULL != bnf_rules->sorted_rule_indices)
+        vector_free(bnf_rules->sorted_rule_indices);
+    bnf_rules->terminal_tree = NULL;
+    bnf_rules->sorted_rule_indices = NULL;
+}
+
 void _bnf_rules_add_rule(_bnf_rules_t *bnf_rules, _bnf_rule_t rule) {
     if(1 == rule.lhs_terminal.is_terminal)
         assert("LHS terminal cannot be a terminal");
     vector_push_back(bnf_rules->rules, rule);
+    _bnf_rules_invalidate(bnf_rules);
 }
 
 _bnf_rule_t _bnf_rule_from(_terminal_t lhs, size_t num_va_args, ...) {
@@ -195,15 +261,83 @@ _bnf_rule_t _bnf_rule_from(_terminal_t lhs, size_t num_va_args, ...) {
 #define print_bnf_rules_terminal_tree(tt, lh)      _print_bnf_rules_terminal_tree(tt, lh, 0)
 void _print_bnf_rules_terminal_tree(_terminal_tree_t *, size_t, size_t);
 
+static inline Vector(size_t)* _sort_bnf_rule_indices(_bnf_rules_t *bnf_rules);
+
+// Builds the cached parser tables for `type` (a no-op when they are already built).
+void _bnf_rules_prepare(_bnf_rules_t *rules, parser_type type) {
+    if(NULL != rules->terminal_tree && type == rules->terminal_tree_type)
+        return;
+    _bnf_rules_invalidate(rules);
+    // Rules that already differ in their first symbol need no look-ahead, but the shift condition
+    // always compares the top of the stack and the next token, so the tree is at least that deep.
+    rules->minimum_lookahead = max(_bnf_rules_find_minimum_lookahead(rules, type), 1);
+    rules->terminal_tree = _bnf_rules_construct_terminal_tree(rules, rules->minimum_lookahead, type);
+    rules->terminal_tree_type = type;
+    rules->sorted_rule_indices = _sort_bnf_rule_indices(rules);
+}
+
 _parse_tree_t _bnf_construct_parse_tree(_bnf_rules_t *rules, List(_token_t) *token_list, parser_type type) {
-    size_t minimum_lookahead = _bnf_rules_find_minimum_lookahead(rules, type);
-    _terminal_tree_t *terminal_tree = _bnf_rules_construct_terminal_tree(rules, minimum_lookahead, type);
+    apli_alloc_push_tag(APLI_ALLOC_PARSER);
+    _bnf_rules_prepare(rules, type);
     // begin shift-reduce with terminal_tree:
 #ifdef PRINT_LOOK_AHEAD_TREE
-    print_bnf_rules_terminal_tree(terminal_tree, minimum_lookahead);
+    print_bnf_rules_terminal_tree(rules->terminal_tree, rules->minimum_lookahead);
 #endif
-    return _bnf_rules_shift_reduce_parse(rules, token_list, terminal_tree, minimum_lookahead, type);
+    _parse_tree_t parse_tree = _bnf_rules_shift_reduce_parse(rules, token_list, rules->terminal_tree, rules->minimum_lookahead, type);
+    apli_alloc_pop_tag();
+    return parse_tree;
+}
+
+#ifndef NON_GREEDY
+typedef struct _parser_lexer_args_ {
+    TokenRules *token_rules;
+    const char *input;
+    SpscQueue(_token_t) *queue;
+} _parser_lexer_args_t;
+
+static void *_parser_lexer_thread(void *arg) {
+    _parser_lexer_args_t *args = (_parser_lexer_args_t*) arg;
+    apli_trace_begin("lexer", "token_stream");
+    TokenStream *ts = token_stream_new(args->token_rules, args->input);
+    _token_t batch[PARSER_TOKEN_BATCH];
+    size_t batch_size = 0;
+    while(token_stream_next(ts, &batch[batch_size])) {
+        if(PARSER_TOKEN_BATCH == ++batch_size) {
+            spsc_queue_push_batch(args->queue, batch, batch_size);
+            batch_size = 0;
+        }
+    }
+    spsc_queue_push_batch(args->queue, batch, batch_size);
+    spsc_queue_close(args->queue);
+    token_stream_free(ts);
+    apli_trace_end("lexer", "token_stream");
+    return NULL;
+}
+
+/**
+ * Lexes `input` on a second thread while parsing it LEFT_TO_RIGHT: the tokens are handed
+ * over through a bounded queue, so the parser starts on the first batch and the input's
+ * tokens never all exist at once. Tokens to leave out (ie. comments) are those of rules marked
+ * with `token_rules_skip`, which the token stream never produces.
+ */
+_parse_tree_t _bnf_construct_parse_tree_pipelined(_bnf_rules_t *rules, TokenRules *token_rules,
+    const char *input) {
+    apli_alloc_push_tag(APLI_ALLOC_PARSER);
+    _bnf_rules_prepare(rules, LEFT_TO_RIGHT);
+    _token_source_t source;
+    source.list = NULL;
+    source.queue = spsc_queue_new(_token_t, PARSER_PIPELINE_CAPACITY);
+    source.batch_begin = 0;
+    source.batch_size = 0;
+    _parser_lexer_args_t args = {token_rules, input, source.queue};
+    pthread_create(&source.producer, NULL, &_parser_lexer_thread, &args);
+    _parse_tree_t parse_tree = _bnf_rules_shift_reduce_parse_source(rules, &source, rules->terminal_tree,
+        rules->minimum_lookahead, LEFT_TO_RIGHT);
+    _token_source_finish(&source);
+    apli_alloc_pop_tag();
+    return parse_tree;
 }
+#endif
 
 static size_t _bnf_rules_find_minimum_lookahead(_bnf_rules_t *bnf_rules, parser_type type) {
     size_t num_rules = vector_size(bnf_rules->rules);
@@ -284,27 +418,29 @@ _terminal_tree_t *_bnf_rules_construct_terminal_tree(_bnf_rules_t *bnf_rules, si
     return tree;
 }
 
-// DP table to cache results of the hash function, should result in a speedup.
-define_map(_void_ptr_, size_t);
-Map(_void_ptr_, size_t) *_terminal_tree_key_hash_dp_table = NULL;
-static inline size_t _terminal_tree_key_hash(_terminal_t terminal) {
-    void* vd_p = (void*) &terminal.name;
-    if(_terminal_tree_key_hash_dp_table != NULL && map_count(_terminal_tree_key_hash_dp_table, vd_p)) {
-        return map_at(_terminal_tree_key_hash_dp_table, vd_p);
-    } else {
-        _terminal_tree_key_hash_dp_table = map_new(_void_ptr_, size_t);
-    }
-    size_t hash = 0;
-    char *ptr = (char*) (vd_p);
-    size_t i = 0;
-    size_t mod = sizeof(size_t) / sizeof(char);
-    size_t offset = 0;
-    while(i < terminal.name_length) {
-        hash ^= ((255UL & ptr[i++]) << (8 * offset++));
-        offset %= mod;
+static void _bnf_rules_free_terminal_tree(_terminal_tree_t *tree, size_t depth) {
+    if(0 < depth) {
+        __terminal_t__void_ptr__map_match_t_list_t *list = map_get_list(tree);
+        while(list_size(list)) {
+            _bnf_rules_free_terminal_tree((_terminal_tree_t*) list_get_front(list).value, depth - 1);
+            list_pop_front(list);
+        }
+        list_free(list);
     }
-    map_insert(_terminal_tree_key_hash_dp_table, vd_p, hash);
-    return hash;
+    map_free(tree);
+}
+
+// Hashes the name's length and its first, middle and last characters (not the name's pointer):
+// equal names hash alike wherever they are stored (ie. a token's name and a grammar
+// terminal's), and hashing has no state, so parsers on several threads can share a tree.
+static inline size_t _terminal_tree_key_hash(_terminal_t terminal) {
+    size_t length = terminal.name_length;
+    size_t hash = length;
+    if(0 < length)
+        hash |= ((255UL & terminal.name[0]) << 8) | ((255UL & terminal.name[length / 2]) << 16)
+            | ((255UL & terminal.name[length - 1]) << 24);
+    hash *= 0x9E3779B97F4A7C15UL;
+    return hash ^ (hash >> 32);
 }
 
 static inline size_t _terminal_tree_key_equals(_terminal_t terminal_1, _terminal_t terminal_2) {
@@ -312,6 +448,8 @@ static inline size_t _terminal_tree_key_equals(_terminal_t terminal_1, _terminal
         // printf("<<invalid name length!>>"); 
         return 0;
     }
+    if(terminal_1.name == terminal_2.name)
+        return 1;
     for(size_t i = 0; i < terminal_1.name_length; ++i)
         if(terminal_1.name[i] != terminal_2.name[i]) {
             // printf("<<incorrect char @ %zu!>>", i); 
@@ -356,46 +494,54 @@ void _print_terminal(_terminal_t term) {
     printf("\"]");
 }
 
-define_vector(size_t);
-
 static inline _parse_tree_node_t _parse_tree_node_t_from_token_t(_token_t token);
 static inline void _parser_shift(Vector(_parse_tree_node_t)*, List(_token_t)*);
-static inline void _parser_fill_look_ahead_list(List(_token_t)*, List(_token_t)*, size_t look_ahead, parser_type);
+static inline void _parser_fill_look_ahead_list(List(_token_t)*, _token_source_t*, size_t look_ahead, parser_type);
 static inline char _parser_shift_condition(Vector(_parse_tree_node_t)*, List(_token_t)*, _terminal_tree_t*, size_t);
 static inline char _parser_reduce(Vector(_parse_tree_node_t)*, Vector(size_t)*, _bnf_rules_t*, parser_type);
 static inline void _parser_print_parse_tree_node_vector(Vector(_parse_tree_node_t)*);
 static inline void _parser_print_token_list(List(_token_t)*);
 static inline void _parser_print_parsing_step(Vector(_parse_tree_node_t) *parse_stack, List(_token_t) *look_ahead_list,
-    List(_token_t) *token_list, size_t step_number);
+    _token_source_t *source, size_t step_number);
 static inline Vector(size_t)* _sort_bnf_rule_indices(_bnf_rules_t *bnf_rules);
 
 _parse_tree_t _bnf_rules_shift_reduce_parse(_bnf_rules_t *bnf_rules, List(_token_t) *token_list, _terminal_tree_t *tree, size_t look_ahead, parser_type type) {
+    _token_source_t source;
+    source.list = token_list;
+    source.queue = NULL;
+    return _bnf_rules_shift_reduce_parse_source(bnf_rules, &source, tree, look_ahead, type);
+}
+
+_parse_tree_t _bnf_rules_shift_reduce_parse_source(_bnf_rules_t *bnf_rules, _token_source_t *source, _terminal_tree_t *tree, size_t look_ahead, parser_type type) {
+    apli_trace_begin("parser", "shift_reduce_parse");
     Vector(_parse_tree_node_t) *parse_stack = vector_new(_parse_tree_node_t);
     List(_token_t) *look_ahead_list = list_new(_token_t);
     size_t last_reduced_index = ~0UL;
     size_t step_number = 1;
 
-    Vector(size_t) *sorted_rule_indices = _sort_bnf_rule_indices(bnf_rules);
+    if(NULL == bnf_rules->sorted_rule_indices)
+        bnf_rules->sorted_rule_indices = _sort_bnf_rule_indices(bnf_rules);
+    Vector(size_t) *sorted_rule_indices = bnf_rules->sorted_rule_indices;
 
-    if(0 == list_size(token_list))
+    if(!_token_source_has_next(source))
         assert(0 == "Token list is empty!");
 
     // To begin, we fill the look_ahead list, shift, then fill look_ahead again.
-    _parser_fill_look_ahead_list(look_ahead_list, token_list, look_ahead, type);
+    _parser_fill_look_ahead_list(look_ahead_list, source, look_ahead, type);
 #ifdef PRINT_PARSE_TREE_STEPS
-    _parser_print_parsing_step(parse_stack, look_ahead_list, token_list, step_number);
+    _parser_print_parsing_step(parse_stack, look_ahead_list, source, step_number);
 #endif
     step_number += 1;
     _parser_shift(parse_stack, look_ahead_list);
 #ifdef PRINT_PARSE_TREE_STEPS
-    _parser_print_parsing_step(parse_stack, look_ahead_list, token_list, step_number);
+    _parser_print_parsing_step(parse_stack, look_ahead_list, source, step_number);
 #endif
     step_number += 1;
-    _parser_fill_look_ahead_list(look_ahead_list, token_list, look_ahead, type);
+    _parser_fill_look_ahead_list(look_ahead_list, source, look_ahead, type);
 
-    while(0 < list_size(token_list) || 0 < list_size(look_ahead_list)) {
+    while(_token_source_has_next(source) || 0 < list_size(look_ahead_list)) {
 #ifdef PRINT_PARSE_TREE_STEPS
-        _parser_print_parsing_step(parse_stack, look_ahead_list, token_list, step_number);
+        _parser_print_parsing_step(parse_stack, look_ahead_list, source, step_number);
 #endif
         step_number += 1;
 
@@ -403,12 +549,12 @@ _parse_tree_t _bnf_rules_shift_reduce_parse(_bnf_rules_t *bnf_rules, List(_token
 #ifndef IGNORE_PARSER_SHIFT_CONDITION_CHECK
         if(_parser_shift_condition(parse_stack, look_ahead_list, tree, look_ahead)) {
             _parser_shift(parse_stack, look_ahead_list);
-            _parser_fill_look_ahead_list(look_ahead_list, token_list, look_ahead, type);
+            _parser_fill_look_ahead_list(look_ahead_list, source, look_ahead, type);
         } else {
 #endif
             if(1 == _parser_reduce(parse_stack, sorted_rule_indices, bnf_rules, type)) {
                 _parser_shift(parse_stack, look_ahead_list);
-                _parser_fill_look_ahead_list(look_ahead_list, token_list, look_ahead, type);
+                _parser_fill_look_ahead_list(look_ahead_list, source, look_ahead, type);
             } else {
                 last_reduced_index = vector_size(parse_stack) - 1;
             }
@@ -420,7 +566,7 @@ _parse_tree_t _bnf_rules_shift_reduce_parse(_bnf_rules_t *bnf_rules, List(_token
     // Keep reducing.
     while(0 == _parser_reduce(parse_stack, sorted_rule_indices, bnf_rules, type)) {
 #ifdef PRINT_PARSE_TREE_STEPS
-        _parser_print_parsing_step(parse_stack, look_ahead_list, token_list, step_number);
+        _parser_print_parsing_step(parse_stack, look_ahead_list, source, step_number);
 #endif
         last_reduced_index = vector_size(parse_stack) - 1;
         step_number += 1;
@@ -428,11 +574,10 @@ _parse_tree_t _bnf_rules_shift_reduce_parse(_bnf_rules_t *bnf_rules, List(_token
 
     // NOTE: Define PRINT_PARSE_TREE to print the final parse tree.
 #if defined(PRINT_PARSE_TREE) || defined(PRINT_PARSE_TREE_STEPS) 
-    _parser_print_parsing_step(parse_stack, look_ahead_list, token_list, step_number);
+    _parser_print_parsing_step(parse_stack, look_ahead_list, source, step_number);
 #endif
 
     list_free(look_ahead_list);
-    vector_free(sorted_rule_indices);
 
     if(1 != vector_size(parse_stack)) {
         if(type == RIGHT_TO_LEFT) {
@@ -449,11 +594,20 @@ _parse_tree_t _bnf_rules_shift_reduce_parse(_bnf_rules_t *bnf_rules, List(_token
         }
         fprintf(stderr, FRED "Parser Error! Final parse stack:\n" RESET);
         _parser_print_parse_tree_node_vector(parse_stack);
-        
+        _token_source_finish(source);
+        // The handler may not return, so nothing of the parse is left to free.
+        for(size_t i = 0; i < vector_size(parse_stack); ++i)
+            _parse_tree_node_free(vector_get(parse_stack, i));
+        vector_free(parse_stack);
+        apli_trace_end("parser", "shift_reduce_parse");
+
+        if(NULL != _parser_error_handler)
+            _parser_error_handler();
         exit(1);
     }
     _parse_tree_t parse_tree = {vector_get_back(parse_stack)};
     vector_free(parse_stack);
+    apli_trace_end("parser", "shift_reduce_parse");
     return parse_tree;
 }
 
@@ -479,14 +633,17 @@ Vector(size_t)* _sort_bnf_rule_indices(_bnf_rules_t *bnf_rules) {
 }
 
 static inline void _parser_print_parsing_step(Vector(_parse_tree_node_t) *parse_stack, List(_token_t) *look_ahead_list,
-    List(_token_t) *token_list, size_t step_number) {
+    _token_source_t *source, size_t step_number) {
     fprintf(stderr, FBLUE "----------- STEP #%zu -----------" RESET, step_number);
     fprintf(stderr, "\n\n" FRED "Parse Stack: " RESET "\n");
     _parser_print_parse_tree_node_vector(parse_stack);
     fprintf(stderr, FRED "Look-ahead list: " RESET);
     _parser_print_token_list(look_ahead_list);
     fprintf(stderr, "\n" FRED "Tokens: " RESET);
-    _parser_print_token_list(token_list);
+    if(NULL != source->list)
+        _parser_print_token_list(source->list);
+    else
+        fprintf(stderr, "(streamed)");
     fprintf(stderr, "\n\n");
     fprintf(stderr, FBLUE "---------------------------------\n\n" RESET);
 }
@@ -494,6 +651,7 @@ static inline void _parser_print_parsing_step(Vector(_parse_tree_node_t) *parse_
 
 static inline void _parser_shift(Vector(_parse_tree_node_t) *parse_stack, List(_token_t) *look_ahead_list) {
     if(0 < list_size(look_ahead_list)) {
+        apli_stat_inc(shifts);
         vector_push_back(parse_stack, _parse_tree_node_t_from_token_t(list_get_front(look_ahead_list)));
         list_pop_front(look_ahead_list);
     } else {
@@ -501,24 +659,63 @@ static inline void _parser_shift(Vector(_parse_tree_node_t) *parse_stack, List(_
     }
 }
 
-static inline void _parser_fill_look_ahead_list(List(_token_t) *look_ahead_list, List(_token_t) *token_list, 
-    size_t look_ahead, parser_type type) {
-    while(list_size(look_ahead_list) < max(look_ahead - 1, 1) && 0 < list_size(token_list)) {
-        if(LEFT_TO_RIGHT == type) {
-            list_push_back(look_ahead_list, list_get_front(token_list));
-            list_pop_front(token_list);
-        } else {
-            list_push_back(look_ahead_list, list_get_back(token_list));
-            list_pop_back(token_list);
-        }
+static inline size_t _token_source_has_next(_token_source_t *source) {
+    if(NULL == source->queue)
+        return 0 < list_size(source->list);
+    if(source->batch_begin == source->batch_size) {
+        source->batch_begin = 0;
+        source->batch_size = spsc_queue_pop_batch(source->queue, source->batch, PARSER_TOKEN_BATCH);
+    }
+    return source->batch_begin < source->batch_size;
+}
+
+// Only called after `_token_source_has_next` returned 1.
+static inline _token_t _token_source_next(_token_source_t *source, parser_type type) {
+    if(NULL != source->queue)
+        return source->batch[source->batch_begin++];
+    _token_t token;
+    if(LEFT_TO_RIGHT == type) {
+        token = list_get_front(source->list);
+        list_pop_front(source->list);
+    } else {
+        token = list_get_back(source->list);
+        list_pop_back(source->list);
     }
+    return token;
+}
+
+// Lets a lexer thread that fills the source's queue run to completion, and frees the queue.
+static void _token_source_finish(_token_source_t *source) {
+    if(NULL == source->queue)
+        return;
+    while(spsc_queue_pop_batch(source->queue, source->batch, PARSER_TOKEN_BATCH))
+        ;
+    pthread_join(source->producer, NULL);
+    spsc_queue_free(source->queue);
+    source->queue = NULL;
+    source->list = NULL;
+}
+
+static inline void _parser_fill_look_ahead_list(List(_token_t) *look_ahead_list, _token_source_t *source, 
+    size_t look_ahead, parser_type type) {
+    while(list_size(look_ahead_list) < max(look_ahead - 1, 1) && _token_source_has_next(source))
+        list_push_back(look_ahead_list, _token_source_next(source, type));
+}
+
+// Frees the children vectors of the tree (tokens point into the input and are not owned).
+void _parse_tree_node_free(_parse_tree_node_t node) {
+    for(size_t i = 0; i < vector_size(node.children); ++i)
+        _parse_tree_node_free(vector_get(node.children, i));
+    vector_free(node.children);
 }
 
 static inline _parse_tree_node_t _parse_tree_node_t_from_token_t(_token_t token) {
     _parse_tree_value_t ptv;
     ptv.is_terminal_t = 0;
     ptv.ptr.token = token;
-    _parse_tree_node_t ptn = {ptv, vector_new(_parse_tree_node_t)};
+    apli_alloc_push_tag(APLI_ALLOC_PARSE_TREE);
+    _parse_tree_node_t ptn = {ptv, vector_new(_parse_tree_node_t), NULL};
+    apli_alloc_pop_tag();
     return ptn;
 }
 
@@ -562,11 +759,15 @@ static inline char _parser_shift_condition(Vector(_parse_tree_node_t) *parse_sta
 static inline char _parser_parse_stack_matches_bnf_rule(Vector(_parse_tree_node_t) *parse_stack, _bnf_rule_t bnf, parser_type type);
 
 static inline char _parser_reduce(Vector(_parse_tree_node_t) *parse_stack, Vector(size_t) *sorted_rule_indices, _bnf_rules_t *bnf_rules, parser_type type) {
+    apli_stat_inc(reduce_attempts);
     for(size_t i = 0; i < vector_size(sorted_rule_indices); ++i) {
         _bnf_rule_t bnf = vector_get(bnf_rules->rules, vector_get(sorted_rule_indices, i));
         // printf("Checking Rule #%zu!\n", vector_get(possible_rule_indices, i));
+        apli_stat_inc(reduce_rule_checks);
         if(_parser_parse_stack_matches_bnf_rule(parse_stack, bnf, type)) {
+            apli_stat_inc(reductions);
             // printf("Rule #%zu matched!\n", vector_get(possible_rule_indices, i));
+            apli_alloc_push_tag(APLI_ALLOC_PARSE_TREE);
             Vector(_parse_tree_node_t) *children_vector = vector_new(_parse_tree_node_t);
             size_t parse_stack_size = vector_size(parse_stack);
             FOR_LOOP_DIRECTION_SWAP_IF(j, parse_stack_size - vector_size(bnf.rule), parse_stack_size - 1, RIGHT_TO_LEFT == type)
@@ -574,8 +775,9 @@ static inline char _parser_reduce(Vector(_parse_tree_node_t) *parse_stack, Vecto
             for(size_t j = 0; j < vector_size(bnf.rule); ++j)
                 vector_pop_back(parse_stack);
             _parse_tree_value_t parent_value = {-1, bnf.lhs_terminal};
-            _parse_tree_node_t new_parent_node = {parent_value, children_vector};
+            _parse_tree_node_t new_parent_node = {parent_value, children_vector, NULL};
             vector_push_back(parse_stack, new_parent_node);
+            apli_alloc_pop_tag();
             return 0; // successfully reduced!
         }
    }
@@ -0,0 +1,270 @@
+#ifndef ALLOC_H
+#define ALLOC_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Allocation accounting per subsystem.
+ *
+ * Compile with `-DAPLI_ALLOC_TRACKING` to route `malloc`/`calloc`/`realloc`/`free` (in every
+ * file that includes this header, ie. all of src/ and the evaluators) through a tracking
+ * layer. Each allocation is charged to the tag on top of the tag stack when it is made, and
+ * the tag is remembered in a small header so that frees are charged back to it. Without the
+ * flag the tag macros expand to `((void) 0)`, and `apli_alloc_tag_depth()` to 0.
+ *
+ * The pipeline pushes its own tags (regex compile, lexer, parser, parse tree, maps); user
+ * code pushes `APLI_ALLOC_EVALUATOR` (or anything else) around its own work. Allocations
+ * made with no tag pushed are charged to `APLI_ALLOC_OTHER`.
+ *
+ * ----- Usage -----
+ *   apli_alloc_push_tag(tag)    -> void
+ *   apli_alloc_pop_tag()        -> void
+ *   apli_alloc_tag_depth()      -> size_t (restore it with `apli_alloc_set_tag_depth` after a longjmp)
+ *   apli_alloc_get(tag)         -> apli_alloc_stats
+ *   apli_alloc_reset()          -> void
+ *   apli_alloc_print(fp)        -> void
+ * With `APLI_ALLOC_TRACKING` defined, the report is also printed to stderr when the program
+ * exits (unless the `APLI_ALLOC_QUIET` environment variable is set). The tag stack is per
+ * thread, but the counters are not synchronized, so they are approximate when several threads
+ * allocate (ie. `MULTITHREADED` or `apli_context_parse_batch`). Cannot be combined with
+ * `ARENA_ALLOCATOR`.
+ */
+
+typedef enum {
+    APLI_ALLOC_OTHER,
+    APLI_ALLOC_REGEX_COMPILE,
+    APLI_ALLOC_LEXER,
+    APLI_ALLOC_PARSER,
+    APLI_ALLOC_PARSE_TREE,
+    APLI_ALLOC_MAPS,
+    APLI_ALLOC_EVALUATOR,
+    APLI_ALLOC_NUM_TAGS
+} apli_alloc_tag;
+
+// Bucket i counts allocations of at most 2^(i + 4) bytes; the last bucket counts the rest.
+#define APLI_ALLOC_HISTOGRAM_SIZE   14
+#define APLI_ALLOC_MAX_TAG_DEPTH    64
+
+typedef struct _apli_alloc_stats {
+    size_t allocations;
+    size_t frees;
+    size_t bytes;
+    size_t live_bytes;
+    size_t peak_live_bytes;
+    size_t histogram[APLI_ALLOC_HISTOGRAM_SIZE];
+} apli_alloc_stats;
+
+#ifdef APLI_ALLOC_TRACKING
+
+#ifdef ARENA_ALLOCATOR
+#error "APLI_ALLOC_TRACKING cannot be combined with ARENA_ALLOCATOR."
+#endif
+
+#define _APLI_ALLOC_MAGIC 0xA110CA7EUL
+
+// Kept at 16 bytes so that the returned pointers stay aligned like `malloc`'s.
+typedef struct _apli_alloc_header {
+    unsigned int magic;
+    unsigned int tag;
+    size_t size;
+} _apli_alloc_header;
+
+typedef struct _apli_alloc_state {
+    apli_alloc_stats stats[APLI_ALLOC_NUM_TAGS];
+    size_t live_bytes;
+    size_t peak_live_bytes;
+} _apli_alloc_state;
+
+_apli_alloc_state _apli_alloc = {0};
+// Every thread charges its allocations to the tags it pushed itself.
+static __thread apli_alloc_tag _apli_alloc_tags[APLI_ALLOC_MAX_TAG_DEPTH];
+static __thread size_t _apli_alloc_tags_size = 0;
+
+#define apli_alloc_push_tag(tag)        _apli_alloc_push_tag(tag)
+#define apli_alloc_pop_tag()            _apli_alloc_pop_tag()
+#define apli_alloc_tag_depth()          (_apli_alloc_tags_size)
+#define apli_alloc_set_tag_depth(depth) (_apli_alloc_tags_size = (depth))
+
+static inline void _apli_alloc_push_tag(apli_alloc_tag tag) {
+    if(_apli_alloc_tags_size < APLI_ALLOC_MAX_TAG_DEPTH)
+        _apli_alloc_tags[_apli_alloc_tags_size] = tag;
+    _apli_alloc_tags_size += 1;
+}
+
+static inline void _apli_alloc_pop_tag() {
+    if(0 < _apli_alloc_tags_size)
+        _apli_alloc_tags_size -= 1;
+}
+
+static inline apli_alloc_tag _apli_alloc_current_tag() {
+    size_t size = _apli_alloc_tags_size;
+    if(0 == size)
+        return APLI_ALLOC_OTHER;
+    return _apli_alloc_tags[(size <= APLI_ALLOC_MAX_TAG_DEPTH ? size : APLI_ALLOC_MAX_TAG_DEPTH) - 1];
+}
+
+static inline size_t _apli_alloc_histogram_bucket(size_t sz) {
+    size_t bucket = 0;
+    while(bucket + 1 < APLI_ALLOC_HISTOGRAM_SIZE && (16UL << bucket) < sz)
+        ++bucket;
+    return bucket;
+}
+
+static inline void _apli_alloc_charge(_apli_alloc_header *header) {
+    apli_alloc_stats *s = &_apli_alloc.stats[header->tag];
+    s->allocations += 1;
+    s->bytes += header->size;
+    s->live_bytes += header->size;
+    if(s->peak_live_bytes < s->live_bytes)
+        s->peak_live_bytes = s->live_bytes;
+    s->histogram[_apli_alloc_histogram_bucket(header->size)] += 1;
+    _apli_alloc.live_bytes += header->size;
+    if(_apli_alloc.peak_live_bytes < _apli_alloc.live_bytes)
+        _apli_alloc.peak_live_bytes = _apli_alloc.live_bytes;
+}
+
+static inline void _apli_alloc_refund(_apli_alloc_header *header) {
+    // Blocks allocated before an `apli_alloc_reset` may be freed after it.
+    apli_alloc_stats *s = &_apli_alloc.stats[header->tag];
+    s->frees += 1;
+    s->live_bytes -= (header->size < s->live_bytes) ? header->size : s->live_bytes;
+    _apli_alloc.live_bytes -= (header->size < _apli_alloc.live_bytes) ? header->size : _apli_alloc.live_bytes;
+}
+
+static inline void *_apli_alloc_malloc(size_t sz) {
+    _apli_alloc_header *header = (_apli_alloc_header*) (malloc)(sizeof(_apli_alloc_header) + sz);
+    if(NULL == header)
+        return NULL;
+    header->magic = _APLI_ALLOC_MAGIC;
+    header->tag = _apli_alloc_current_tag();
+    header->size = sz;
+    _apli_alloc_charge(header);
+    return header + 1;
+}
+
+static inline void *_apli_alloc_calloc(size_t num, size_t sz) {
+    void *ptr = _apli_alloc_malloc(num * sz);
+    if(NULL != ptr)
+        memset(ptr, 0, num * sz);
+    return ptr;
+}
+
+static inline _apli_alloc_header *_apli_alloc_header_of(void *ptr) {
+    _apli_alloc_header *header = ((_apli_alloc_header*) ptr) - 1;
+    if(_APLI_ALLOC_MAGIC != header->magic) {
+        fprintf(stderr, "apli_alloc: %p was not allocated by the tracking allocator.\n", ptr);
+        abort();
+    }
+    return header;
+}
+
+static inline void _apli_alloc_free(void *ptr) {
+    if(NULL == ptr)
+        return;
+    _apli_alloc_header *header = _apli_alloc_header_of(ptr);
+    _apli_alloc_refund(header);
+    header->magic = 0;
+    (free)(header);
+}
+
+// A reallocation is charged as a free of the old block and an allocation of the new one. If it
+// fails, the old block is still live and stays charged.
+static inline void *_apli_alloc_realloc(void *ptr, size_t sz) {
+    if(NULL == ptr)
+        return _apli_alloc_malloc(sz);
+    _apli_alloc_header *old = _apli_alloc_header_of(ptr);
+    _apli_alloc_header *header = (_apli_alloc_header*) (realloc)(old, sizeof(_apli_alloc_header) + sz);
+    if(NULL == header)
+        return NULL;
+    _apli_alloc_refund(header);
+    header->tag = _apli_alloc_current_tag();
+    header->size = sz;
+    _apli_alloc_charge(header);
+    return header + 1;
+}
+
+#define malloc(sz)          _apli_alloc_malloc(sz)
+#define calloc(num, sz)     _apli_alloc_calloc(num, sz)
+#define realloc(ptr, sz)    _apli_alloc_realloc(ptr, sz)
+#define free(ptr)           _apli_alloc_free(ptr)
+
+#else
+
+#define apli_alloc_push_tag(tag)        ((void) 0)
+#define apli_alloc_pop_tag()            ((void) 0)
+#define apli_alloc_tag_depth()          0UL
+#define apli_alloc_set_tag_depth(depth) ((void) (depth))
+
+#endif
+
+#define apli_alloc_get(tag)     _apli_alloc_get(tag)
+#define apli_alloc_reset()      _apli_alloc_reset()
+#define apli_alloc_print(fp)    _apli_alloc_print(fp)
+
+static inline apli_alloc_stats _apli_alloc_get(apli_alloc_tag tag) {
+#ifdef APLI_ALLOC_TRACKING
+    return _apli_alloc.stats[tag];
+#else
+    (void) tag;
+    apli_alloc_stats empty = {0};
+    return empty;
+#endif
+}
+
+// Resets the counters (not the tag stack). Blocks that are still live keep their tag.
+static inline void _apli_alloc_reset() {
+#ifdef APLI_ALLOC_TRACKING
+    memset(_apli_alloc.stats, 0, sizeof(_apli_alloc.stats));
+    _apli_alloc.live_bytes = 0;
+    _apli_alloc.peak_live_bytes = 0;
+#endif
+}
+
+static inline void _apli_alloc_print(FILE *fp) {
+    static const char *names[APLI_ALLOC_NUM_TAGS] = {
+        "other", "regex compile", "lexer", "parser", "parse tree", "maps", "evaluator"
+    };
+    fprintf(fp, "--- APLI allocations ---\n");
+#ifndef APLI_ALLOC_TRACKING
+    fprintf(fp, "(compiled without -DAPLI_ALLOC_TRACKING)\n");
+#else
+    fprintf(fp, "peak live bytes: %zu\n", _apli_alloc.peak_live_bytes);
+#endif
+    fprintf(fp, "%-14s %12s %12s %14s %12s %14s\n", "subsystem", "allocations", "frees", "bytes", "live", "peak live");
+    for(size_t tag = 0; tag < APLI_ALLOC_NUM_TAGS; ++tag) {
+        apli_alloc_stats s = _apli_alloc_get((apli_alloc_tag) tag);
+        if(0 == s.allocations)
+            continue;
+        fprintf(fp, "%-14s %12zu %12zu %14zu %12zu %14zu\n", names[tag], s.allocations, s.frees,
+            s.bytes, s.live_bytes, s.peak_live_bytes);
+    }
+    fprintf(fp, "size histogram (allocations of at most N bytes):\n%-14s", "subsystem");
+    for(size_t i = 0; i + 1 < APLI_ALLOC_HISTOGRAM_SIZE; ++i)
+        fprintf(fp, " %8lu", 16UL << i);
+    fprintf(fp, " %8s\n", "more");
+    for(size_t tag = 0; tag < APLI_ALLOC_NUM_TAGS; ++tag) {
+        apli_alloc_stats s = _apli_alloc_get((apli_alloc_tag) tag);
+        if(0 == s.allocations)
+            continue;
+        fprintf(fp, "%-14s", names[tag]);
+        for(size_t i = 0; i < APLI_ALLOC_HISTOGRAM_SIZE; ++i)
+            fprintf(fp, " %8zu", s.histogram[i]);
+        fprintf(fp, "\n");
+    }
+}
+
+#ifdef APLI_ALLOC_TRACKING
+static void _apli_alloc_print_at_exit() {
+    const char *quiet = getenv("APLI_ALLOC_QUIET");
+    if(NULL == quiet || '\0' == quiet[0])
+        _apli_alloc_print(stderr);
+}
+
+__attribute__((constructor)) static void _apli_alloc_register() {
+    atexit(&_apli_alloc_print_at_exit);
+}
+#endif
+
+#endif
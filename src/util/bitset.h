@@ -106,7 +106,7 @@ static inline List(size_t)* _bitset_get_element_list(_bitset_t* bs) {
     List(size_t) *lst = list_new(size_t);
     for(size_t i = 0; i < bs->size; ++i)
         for(size_t pow = 0; pow < (1 << BITSET_CHUNK_SIZE); ++pow)
-            if(bs->arr[i] & (1 << pow)) // if pow is in
+            if(bs->arr[i] & (1UL << pow)) // if pow is in
                 list_push_back(lst, (i << BITSET_CHUNK_SIZE) + pow);
     return lst;
 }
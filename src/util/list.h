@@ -2,12 +2,14 @@
 #define LIST_C
 
 #include <stdlib.h>
+#include "alloc.h"
 
 /**
  * Defines a deque with the given API
  * 
  * ----- Usage -----
  * List(type) *list = list_new(type);
+ *   - list_splice_back(list, other) moves every node of `other` to the back of `list` in O(1).
  *  
  */
 
@@ -29,6 +31,7 @@
 #define list_push_back(list, val)   ((list)->_fns->_push_back((list), (val)))
 #define list_pop_front(list)        ((list)->_fns->_pop_front((list)))
 #define list_pop_back(list)         ((list)->_fns->_pop_back((list)))
+#define list_splice_back(list, other) ((list)->_fns->_splice_back((list), (other)))
 #define list_free(list)             ((list)->_fns->_free((list)))
 
 #define define_list(TYPE)                       \
@@ -48,6 +51,7 @@
         void (*_free)(struct _##TYPE##_list_*);      \
         size_t (*_get_size)(struct _##TYPE##_list_*);     \
         void (*_remove_node)(struct _##TYPE##_list_*, TYPE##_list_node_t*); \
+        void (*_splice_back)(struct _##TYPE##_list_*, struct _##TYPE##_list_*); \
     } TYPE##_list_fns_t;                          \
     typedef struct _##TYPE##_list_ {            \
         size_t _size;                           \
@@ -154,12 +158,27 @@
     static inline size_t _##TYPE##_list_get_size(TYPE##_list_t *list) {   \
         return list->_size; \
     } \
+    void _##TYPE##_list_splice_back(TYPE##_list_t *list, TYPE##_list_t *other) { \
+        if(0 == other->_size) \
+            return; \
+        if(0 == list->_size) { \
+            list->_first = other->_first; \
+        } else { \
+            list->_last->_next = other->_first; \
+            other->_first->_prev = list->_last; \
+        } \
+        list->_last = other->_last; \
+        list->_size += other->_size; \
+        other->_first = NULL; \
+        other->_last = NULL; \
+        other->_size = 0; \
+    } \
     TYPE##_list_fns_t TYPE##_list_fns = {                     \
         &_##TYPE##_list_get_first, &_##TYPE##_list_get_last,    \
         &_##TYPE##_list_push_front, &_##TYPE##_list_push_back,  \
         &_##TYPE##_list_pop_front, &_##TYPE##_list_pop_back,    \
         &_free_##TYPE##_list, &_##TYPE##_list_get_size,         \
-        &_##TYPE##_list_node_remove                             \
+        &_##TYPE##_list_node_remove, &_##TYPE##_list_splice_back \
     };                                                          \
     TYPE##_list_t* _new_##TYPE##_list() {                   \
         TYPE##_list_t *new_list = (TYPE##_list_t*) malloc(sizeof(TYPE##_list_t));  \
@@ -5,6 +5,8 @@
 #include <assert.h>
 #include "vector.h"
 #include "list.h"
+#include "stats.h"
+#include "alloc.h"
 
 // Macros
 #define RESIZE_RATIO    0.90
@@ -144,6 +146,7 @@
     \
     void _##key_type##_##value_type##_map_insert_(_##key_type##_##value_type##_map_t *map, key_type key, \
         value_type val) { \
+        apli_alloc_push_tag(APLI_ALLOC_MAPS); \
         _allocate_into_bucket_##key_type##_##value_type##_map_( \
             map, \
             map->hash(key), \
@@ -151,6 +154,7 @@
             val);\
         map->size += 1; \
         _check_resize_##value_type##_##key_type##_map_(map); \
+        apli_alloc_pop_tag(); \
     } \
     \
     value_type _##key_type##_##value_type##_map_at_(_##key_type##_##value_type##_map_t *map, key_type key) { \
@@ -158,8 +162,11 @@
         size_t key_hash = map->hash(key); \
         _##key_type##_##value_type##_map_match_list_t bucket = vector_get(map->buckets, (key_hash & mask)); \
         Iterator(_##key_type##_##value_type##_map_match_t) *iter = list_get_iterator(bucket); \
+        apli_stat_inc(map_lookups); \
+        if(bucket != NULL) apli_stat_max(map_max_chain, list_size(bucket)); \
         while(iter != NULL) { \
             _##key_type##_##value_type##_map_match_t match = iter_val(iter); \
+            apli_stat_inc(map_probes); \
             if(match.hash == key_hash && map->key_eq(match.key, key)) \
                 return match.value; \
             iter = iter_next(iter); \
@@ -189,10 +196,13 @@
         size_t mask = (vector_size(map->buckets) - 1); \
         size_t key_hash = map->hash(key); \
         _##key_type##_##value_type##_map_match_list_t bucket = vector_get(map->buckets, (key_hash & mask)); \
+        apli_stat_inc(map_lookups); \
         if(bucket == NULL || list_size(bucket) == 0) return 0; \
+        apli_stat_max(map_max_chain, list_size(bucket)); \
         Iterator(_##key_type##_##value_type##_map_match_t) *iter = list_get_iterator(bucket); \
         while(iter != NULL) { \
             _##key_type##_##value_type##_map_match_t match = iter_val(iter); \
+            apli_stat_inc(map_probes); \
             /* if(#key_type[0] == 'i') { \
                 printf("match.hash{%zu} == key_hash{%zu} IS %d\n", match.hash, key_hash, match.hash == key_hash); \
                 printf("map->key_eq(match.key, key) IS %zu\n", map->key_eq(match.key, key)); \
@@ -225,6 +235,7 @@
     \
     List(_##key_type##_##value_type##_map_match_t)* _##key_type##_##value_type##_map_get_list_( \
         _##key_type##_##value_type##_map_t *map) { \
+        apli_alloc_push_tag(APLI_ALLOC_MAPS); \
         List(_##key_type##_##value_type##_map_match_t)* matches = list_new(_##key_type##_##value_type##_map_match_t); \
         size_t buckets_size = vector_size(map->buckets); \
         for(size_t ind = 0; ind < buckets_size; ++ind) { \
@@ -237,6 +248,7 @@
                 } \
             } \
         } \
+        apli_alloc_pop_tag(); \
         return matches; \
     } \
     \
@@ -262,9 +274,11 @@
     }; \
     \
     _##key_type##_##value_type##_map_t* _##key_type##_##value_type##_new_map() { \
+        apli_alloc_push_tag(APLI_ALLOC_MAPS); \
         _##key_type##_##value_type##_map_t *map = (_##key_type##_##value_type##_map_t*) malloc(sizeof(_##key_type##_##value_type##_map_t)); \
         map->buckets = vector_new(_##key_type##_##value_type##_map_match_list_t); \
         vector_push_back(map->buckets, NULL); \
+        apli_alloc_pop_tag(); \
         map->size = 0; \
         map->fns = &_##key_type##_##value_type##_map_v_table_; \
         map->hash = &_default_##key_type##_##value_type##_map_hash_; \
@@ -2,6 +2,7 @@
 #define SET_H
 
 #include <stdlib.h>
+#include "alloc.h"
 #include <assert.h>
 #include "vector.h"
 #include "list.h"
@@ -0,0 +1,116 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stdlib.h>
+#include <sched.h>
+#include "alloc.h"
+
+/**
+ * A bounded, lock-free queue between exactly one producer thread and one consumer thread.
+ *
+ * The buffer is a ring whose capacity is rounded up to a power of two. The producer only
+ * writes `_tail` and the consumer only writes `_head` (each published with release / read
+ * with acquire ordering), so neither side takes a lock. Values are pushed and popped in
+ * batches to amortize the synchronization; a full (or empty) queue makes the producer (or
+ * consumer) yield until the other side catches up. Once the producer closes the queue, the
+ * consumer drains the remaining values and then receives 0.
+ *
+ * ----- Usage -----
+ *   define_spsc_queue(type);
+ *   SpscQueue(type) *queue = spsc_queue_new(type, capacity);
+ *     - spsc_queue_push(queue, val)                -> void (producer)
+ *     - spsc_queue_push_batch(queue, vals, n)      -> void (producer)
+ *     - spsc_queue_close(queue)                    -> void (producer)
+ *     - spsc_queue_pop_batch(queue, out, max)      -> size_t (consumer; 0 once closed and drained)
+ *     - spsc_queue_free(queue)                     -> void
+ */
+
+#define SpscQueue(TYPE)                         _##TYPE##_spsc_queue_t
+#define spsc_queue_new(TYPE, capacity)          (_new_##TYPE##_spsc_queue((capacity)))
+#define spsc_queue_push(queue, val)             ((queue)->_fns->push_batch((queue), &(val), 1))
+#define spsc_queue_push_batch(queue, vals, n)   ((queue)->_fns->push_batch((queue), (vals), (n)))
+#define spsc_queue_close(queue)                 ((queue)->_fns->close((queue)))
+#define spsc_queue_pop_batch(queue, out, max)   ((queue)->_fns->pop_batch((queue), (out), (max)))
+#define spsc_queue_free(queue)                  ((queue)->_fns->destroy((queue)))
+
+#define SPSC_QUEUE_CACHE_LINE 64
+
+#define define_spsc_queue(TYPE) \
+    struct _##TYPE##_spsc_queue_; \
+    typedef struct _##TYPE##_spsc_queue_fns_ { \
+        void (*push_batch)(struct _##TYPE##_spsc_queue_*, const TYPE*, size_t); \
+        void (*close)(struct _##TYPE##_spsc_queue_*); \
+        size_t (*pop_batch)(struct _##TYPE##_spsc_queue_*, TYPE*, size_t); \
+        void (*destroy)(struct _##TYPE##_spsc_queue_*); \
+    } _##TYPE##_spsc_queue_fns_t; \
+    typedef struct _##TYPE##_spsc_queue_ { \
+        /* `_head` and `_tail` count values ever popped and pushed; they are padded apart so */ \
+        /* that the two threads do not write to the same cache line. */ \
+        size_t _head; \
+        char _head_padding[SPSC_QUEUE_CACHE_LINE - sizeof(size_t)]; \
+        size_t _tail; \
+        int _closed; \
+        char _tail_padding[SPSC_QUEUE_CACHE_LINE - sizeof(size_t) - sizeof(int)]; \
+        size_t _mask; \
+        TYPE *_buffer; \
+        _##TYPE##_spsc_queue_fns_t *_fns; \
+    } _##TYPE##_spsc_queue_t; \
+    void _##TYPE##_spsc_queue_push_batch(_##TYPE##_spsc_queue_t *queue, const TYPE *vals, size_t n) { \
+        size_t tail = queue->_tail; \
+        while(0 < n) { \
+            size_t free_slots; \
+            while(0 == (free_slots = queue->_mask + 1 - (tail - __atomic_load_n(&queue->_head, __ATOMIC_ACQUIRE)))) \
+                sched_yield(); \
+            size_t count = (n < free_slots) ? n : free_slots; \
+            for(size_t i = 0; i < count; ++i) \
+                queue->_buffer[(tail + i) & queue->_mask] = vals[i]; \
+            tail += count; \
+            vals += count; \
+            n -= count; \
+            __atomic_store_n(&queue->_tail, tail, __ATOMIC_RELEASE); \
+        } \
+    } \
+    void _##TYPE##_spsc_queue_close(_##TYPE##_spsc_queue_t *queue) { \
+        __atomic_store_n(&queue->_closed, 1, __ATOMIC_RELEASE); \
+    } \
+    size_t _##TYPE##_spsc_queue_pop_batch(_##TYPE##_spsc_queue_t *queue, TYPE *out, size_t max) { \
+        size_t head = queue->_head, available; \
+        for(;;) { \
+            /* Read `_closed` first: a producer closes only after its last push. */ \
+            int closed = __atomic_load_n(&queue->_closed, __ATOMIC_ACQUIRE); \
+            available = __atomic_load_n(&queue->_tail, __ATOMIC_ACQUIRE) - head; \
+            if(0 < available || closed) \
+                break; \
+            sched_yield(); \
+        } \
+        size_t count = (max < available) ? max : available; \
+        for(size_t i = 0; i < count; ++i) \
+            out[i] = queue->_buffer[(head + i) & queue->_mask]; \
+        __atomic_store_n(&queue->_head, head + count, __ATOMIC_RELEASE); \
+        return count; \
+    } \
+    void _##TYPE##_spsc_queue_destroy(_##TYPE##_spsc_queue_t *queue) { \
+        free(queue->_buffer); \
+        free(queue); \
+    } \
+    _##TYPE##_spsc_queue_fns_t _##TYPE##_spsc_queue_fns = { \
+        &_##TYPE##_spsc_queue_push_batch, \
+        &_##TYPE##_spsc_queue_close, \
+        &_##TYPE##_spsc_queue_pop_batch, \
+        &_##TYPE##_spsc_queue_destroy \
+    }; \
+    _##TYPE##_spsc_queue_t* _new_##TYPE##_spsc_queue(size_t capacity) { \
+        size_t size = 1; \
+        while(size < capacity) \
+            size <<= 1; \
+        _##TYPE##_spsc_queue_t *queue = (_##TYPE##_spsc_queue_t*) malloc(sizeof(_##TYPE##_spsc_queue_t)); \
+        queue->_head = 0; \
+        queue->_tail = 0; \
+        queue->_closed = 0; \
+        queue->_mask = size - 1; \
+        queue->_buffer = (TYPE*) malloc(sizeof(TYPE) * size); \
+        queue->_fns = &_##TYPE##_spsc_queue_fns; \
+        return queue; \
+    }
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Hot-path counters for the lexer, the parser, the maps and the evaluation dispatch.
+ *
+ * Compile with `-DAPLI_STATS` to enable them; otherwise every `apli_stat_*` macro expands
+ * to `((void) 0)`. The counters are plain (non-atomic) integers, so counts taken while regexes
+ * are compiled on several threads (`MULTITHREADED`) are approximate.
+ *
+ * ----- Usage -----
+ *   apli_stats_get()            -> apli_stats (a copy of the counters)
+ *   apli_stats_reset()          -> void
+ *   apli_stats_print(fp)        -> void
+ * With `APLI_STATS` defined, the counters are also printed to stderr when the program exits
+ * (unless the `APLI_STATS_QUIET` environment variable is set).
+ */
+
+#define APLI_STATS_MAX_DISPATCH_NAMES 64
+
+typedef struct _apli_stats_dispatch {
+    const char *name;
+    size_t count;
+} apli_stats_dispatch;
+
+typedef struct _apli_stats {
+    // lexer
+    size_t dfa_runs;                    // calls to `_flat_dfa_run_greedy`
+    size_t dfa_transitions;             // characters consumed by those runs
+    size_t dfa_begin_resets;            // missing transitions that reset the run to the begin state
+    size_t lazy_dfa_states;             // states determinized by lazy DFAs (`LAZY_DFA`)
+    size_t lazy_dfa_cache_resets;       // full lazy DFA caches that were cleared
+    size_t nfa_sim_runs;                // runs that simulated an NFA (see lexer/nfa_sim.h)
+    size_t regex_matches;               // matches returned by `regex_find_all`
+    size_t tokens;                      // tokens emitted by `_token_rules_tokenize`
+    size_t matches_discarded;           // matches overlapped by an earlier token
+    // parser
+    size_t reduce_attempts;             // calls to `_parser_reduce`
+    size_t reduce_rule_checks;          // rules compared against the top of the parse stack
+    size_t reductions;                  // successful reductions
+    size_t shifts;
+    // maps
+    size_t map_lookups;                 // `map_at` and `map_count`
+    size_t map_probes;                  // bucket entries visited by those lookups
+    size_t map_max_chain;               // longest bucket chain walked
+    // evaluation
+    size_t dispatches;
+    size_t dispatch_names_size;
+    apli_stats_dispatch dispatch_names[APLI_STATS_MAX_DISPATCH_NAMES];
+} apli_stats;
+
+#ifdef APLI_STATS
+
+apli_stats _apli_stats = {0};
+
+#define apli_stat_inc(counter)          (_apli_stats.counter += 1)
+#define apli_stat_add(counter, n)       (_apli_stats.counter += (n))
+#define apli_stat_max(counter, n) \
+    (_apli_stats.counter < (n) ? (_apli_stats.counter = (n)) : 0)
+#define apli_stat_dispatch(name)        _apli_stats_dispatch(name)
+
+// Counts an evaluation dispatch and returns `name`, so it can wrap the dispatch key.
+static inline const char *_apli_stats_dispatch(const char *name) {
+    _apli_stats.dispatches += 1;
+    size_t size = _apli_stats.dispatch_names_size;
+    for(size_t i = 0; i < size; ++i) {
+        apli_stats_dispatch *d = &_apli_stats.dispatch_names[i];
+        if(d->name == name || 0 == strcmp(d->name, name)) {
+            d->count += 1;
+            return name;
+        }
+    }
+    if(size < APLI_STATS_MAX_DISPATCH_NAMES) {
+        _apli_stats.dispatch_names[size].name = name;
+        _apli_stats.dispatch_names[size].count = 1;
+        _apli_stats.dispatch_names_size += 1;
+    }
+    return name;
+}
+
+#else
+
+// Statements, so that ie. `if(c) apli_stat_inc(x);` does not leave an empty body.
+#define apli_stat_inc(counter)          ((void) 0)
+#define apli_stat_add(counter, n)       ((void) 0)
+#define apli_stat_max(counter, n)       ((void) 0)
+#define apli_stat_dispatch(name)        (name)
+
+#endif
+
+#define apli_stats_get()        _apli_stats_get()
+#define apli_stats_reset()      _apli_stats_reset()
+#define apli_stats_print(fp)    _apli_stats_print(fp)
+
+static inline apli_stats _apli_stats_get() {
+#ifdef APLI_STATS
+    return _apli_stats;
+#else
+    apli_stats empty = {0};
+    return empty;
+#endif
+}
+
+static inline void _apli_stats_reset() {
+#ifdef APLI_STATS
+    memset(&_apli_stats, 0, sizeof(_apli_stats));
+#endif
+}
+
+static inline void _apli_stats_print(FILE *fp) {
+    apli_stats s = _apli_stats_get();
+    fprintf(fp, "--- APLI statistics ---\n");
+#ifndef APLI_STATS
+    fprintf(fp, "(compiled without -DAPLI_STATS)\n");
+#endif
+    fprintf(fp, "dfa runs:            %zu\n", s.dfa_runs);
+    fprintf(fp, "dfa transitions:     %zu\n", s.dfa_transitions);
+    fprintf(fp, "dfa begin resets:    %zu\n", s.dfa_begin_resets);
+    if(0 < s.lazy_dfa_states)
+        fprintf(fp, "lazy dfa states:     %zu (%zu cache resets)\n", s.lazy_dfa_states, s.lazy_dfa_cache_resets);
+    if(0 < s.nfa_sim_runs)
+        fprintf(fp, "nfa sim runs:        %zu\n", s.nfa_sim_runs);
+    fprintf(fp, "regex matches:       %zu\n", s.regex_matches);
+    fprintf(fp, "tokens:              %zu\n", s.tokens);
+    fprintf(fp, "matches discarded:   %zu\n", s.matches_discarded);
+    fprintf(fp, "shifts:              %zu\n", s.shifts);
+    fprintf(fp, "reduce attempts:     %zu (%zu rule checks)\n", s.reduce_attempts, s.reduce_rule_checks);
+    fprintf(fp, "reductions:          %zu\n", s.reductions);
+    fprintf(fp, "map lookups:         %zu\n", s.map_lookups);
+    fprintf(fp, "map probes:          %zu (%.2f per lookup, longest chain %zu)\n", s.map_probes,
+        s.map_lookups ? (double) s.map_probes / s.map_lookups : 0.0, s.map_max_chain);
+    fprintf(fp, "eval dispatches:     %zu\n", s.dispatches);
+    for(size_t i = 0; i < s.dispatch_names_size; ++i)
+        fprintf(fp, "  %-18s %zu\n", s.dispatch_names[i].name, s.dispatch_names[i].count);
+}
+
+#ifdef APLI_STATS
+static void _apli_stats_print_at_exit() {
+    const char *quiet = getenv("APLI_STATS_QUIET");
+    if(NULL == quiet || '\0' == quiet[0])
+        _apli_stats_print(stderr);
+}
+
+__attribute__((constructor)) static void _apli_stats_register() {
+    atexit(&_apli_stats_print_at_exit);
+}
+#endif
+
+#endif
@@ -0,0 +1,266 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/**
+ * A work-stealing pool of worker threads.
+ *
+ * Every worker owns a deque of tasks: it pushes and pops the tasks it submits itself at the
+ * back, and when its deque is empty it steals from the front of the others. Tasks submitted
+ * from outside the pool are spread over the deques round-robin. A task is a function pointer
+ * and an argument, and belongs to a `TaskGroup`; `thread_pool_wait` returns once every task of
+ * the group (including the tasks those tasks submitted to it) has run. A waiting thread runs
+ * queued tasks in the meantime, so tasks may submit and wait for subtasks without starving
+ * the pool.
+ *
+ * `thread_pool_default()` is a process-wide pool with one worker per online core (or
+ * `APLI_THREADS` workers, if that environment variable is set), created on first use and
+ * shut down at exit. The pool's own memory bypasses `APLI_ALLOC_TRACKING`.
+ *
+ * ----- Usage -----
+ *   ThreadPool *pool = thread_pool_new(num_threads); (0 -> one per core)
+ *   TaskGroup group = task_group_init();
+ *     - thread_pool_submit(pool, &group, fn: void (*)(void*), arg: void*)  -> void
+ *     - thread_pool_wait(pool, &group)                                     -> void
+ *     - thread_pool_size(pool)                                             -> size_t
+ *     - thread_pool_free(pool)                                             -> void (waits for the queued tasks)
+ *   thread_pool_default()                                                  -> ThreadPool*
+ */
+
+#define ThreadPool                              _thread_pool_t
+#define TaskGroup                               _task_group_t
+#define thread_pool_new(num_threads)            (_thread_pool_new((num_threads)))
+#define thread_pool_submit(pool, group, fn, arg) (_thread_pool_submit((pool), (group), (fn), (arg)))
+#define thread_pool_wait(pool, group)           (_thread_pool_wait((pool), (group)))
+#define thread_pool_size(pool)                  ((pool)->num_workers)
+#define thread_pool_free(pool)                  (_thread_pool_free((pool)))
+#define thread_pool_default()                   (_thread_pool_default())
+#define task_group_init()                       ((_task_group_t) {0})
+
+#define THREAD_POOL_DEQUE_INITIAL_CAPACITY 16
+
+typedef struct _task_group_ {
+    size_t pending;                 // submitted tasks that have not finished yet (atomic)
+} _task_group_t;
+
+typedef struct _thread_pool_task_ {
+    void (*fn)(void*);
+    void *arg;
+    _task_group_t *group;
+} _thread_pool_task_t;
+
+// A ring buffer of tasks; `front` is the oldest task, `front + size - 1` the newest.
+typedef struct _thread_pool_deque_ {
+    pthread_mutex_t lock;
+    _thread_pool_task_t *tasks;
+    size_t capacity;
+    size_t front;
+    size_t size;
+} _thread_pool_deque_t;
+
+typedef struct _thread_pool_ {
+    size_t num_workers;
+    pthread_t *workers;
+    _thread_pool_deque_t *deques;
+    size_t queued;                  // tasks in all deques (atomic)
+    size_t next_deque;              // round-robin counter for external submissions (atomic)
+    int stop;
+    // Idle workers and waiters sleep on `wake` until a task is queued or a group finishes.
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+} _thread_pool_t;
+
+// The pool the current thread works for, and its deque (external threads have none).
+static __thread _thread_pool_t *_thread_pool_current = NULL;
+static __thread size_t _thread_pool_worker_index = 0;
+
+static void _thread_pool_deque_push_back(_thread_pool_deque_t *dq, _thread_pool_task_t task) {
+    pthread_mutex_lock(&dq->lock);
+    if(dq->size == dq->capacity) {
+        size_t new_capacity = 2 * dq->capacity;
+        _thread_pool_task_t *tasks = (_thread_pool_task_t*) (malloc)(sizeof(_thread_pool_task_t) * new_capacity);
+        for(size_t i = 0; i < dq->size; ++i)
+            tasks[i] = dq->tasks[(dq->front + i) % dq->capacity];
+        (free)(dq->tasks);
+        dq->tasks = tasks;
+        dq->capacity = new_capacity;
+        dq->front = 0;
+    }
+    dq->tasks[(dq->front + dq->size) % dq->capacity] = task;
+    __atomic_store_n(&dq->size, dq->size + 1, __ATOMIC_RELAXED);   // peeked at without the lock
+    pthread_mutex_unlock(&dq->lock);
+}
+
+// Takes the newest task (`from_back`, the owner) or the oldest one (a thief).
+static int _thread_pool_deque_take(_thread_pool_deque_t *dq, int from_back, _thread_pool_task_t *task) {
+    if(0 == __atomic_load_n(&dq->size, __ATOMIC_RELAXED))
+        return 0;
+    pthread_mutex_lock(&dq->lock);
+    int found = 0 < dq->size;
+    if(found) {
+        if(from_back) {
+            *task = dq->tasks[(dq->front + dq->size - 1) % dq->capacity];
+        } else {
+            *task = dq->tasks[dq->front];
+            dq->front = (dq->front + 1) % dq->capacity;
+        }
+        __atomic_store_n(&dq->size, dq->size - 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&dq->lock);
+    return found;
+}
+
+// Pops from the current worker's own deque first, then steals from the others.
+static int _thread_pool_take(_thread_pool_t *pool, _thread_pool_task_t *task) {
+    int is_worker = (_thread_pool_current == pool);
+    size_t start = is_worker ? _thread_pool_worker_index : 0;
+    if(is_worker && _thread_pool_deque_take(&pool->deques[start], 1, task))
+        goto found;
+    for(size_t i = is_worker ? 1 : 0; i < pool->num_workers; ++i) {
+        if(_thread_pool_deque_take(&pool->deques[(start + i) % pool->num_workers], 0, task))
+            goto found;
+    }
+    return 0;
+found:
+    __atomic_sub_fetch(&pool->queued, 1, __ATOMIC_SEQ_CST);
+    return 1;
+}
+
+static void _thread_pool_run(_thread_pool_t *pool, _thread_pool_task_t task) {
+    task.fn(task.arg);
+    if(0 == __atomic_sub_fetch(&task.group->pending, 1, __ATOMIC_ACQ_REL)) {
+        pthread_mutex_lock(&pool->lock);
+        pthread_cond_broadcast(&pool->wake);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+static void *_thread_pool_worker(void *arg) {
+    _thread_pool_t *pool = (_thread_pool_t*) arg;
+    _thread_pool_current = pool;
+    // Wait for `_thread_pool_new` to finish filling `workers`.
+    pthread_mutex_lock(&pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+    for(size_t i = 0; i < pool->num_workers; ++i) {
+        if(pthread_equal(pool->workers[i], pthread_self()))
+            _thread_pool_worker_index = i;
+    }
+    for(;;) {
+        _thread_pool_task_t task;
+        if(_thread_pool_take(pool, &task)) {
+            _thread_pool_run(pool, task);
+            continue;
+        }
+        pthread_mutex_lock(&pool->lock);
+        while(!pool->stop && 0 == __atomic_load_n(&pool->queued, __ATOMIC_SEQ_CST))
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        int stop = pool->stop && 0 == __atomic_load_n(&pool->queued, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&pool->lock);
+        if(stop)
+            return NULL;
+        // Another thread may be between taking a task and updating `queued`.
+        sched_yield();
+    }
+}
+
+_thread_pool_t *_thread_pool_new(size_t num_threads) {
+    if(0 == num_threads) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = (0 < cores) ? (size_t) cores : 1;
+    }
+    _thread_pool_t *pool = (_thread_pool_t*) (malloc)(sizeof(_thread_pool_t));
+    pool->num_workers = num_threads;
+    pool->workers = (pthread_t*) (malloc)(sizeof(pthread_t) * num_threads);
+    pool->deques = (_thread_pool_deque_t*) (malloc)(sizeof(_thread_pool_deque_t) * num_threads);
+    pool->queued = 0;
+    pool->next_deque = 0;
+    pool->stop = 0;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    for(size_t i = 0; i < num_threads; ++i) {
+        _thread_pool_deque_t *dq = &pool->deques[i];
+        pthread_mutex_init(&dq->lock, NULL);
+        dq->tasks = (_thread_pool_task_t*) (malloc)(sizeof(_thread_pool_task_t) * THREAD_POOL_DEQUE_INITIAL_CAPACITY);
+        dq->capacity = THREAD_POOL_DEQUE_INITIAL_CAPACITY;
+        dq->front = 0;
+        dq->size = 0;
+    }
+    pthread_mutex_lock(&pool->lock);
+    for(size_t i = 0; i < num_threads; ++i)
+        pthread_create(&pool->workers[i], NULL, &_thread_pool_worker, pool);
+    pthread_mutex_unlock(&pool->lock);
+    return pool;
+}
+
+void _thread_pool_submit(_thread_pool_t *pool, _task_group_t *group, void (*fn)(void*), void *arg) {
+    _thread_pool_task_t task = {fn, arg, group};
+    __atomic_add_fetch(&group->pending, 1, __ATOMIC_ACQ_REL);
+    size_t index = (_thread_pool_current == pool)
+        ? _thread_pool_worker_index
+        : __atomic_fetch_add(&pool->next_deque, 1, __ATOMIC_RELAXED) % pool->num_workers;
+    _thread_pool_deque_push_back(&pool->deques[index], task);
+    __atomic_add_fetch(&pool->queued, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_signal(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void _thread_pool_wait(_thread_pool_t *pool, _task_group_t *group) {
+    while(0 != __atomic_load_n(&group->pending, __ATOMIC_ACQUIRE)) {
+        _thread_pool_task_t task;
+        if(_thread_pool_take(pool, &task)) {
+            _thread_pool_run(pool, task);
+            continue;
+        }
+        pthread_mutex_lock(&pool->lock);
+        while(0 != __atomic_load_n(&group->pending, __ATOMIC_ACQUIRE)
+            && 0 == __atomic_load_n(&pool->queued, __ATOMIC_SEQ_CST))
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+void _thread_pool_free(_thread_pool_t *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+    for(size_t i = 0; i < pool->num_workers; ++i)
+        pthread_join(pool->workers[i], NULL);
+    for(size_t i = 0; i < pool->num_workers; ++i) {
+        pthread_mutex_destroy(&pool->deques[i].lock);
+        (free)(pool->deques[i].tasks);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->wake);
+    (free)(pool->deques);
+    (free)(pool->workers);
+    (free)(pool);
+}
+
+static _thread_pool_t *_thread_pool_default_pool = NULL;
+static pthread_once_t _thread_pool_default_once = PTHREAD_ONCE_INIT;
+
+static void _thread_pool_default_free() {
+    _thread_pool_free(_thread_pool_default_pool);
+}
+
+static void _thread_pool_default_init() {
+    const char *threads = getenv("APLI_THREADS");
+    size_t num_threads = (NULL != threads) ? (size_t) strtoul(threads, NULL, 10) : 0;
+    _thread_pool_default_pool = _thread_pool_new(num_threads);
+    atexit(&_thread_pool_default_free);
+}
+
+_thread_pool_t *_thread_pool_default() {
+    pthread_once(&_thread_pool_default_once, &_thread_pool_default_init);
+    return _thread_pool_default_pool;
+}
+
+#endif
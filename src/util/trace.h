@@ -0,0 +1,241 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+/**
+ * Scoped begin/end events for timelines of the lexer, the parser and the evaluator.
+ *
+ * Compile with `-DAPLI_TRACE` to build the trace points in; otherwise the `apli_trace_*`
+ * macros expand to `((void) 0)` (or 0). At runtime tracing is off unless the `APLI_TRACE_FILE`
+ * environment variable names an output file (or `apli_trace_enable` is called): a disabled
+ * trace point is a single branch on a global flag.
+ *
+ * Events are recorded into per-thread ring buffers of `APLI_TRACE_BUFFER_EVENTS` events (the
+ * oldest events are overwritten) and written as Chrome trace-event JSON, which can be opened
+ * in chrome://tracing or https://ui.perfetto.dev. With `-DAPLI_TRACE_USDT` every begin/end
+ * also fires a USDT probe (`apli:begin` / `apli:end`, arguments: category, name) for
+ * perf/bpftrace/systemtap, whether or not tracing is enabled at runtime.
+ *
+ * Evaluation (`apli_evaluate_node`) is traced down to `APLI_TRACE_EVAL_DEPTH` nested
+ * non-terminals (default: 2, ie. the whole program and each top-level form). Chains of the
+ * same non-terminal (ie. right-recursive `s_expressions`) count as one level and are only
+ * recorded once.
+ *
+ * ----- Usage -----
+ *   apli_trace_begin(category, name)               -> void
+ *   apli_trace_begin_detail(category, name, str)   -> void (`str` is copied)
+ *   apli_trace_end(category, name)                 -> void
+ *   apli_trace_enable(path)                        -> void (written at exit)
+ *   apli_trace_write(path)                         -> size_t (# of events written)
+ *   apli_trace_reset_eval()                        -> void (after a longjmp out of an evaluation)
+ */
+
+#ifndef APLI_TRACE_BUFFER_EVENTS
+#define APLI_TRACE_BUFFER_EVENTS (1UL << 16)
+#endif
+
+#ifndef APLI_TRACE_EVAL_DEPTH
+#define APLI_TRACE_EVAL_DEPTH 2
+#endif
+
+#define APLI_TRACE_DETAIL_LENGTH 40
+
+#ifdef APLI_TRACE
+
+#ifdef APLI_TRACE_USDT
+#include <sys/sdt.h>
+#define _apli_trace_usdt(probe, category, name) DTRACE_PROBE2(apli, probe, category, name)
+#else
+#define _apli_trace_usdt(probe, category, name)
+#endif
+
+typedef struct _apli_trace_event {
+    const char *category;
+    const char *name;
+    unsigned long long ts_ns;
+    char phase;
+    char detail[APLI_TRACE_DETAIL_LENGTH];
+} apli_trace_event;
+
+typedef struct _apli_trace_buffer {
+    apli_trace_event *events;
+    size_t size;                    // number of events ever recorded (the ring keeps the last ones)
+    size_t tid;
+    struct _apli_trace_buffer *next;
+} apli_trace_buffer;
+
+typedef struct _apli_trace_state {
+    int enabled;
+    const char *path;
+    apli_trace_buffer *buffers;
+    size_t num_buffers;
+    unsigned long long origin_ns;
+    pthread_mutex_t lock;
+} apli_trace_state;
+
+apli_trace_state _apli_trace = {0, NULL, NULL, 0, 0, PTHREAD_MUTEX_INITIALIZER};
+static __thread apli_trace_buffer *_apli_trace_local = NULL;
+// The enclosing traced non-terminal and the traced depth of the evaluation on this thread.
+static __thread const char *_apli_trace_eval_parent = NULL;
+static __thread size_t _apli_trace_eval_depth = 0;
+
+#define apli_trace_enabled()                            (_apli_trace.enabled)
+#define apli_trace_begin(category, name)                _apli_trace_record('B', category, name, NULL)
+#define apli_trace_begin_detail(category, name, str)    _apli_trace_record('B', category, name, str)
+#define apli_trace_end(category, name)                  _apli_trace_record('E', category, name, NULL)
+#define apli_trace_enable(path)                         _apli_trace_enable(path)
+#define apli_trace_disable()                            (_apli_trace.enabled = 0)
+#define apli_trace_write(path)                          _apli_trace_write(path)
+// Forgets the evaluations in progress on this thread (ie. after a longjmp out of them).
+#define apli_trace_reset_eval()                         (_apli_trace_eval_depth = 0, _apli_trace_eval_parent = NULL)
+
+static inline unsigned long long _apli_trace_now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static apli_trace_buffer *_apli_trace_new_buffer() {
+    apli_trace_buffer *buffer = (apli_trace_buffer*) (malloc)(sizeof(apli_trace_buffer));
+    buffer->events = (apli_trace_event*) (malloc)(sizeof(apli_trace_event) * APLI_TRACE_BUFFER_EVENTS);
+    buffer->size = 0;
+    pthread_mutex_lock(&_apli_trace.lock);
+    buffer->tid = ++_apli_trace.num_buffers;
+    buffer->next = _apli_trace.buffers;
+    _apli_trace.buffers = buffer;
+    pthread_mutex_unlock(&_apli_trace.lock);
+    return buffer;
+}
+
+static void _apli_trace_record_slow(char phase, const char *category, const char *name, const char *detail) {
+    if(NULL == _apli_trace_local)
+        _apli_trace_local = _apli_trace_new_buffer();
+    apli_trace_buffer *buffer = _apli_trace_local;
+    apli_trace_event *event = &buffer->events[buffer->size % APLI_TRACE_BUFFER_EVENTS];
+    event->category = category;
+    event->name = name;
+    event->ts_ns = _apli_trace_now_ns();
+    event->phase = phase;
+    event->detail[0] = '\0';
+    if(NULL != detail) {
+        strncpy(event->detail, detail, APLI_TRACE_DETAIL_LENGTH - 1);
+        event->detail[APLI_TRACE_DETAIL_LENGTH - 1] = '\0';
+    }
+    buffer->size += 1;
+}
+
+static inline void _apli_trace_record(char phase, const char *category, const char *name, const char *detail) {
+    if('B' == phase) {
+        _apli_trace_usdt(begin, category, name);
+    } else {
+        _apli_trace_usdt(end, category, name);
+    }
+    if(__builtin_expect(_apli_trace.enabled, 0))
+        _apli_trace_record_slow(phase, category, name, detail);
+}
+
+// Returns 1 (and records a begin event) iff the evaluation of `name` should be traced; the
+// caller passes the result to `_apli_trace_eval_end`.
+static inline int _apli_trace_eval_begin(const char *name, const char **parent) {
+    *parent = _apli_trace_eval_parent;
+    if(APLI_TRACE_EVAL_DEPTH <= _apli_trace_eval_depth || name == _apli_trace_eval_parent)
+        return 0;
+    _apli_trace_eval_parent = name;
+    _apli_trace_eval_depth += 1;
+    _apli_trace_record_slow('B', "eval", name, NULL);
+    return 1;
+}
+
+static inline void _apli_trace_eval_end(int traced, const char *name, const char *parent) {
+    if(!traced)
+        return;
+    _apli_trace_record_slow('E', "eval", name, NULL);
+    _apli_trace_eval_depth -= 1;
+    _apli_trace_eval_parent = parent;
+}
+
+static void _apli_trace_write_string(FILE *fp, const char *str) {
+    for(; '\0' != *str; ++str) {
+        if('"' == *str || '\\' == *str)
+            fprintf(fp, "\\%c", *str);
+        else if((unsigned char) *str < 0x20)
+            fprintf(fp, "\\u%04x", *str);
+        else
+            fputc(*str, fp);
+    }
+}
+
+static size_t _apli_trace_write(const char *path) {
+    FILE *fp = fopen(path, "w");
+    if(NULL == fp) {
+        fprintf(stderr, "apli_trace: could not open %s\n", path);
+        return 0;
+    }
+    size_t written = 0;
+    fprintf(fp, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    pthread_mutex_lock(&_apli_trace.lock);
+    for(apli_trace_buffer *buffer = _apli_trace.buffers; NULL != buffer; buffer = buffer->next) {
+        fprintf(fp, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %zu, "
+            "\"args\": {\"name\": \"%s %zu\"}}", written ? ",\n" : "", buffer->tid,
+            1 == buffer->tid ? "main" : "thread", buffer->tid);
+        written += 1;
+        size_t begin = (APLI_TRACE_BUFFER_EVENTS < buffer->size) ? buffer->size - APLI_TRACE_BUFFER_EVENTS : 0;
+        for(size_t i = begin; i < buffer->size; ++i) {
+            apli_trace_event *event = &buffer->events[i % APLI_TRACE_BUFFER_EVENTS];
+            fprintf(fp, ",\n{\"name\": \"");
+            _apli_trace_write_string(fp, event->name);
+            fprintf(fp, "\", \"cat\": \"%s\", \"ph\": \"%c\", \"ts\": %.3f, \"pid\": 1, \"tid\": %zu",
+                event->category, event->phase, (event->ts_ns - _apli_trace.origin_ns) / 1e3, buffer->tid);
+            if('\0' != event->detail[0]) {
+                fprintf(fp, ", \"args\": {\"detail\": \"");
+                _apli_trace_write_string(fp, event->detail);
+                fprintf(fp, "\"}");
+            }
+            fprintf(fp, "}");
+            written += 1;
+        }
+    }
+    pthread_mutex_unlock(&_apli_trace.lock);
+    fprintf(fp, "\n]}\n");
+    fclose(fp);
+    return written;
+}
+
+static void _apli_trace_write_at_exit() {
+    if(NULL != _apli_trace.path)
+        _apli_trace_write(_apli_trace.path);
+}
+
+static void _apli_trace_enable(const char *path) {
+    if(NULL == _apli_trace.path)
+        atexit(&_apli_trace_write_at_exit);
+    _apli_trace.path = path;
+    _apli_trace.origin_ns = _apli_trace_now_ns();
+    _apli_trace.enabled = 1;
+}
+
+__attribute__((constructor)) static void _apli_trace_init() {
+    const char *path = getenv("APLI_TRACE_FILE");
+    if(NULL != path && '\0' != path[0])
+        _apli_trace_enable(path);
+}
+
+#else
+
+#define apli_trace_enabled()                            0
+#define apli_trace_begin(category, name)                ((void) 0)
+#define apli_trace_begin_detail(category, name, str)    ((void) 0)
+#define apli_trace_end(category, name)                  ((void) 0)
+#define apli_trace_enable(path)                         ((void) 0)
+#define apli_trace_disable()                            ((void) 0)
+#define apli_trace_write(path)                          0UL
+#define apli_trace_reset_eval()                         ((void) 0)
+
+#endif
+
+#endif
@@ -2,6 +2,7 @@
 #define VECTOR_C
 
 #include <stdlib.h>
+#include "alloc.h"
 
 #define Vector(TYPE)                        _##TYPE##_vector_t
 #define vector_new(TYPE)                    (_new_##TYPE##_vector())
@@ -0,0 +1,307 @@
+#define LISP_NO_MAIN
+#include "../../evaluators/lisp/lisp.c"
+#include <dirent.h>
+#include <limits.h>
+#include <sys/stat.h>
+
+/**
+ * Per-phase benchmark for the lisp evaluator.
+ *
+ * Times the token rule construction (compiling the regexes at runtime vs. loading the cached
+ * DFAs), `token_rules_tokenize`, `bnf_rules_construct_parse_tree` and the evaluation of
+ * every `.lisp` file under the given paths, and reports the median, p95 and throughput of
+ * each phase. Run it from the root of the repository (see `./compile.sh benchmark`):
+ *
+ *   ./bench.out [-n iterations] [-o results.json] [-b baseline.json] [-t threshold%] [paths...]
+ *
+ * The default paths are `resources/lisp` and `test/integration/resources`. With `-b` the
+ * medians are compared against a previous `-o` output and the process exits with 1 if any
+ * phase got slower than the threshold (default: 10%). The JSON output has one result per
+ * line so that it can be diffed (and read back) without a JSON parser.
+ */
+
+#define BENCH_DEFAULT_ITERATIONS 10
+#define BENCH_DEFAULT_THRESHOLD  10.0
+#define BENCH_NOISE_FLOOR_MS     0.05   // differences below this are never flagged
+#define BENCH_MAX_RESULTS        1024
+#define BENCH_NAME_LENGTH        256
+
+typedef struct _bench_result {
+    char file[BENCH_NAME_LENGTH];
+    char phase[32];
+    size_t bytes;
+    double median_ms;
+    double p95_ms;
+    double mb_per_s;
+    size_t failed;
+} bench_result;
+
+bench_result bench_results[BENCH_MAX_RESULTS];
+size_t bench_results_size = 0;
+
+define_vector(double);
+
+int bench_double_cmp(const void *a, const void *b) {
+    double x = *(const double*) a, y = *(const double*) b;
+    return (x > y) - (x < y);
+}
+
+void bench_record(const char *file, const char *phase, size_t bytes, Vector(double) *samples, size_t failed) {
+    assert(bench_results_size < BENCH_MAX_RESULTS);
+    size_t n = vector_size(samples);
+    double *sorted = (double*) malloc(sizeof(double) * n);
+    for(size_t i = 0; i < n; ++i)
+        sorted[i] = vector_get(samples, i);
+    qsort(sorted, n, sizeof(double), &bench_double_cmp);
+
+    bench_result *r = &bench_results[bench_results_size++];
+    snprintf(r->file, sizeof(r->file), "%s", file);
+    snprintf(r->phase, sizeof(r->phase), "%s", phase);
+    r->bytes = bytes;
+    r->median_ms = (n % 2) ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+    r->p95_ms = sorted[(size_t) (0.95 * (n - 1) + 0.5)];
+    r->mb_per_s = (0 < bytes && 0 < r->median_ms) ? (bytes / 1e6) / (r->median_ms / 1e3) : 0;
+    r->failed = failed;
+    free(sorted);
+}
+
+double bench_elapsed_ms(unsigned long long begin) {
+    return (_gc_now_ns() - begin) / 1e6;
+}
+
+void bench_token_rules(size_t iterations) {
+    const char *phases[] = {"regex_load", "regex_compile"};
+    for(size_t compile = 0; compile < 2; ++compile) {
+        Vector(double) *samples = vector_new(double);
+        for(size_t i = 0; i <= iterations; ++i) {
+            token_rules_free(token_rules);
+            unsigned long long begin = _gc_now_ns();
+            lisp_init_token_rules(compile);
+            double elapsed = bench_elapsed_ms(begin);
+            if(0 < i)   // the first run is a warm-up
+                vector_push_back(samples, elapsed);
+        }
+        bench_record("<token rules>", phases[compile], 0, samples, 0);
+        vector_free(samples);
+    }
+    // Leave the default (cached) token rules in place for the file benchmarks.
+    token_rules_free(token_rules);
+    lisp_init_token_rules(0);
+}
+
+void bench_file(const char *path, size_t iterations, FILE *devnull) {
+    const char *input = ftoca(path);
+    size_t bytes = strlen(input);
+    Vector(double) *tokenize = vector_new(double);
+    Vector(double) *parse = vector_new(double);
+    Vector(double) *evaluate = vector_new(double);
+    volatile size_t failed = 0;
+
+    for(size_t i = 0; i <= iterations; ++i) {
+#ifdef ARENA_ALLOCATOR
+        size_t mark = _arena_mark();
+#endif
+        // Evaluation output (and error messages) are discarded.
+        FILE *real_stdout = stdout;
+        stdout = devnull;
+        lisp_output_set_stream(devnull);
+
+        jmp_buf error_jmp;
+        volatile double t_tokenize = 0, t_parse = 0, t_evaluate = 0;
+        volatile unsigned long long begin = 0;
+        volatile int stage = 0;
+        size_t tag_depth = apli_alloc_tag_depth();
+        lisp_error_jmp = &error_jmp;
+        if(0 == setjmp(error_jmp)) {
+            begin = _gc_now_ns();
+            script_tokens = token_rules_tokenize(token_rules, input);
+            t_tokenize = bench_elapsed_ms(begin);
+
+            stage = 1;
+            begin = _gc_now_ns();
+            parse_tree_result = bnf_rules_construct_parse_tree(bnf_rules, script_tokens, parser_type_inst);
+            has_parse_tree_result = 1;
+            t_parse = bench_elapsed_ms(begin);
+            list_free(script_tokens);
+            script_tokens = NULL;
+
+            stage = 2;
+            begin = _gc_now_ns();
+            lisp_evaluate_script();
+            t_evaluate = bench_elapsed_ms(begin);
+        } else {
+            // Scripts that stop on an error are still timed up to the error.
+            if(2 == stage)
+                t_evaluate = bench_elapsed_ms(begin);
+            failed = 1;
+        }
+        lisp_error_jmp = NULL;
+        apli_alloc_set_tag_depth(tag_depth);
+        apli_trace_reset_eval();
+
+        lisp_output_set_stream(real_stdout);
+        stdout = real_stdout;
+        lisp_release_script();
+#ifdef ARENA_ALLOCATOR
+        _arena_reset(mark);
+#endif
+
+        if(failed && stage < 2) {
+            fprintf(stderr, "%s: could not be parsed, skipping.\n", path);
+            vector_free(tokenize); vector_free(parse); vector_free(evaluate);
+            return;
+        }
+        if(0 == i)
+            continue;
+        vector_push_back(tokenize, t_tokenize);
+        vector_push_back(parse, t_parse);
+        vector_push_back(evaluate, t_evaluate);
+    }
+
+    bench_record(path, "tokenize", bytes, tokenize, 0);
+    bench_record(path, "parse", bytes, parse, 0);
+    bench_record(path, "evaluate", bytes, evaluate, failed);
+    vector_free(tokenize);
+    vector_free(parse);
+    vector_free(evaluate);
+}
+
+int bench_path_cmp(const void *a, const void *b) {
+    return strcmp(*(char* const*) a, *(char* const*) b);
+}
+
+// Collects every `.lisp` file under `path` (sorted, so that runs are comparable).
+void bench_collect(const char *path, char ***files, size_t *size, size_t *capacity) {
+    struct stat st;
+    if(0 != stat(path, &st)) {
+        fprintf(stderr, "%s: no such file or directory.\n", path);
+        return;
+    }
+    if(!S_ISDIR(st.st_mode)) {
+        size_t len = strlen(path);
+        if(len < 5 || 0 != strcmp(path + len - 5, ".lisp"))
+            return;
+        if(*size == *capacity) {
+            *capacity = 2 * *capacity + 8;
+            *files = (char**) realloc(*files, sizeof(char*) * *capacity);
+        }
+        (*files)[(*size)++] = strdup(path);
+        return;
+    }
+    DIR *dir = opendir(path);
+    struct dirent *entry;
+    while(NULL != (dir ? (entry = readdir(dir)) : NULL)) {
+        if('.' == entry->d_name[0])
+            continue;
+        char child[PATH_MAX];
+        if(sizeof(child) <= (size_t) snprintf(child, sizeof(child), "%s/%s", path, entry->d_name)) {
+            fprintf(stderr, "%s/%s: the path is too long, skipping.\n", path, entry->d_name);
+            continue;
+        }
+        bench_collect(child, files, size, capacity);
+    }
+    if(dir)
+        closedir(dir);
+}
+
+void bench_write_json(FILE *fp, size_t iterations) {
+    fprintf(fp, "{\n  \"iterations\": %zu,\n  \"results\": [\n", iterations);
+    for(size_t i = 0; i < bench_results_size; ++i) {
+        bench_result *r = &bench_results[i];
+        fprintf(fp, "    {\"file\": \"%s\", \"phase\": \"%s\", \"bytes\": %zu, \"median_ms\": %.4f, "
+            "\"p95_ms\": %.4f, \"mb_per_s\": %.3f, \"failed\": %zu}%s\n",
+            r->file, r->phase, r->bytes, r->median_ms, r->p95_ms, r->mb_per_s, r->failed,
+            (i + 1 < bench_results_size) ? "," : "");
+    }
+    fprintf(fp, "  ]\n}\n");
+}
+
+// Returns the number of phases that regressed by more than `threshold` percent.
+size_t bench_compare(const char *baseline_path, double threshold) {
+    FILE *fp = fopen(baseline_path, "r");
+    if(NULL == fp) {
+        fprintf(stderr, "%s: could not open the baseline.\n", baseline_path);
+        return 0;
+    }
+    size_t regressions = 0;
+    char line[1024], file[BENCH_NAME_LENGTH], phase[32];
+    double median;
+    printf("\n%-64s %-14s %10s %10s %8s\n", "file", "phase", "base (ms)", "now (ms)", "change");
+    while(NULL != fgets(line, sizeof(line), fp)) {
+        if(3 != sscanf(line, " {\"file\": \"%255[^\"]\", \"phase\": \"%31[^\"]\", \"bytes\": %*u, \"median_ms\": %lf",
+                file, phase, &median))
+            continue;
+        for(size_t i = 0; i < bench_results_size; ++i) {
+            bench_result *r = &bench_results[i];
+            if(0 != strcmp(r->file, file) || 0 != strcmp(r->phase, phase))
+                continue;
+            double change = (0 < median) ? 100.0 * (r->median_ms - median) / median : 0;
+            size_t regressed = threshold < change && BENCH_NOISE_FLOOR_MS < r->median_ms - median;
+            regressions += regressed;
+            printf("%-64s %-14s %10.3f %10.3f %+7.1f%%%s\n", file, phase, median, r->median_ms, change,
+                regressed ? "  REGRESSION" : "");
+        }
+    }
+    fclose(fp);
+    return regressions;
+}
+
+int main(int argc, char **argv) {
+    _initialize_memory();
+
+    size_t iterations = BENCH_DEFAULT_ITERATIONS;
+    double threshold = BENCH_DEFAULT_THRESHOLD;
+    const char *output_path = NULL, *baseline_path = NULL;
+    char **files = NULL;
+    size_t files_size = 0, files_capacity = 0, num_paths = 0;
+
+    for(int i = 1; i < argc; ++i) {
+        if(0 == strcmp("-n", argv[i]) && i + 1 < argc)
+            iterations = strtoull(argv[++i], NULL, 10);
+        else if(0 == strcmp("-o", argv[i]) && i + 1 < argc)
+            output_path = argv[++i];
+        else if(0 == strcmp("-b", argv[i]) && i + 1 < argc)
+            baseline_path = argv[++i];
+        else if(0 == strcmp("-t", argv[i]) && i + 1 < argc)
+            threshold = strtod(argv[++i], NULL);
+        else {
+            bench_collect(argv[i], &files, &files_size, &files_capacity);
+            num_paths += 1;
+        }
+    }
+    if(0 == num_paths) {
+        bench_collect("resources/lisp", &files, &files_size, &files_capacity);
+        bench_collect("test/integration/resources", &files, &files_size, &files_capacity);
+    }
+    if(0 == iterations)
+        iterations = 1;
+    qsort(files, files_size, sizeof(char*), &bench_path_cmp);
+
+    lisp_init();
+    parser_set_error_handler(&lisp_fail);
+    FILE *devnull = fopen("/dev/null", "w");
+
+    bench_token_rules(iterations);
+    for(size_t i = 0; i < files_size; ++i)
+        bench_file(files[i], iterations, devnull);
+
+    printf("%-64s %-14s %10s %10s %10s\n", "file", "phase", "median (ms)", "p95 (ms)", "MB/s");
+    for(size_t i = 0; i < bench_results_size; ++i) {
+        bench_result *r = &bench_results[i];
+        printf("%-64s %-14s %10.3f %10.3f %10.2f%s\n", r->file, r->phase, r->median_ms, r->p95_ms,
+            r->mb_per_s, r->failed ? "  (stopped on an error)" : "");
+    }
+
+    if(NULL != output_path) {
+        FILE *fp = fopen(output_path, "w");
+        bench_write_json(fp, iterations);
+        fclose(fp);
+    }
+
+    size_t regressions = 0;
+    if(NULL != baseline_path) {
+        regressions = bench_compare(baseline_path, threshold);
+        printf("\n%zu phase(s) regressed by more than %.1f%%.\n", regressions, threshold);
+    }
+    return regressions ? 1 : 0;
+}
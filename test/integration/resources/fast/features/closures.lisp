@@ -0,0 +1,10 @@
+(defun make-adder (n) (lambda (x) (+ x n)))
+(defun spin (n)
+    (if (= n 0)
+        0
+        (let ((adder (make-adder n)))
+            (progn
+                (write (funcall adder 1))
+                (terpri)
+                (spin (- n 1))))))
+(spin 50)
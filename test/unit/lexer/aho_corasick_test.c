@@ -0,0 +1,108 @@
+#include "../testlib/testlib.h"
+#include <stdio.h>
+#include <string.h>
+#include "../../../src/lexer/lexer.h"
+#include "../testlib/lexer_testlib.h"
+
+#define NUM_INPUTS 500
+#define MAX_INPUT 40
+#define NUM_LITERALS 7
+#define NUM_RULES 5
+
+const char *literals[NUM_LITERALS] = {"a", "aa", "aba", "ab", "b", "bab", "aa"};
+
+// Token rules of literals, and the same rules written so that they are not literals.
+const char *names[NUM_RULES] = {"BA", "A", "B", "NEWLINE", "PLUS"};
+const char *literal_rules[NUM_RULES] = {"ba+", "a", "b", "\\n", "\\+"};
+const char *disguised_rules[NUM_RULES] = {"ba+", "(a)", "(b)", "[\n]", "[+]"};
+
+// The leftmost non-overlapping occurrences of `literal` in `input`.
+List(_regex_match_t) *naive_find_all(const char *literal, const char *input) {
+    List(_regex_match_t) *matches = list_new(_regex_match_t);
+    for(const char *ptr = strstr(input, literal); NULL != ptr; ptr = strstr(ptr + strlen(literal), literal)) {
+        _regex_match_t match = {(size_t) (ptr - input), strlen(literal)};
+        list_push_back(matches, match);
+    }
+    return matches;
+}
+
+int main() {
+    srand(45);
+    // Every literal's matches are its leftmost non-overlapping occurrences.
+    AhoCorasick *ac = aho_corasick_new();
+    for(size_t k = 0; k < NUM_LITERALS; ++k)
+        assertTrue(k == aho_corasick_add(ac, literals[k], strlen(literals[k])));
+    assertTrue(NUM_LITERALS == aho_corasick_size(ac));
+    aho_corasick_build(ac);
+    size_t failures = 0;
+    char input[MAX_INPUT + 1];
+    for(size_t n = 0; n < NUM_INPUTS; ++n) {
+        random_string(input, rand() % (MAX_INPUT + 1), "ab\n");
+        List(_regex_match_t) *matches[NUM_LITERALS];
+        for(size_t k = 0; k < NUM_LITERALS; ++k)
+            matches[k] = list_new(_regex_match_t);
+        aho_corasick_find_all(ac, input, strlen(input), matches);
+        for(size_t k = 0; k < NUM_LITERALS; ++k) {
+            List(_regex_match_t) *expected = naive_find_all(literals[k], input);
+            failures += !same_matches(expected, matches[k]);
+            list_free(expected);
+            list_free(matches[k]);
+        }
+    }
+    assertTrue(0 == failures);
+    aho_corasick_free(ac);
+
+    // Rules of literals tokenize as the same rules that are not literals.
+    TokenRules *with_literals = token_rules_new(), *without_literals = token_rules_new();
+    for(size_t i = 0; i < NUM_RULES; ++i) {
+        token_rules_add_rule(with_literals, names[i], literal_rules[i]);
+        token_rules_add_rule(without_literals, names[i], disguised_rules[i]);
+    }
+    for(size_t i = 0; i < NUM_RULES; ++i) {
+        assertTrue((0 != i) == (NULL != vector_get(with_literals->rules, i).literal));
+        assertTrue(NULL == vector_get(without_literals->rules, i).literal);
+    }
+    token_rules_compile(with_literals);
+    token_rules_compile(without_literals);
+    failures = 0;
+    for(size_t n = 0; n < NUM_INPUTS; ++n) {
+        random_string(input, rand() % (MAX_INPUT + 1), "ab\n+");
+        List(_token_t) *expected = token_rules_tokenize(without_literals, input);
+        List(_token_t) *tokens = token_rules_tokenize(with_literals, input);
+        List(_token_t) *streamed = stream_tokens(with_literals, input);
+        failures += !same_tokens(expected, tokens) + !same_tokens(expected, streamed);
+        list_free(expected);
+        list_free(tokens);
+        list_free(streamed);
+    }
+    assertTrue(0 == failures);
+    token_rules_free(with_literals);
+    token_rules_free(without_literals);
+
+    // Keywords rename the tokens of their rule whose text is the keyword.
+    TokenRules *tr = token_rules_new();
+    token_rules_add_rule(tr, "IDENT", "[a-z]+");
+    token_rules_add_rule(tr, "OPEN_PAREN", "\\(");
+    token_rules_add_rule(tr, "CLOSE_PAREN", "\\)");
+    const char *keywords[] = {"if", "else", "while", "for", "return", "let", "lambda", "define", "cond",
+        "and", "or", "not", "begin", "set", "quote", "do", "case", "when", "unless"};
+    for(size_t k = 0; k < sizeof(keywords) / sizeof(keywords[0]); ++k)
+        token_rules_add_keyword(tr, 0 == k ? "IF" : 1 == k ? "ELSE" : "KEYWORD", keywords[k], "IDENT");
+    token_rules_compile(tr);
+    const char *program = "(if iffy (else) els (unless x) if)";
+    const char *expected_names[] = {"OPEN_PAREN", "IF", "IDENT", "OPEN_PAREN", "ELSE", "CLOSE_PAREN",
+        "IDENT", "OPEN_PAREN", "KEYWORD", "IDENT", "CLOSE_PAREN", "IF", "CLOSE_PAREN"};
+    List(_token_t) *tokens = token_rules_tokenize(tr, program);
+    List(_token_t) *streamed = stream_tokens(tr, program);
+    assertTrue(13 == list_size(tokens));
+    assertTrue(same_tokens(tokens, streamed));
+    failures = 0;
+    size_t k = 0;
+    for(Iterator(_token_t) *iter = list_get_iterator(tokens); iter_is_not_null(iter); iter = iter_next(iter))
+        failures += (0 != strcmp(expected_names[k++], iter_val(iter).name));
+    assertTrue(0 == failures);
+    list_free(tokens);
+    list_free(streamed);
+    token_rules_free(tr);
+    return 0;
+}
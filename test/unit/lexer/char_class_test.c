@@ -0,0 +1,117 @@
+#include "../testlib/testlib.h"
+#include <stdio.h>
+#include <string.h>
+#include "../../../src/lexer/lexer.h"
+#include "../testlib/lexer_testlib.h"
+
+#define NUM_INPUTS 2000
+#define MAX_INPUT 16
+
+Vector(char) *new_alphabet() {
+    Vector(char) *alphabet = vector_new(char);
+    for(int i = 0; i < 128; ++i)
+        vector_push_back(alphabet, i);
+    return alphabet;
+}
+
+_flat_dfa_t *to_flat_dfa(Nfa(size_t, char) *nfa) {
+    Vector(char) *alphabet = new_alphabet();
+    Dfa(size_t_set_ptr_t, char) *dfa = nfa_to_dfa(nfa, alphabet);
+    Dfa(size_t, char) *compressed_dfa = dfa_compress(dfa);
+    _flat_dfa_t *flat_dfa = flat_dfa_from_compressed_dfa(compressed_dfa);
+    dfa_free(dfa);
+    dfa_free(compressed_dfa);
+    vector_free(alphabet);
+    return flat_dfa;
+}
+
+// `[chars]+|x` (or `[^chars]+|x`), once with class edges and once with one edge per character.
+void test_class(const char *listed, char inverted) {
+    Nfa(size_t, char) *class_nfa = nfa_new(size_t, char, 0);
+    Nfa(size_t, char) *char_nfa = nfa_new(size_t, char, 0);
+    _nfa_char_class_t chars = nfa_char_class_empty(), live = nfa_char_class_empty();
+    for(size_t i = 0; '\0' != listed[i]; ++i)
+        nfa_char_class_insert(&chars, listed[i]);
+    for(int c = 0; c < 128; ++c)
+        if(inverted != nfa_char_class_count(&chars, c))
+            nfa_char_class_insert(&live, c);
+    _nfa_char_class_t dead = chars;
+    for(size_t i = 0; i < 2; ++i)
+        dead.bits[2 + i] = 0;
+    for(size_t from = 0; from < 2; ++from) {
+        nfa_add_class_transition(class_nfa, from, live, 1);
+        if(inverted)
+            nfa_add_dead_class_transition(class_nfa, from, dead);
+        for(int c = 0; c < 128; ++c)
+            if(inverted || nfa_char_class_count(&chars, c))
+                nfa_add_transition(char_nfa, from, (char) c, 1);
+        if(inverted)
+            for(size_t i = 0; '\0' != listed[i]; ++i)
+                nfa_remove_transition(char_nfa, from, listed[i], 1);
+    }
+    nfa_add_transition(class_nfa, 0, 'x', 2);
+    nfa_add_transition(char_nfa, 0, 'x', 2);
+    for(size_t state = 1; state < 3; ++state) {
+        nfa_add_accept_state(class_nfa, state);
+        nfa_add_accept_state(char_nfa, state);
+    }
+    _nfa_sim_t *class_sim = nfa_sim_from_nfa(class_nfa);
+    _nfa_sim_t *char_sim = nfa_sim_from_nfa(char_nfa);
+    _flat_dfa_t *class_dfa = to_flat_dfa(class_nfa);
+    _flat_dfa_t *char_dfa = to_flat_dfa(char_nfa);
+    // The subset construction straight into a flat DFA makes the same DFA.
+    Vector(char) *alphabet = new_alphabet();
+    _nfa_frozen_t *frozen = nfa_freeze(class_nfa, alphabet);
+    _flat_dfa_t *frozen_dfa = nfa_frozen_to_flat_dfa(frozen, 127);
+    assertTrue(NULL == nfa_frozen_to_flat_dfa(frozen, 1));
+    nfa_frozen_free(frozen);
+    vector_free(alphabet);
+    size_t failures = 0;
+    char input[MAX_INPUT + 1];
+    for(size_t k = 0; k < NUM_INPUTS; ++k) {
+        size_t sz = rand() % (MAX_INPUT + 1);
+        for(size_t i = 0; i < sz; ++i)
+            input[i] = random_char("abcxyz09-_\"\n", 4);
+        input[sz] = '\0';
+        size_t right_bound = dfa_run_greedy(char_dfa, input, sz);
+        failures += (right_bound != dfa_run_greedy(class_dfa, input, sz));
+        failures += (right_bound != dfa_run_greedy(frozen_dfa, input, sz));
+        failures += (nfa_sim_run_greedy(char_sim, input, sz) != nfa_sim_run_greedy(class_sim, input, sz));
+    }
+    assertTrue(0 == failures);
+    nfa_sim_free(class_sim);
+    nfa_sim_free(char_sim);
+    dfa_free(class_dfa);
+    dfa_free(char_dfa);
+    dfa_free(frozen_dfa);
+    nfa_free(class_nfa);
+    nfa_free(char_nfa);
+}
+
+int main() {
+    srand(7);
+    // The subset construction over class edges makes the same DFAs as one edge per character.
+    test_class("abc", 0);
+    test_class("abc", 1);
+    test_class("\"\n", 1);
+    test_class("0123456789xyz_", 0);
+    test_class("x", 1);
+
+    // Regexes whose classes overlap other edges out of the same states.
+    Regex *regex = regex_from("[a-z_][a-z0-9_]*");
+    regex_compile(regex);
+    assertTrue(regex_run(regex, "snake_case_9"));
+    assertTrue(!regex_run(regex, "999"));
+    regex_free(regex);
+    regex = regex_from("\"([^\"\\\\]|\\\\.)*\"");
+    regex_compile(regex);
+    assertTrue(regex_run(regex, "\"a \\\" b\" x"));
+    assertTrue(!regex_run(regex, "\"a b"));
+    regex_free(regex);
+    regex = regex_from("(x|[^x\n])+y");
+    regex_compile(regex);
+    assertTrue(regex_run(regex, "xaxby"));
+    assertTrue(!regex_run(regex, "xa\nb"));
+    regex_free(regex);
+    return 0;
+}
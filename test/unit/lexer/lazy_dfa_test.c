@@ -0,0 +1,105 @@
+#include "../testlib/testlib.h"
+#include <stdio.h>
+#include <string.h>
+#define LAZY_DFA
+#define LAZY_DFA_CACHE_STATES 16
+#include "../../../src/lexer/lexer.h"
+#include "../../../src/util/thread_pool.h"
+#include "../../../evaluators/lisp/lisp_regex_cache.h"
+#include "../testlib/lexer_testlib.h"
+
+#define NUM_RULES (sizeof(lisp_regex_cache) / sizeof(lisp_regex_cache[0]))
+#define NUM_INPUTS 300
+#define MAX_INPUT 24
+#define NUM_TASKS 8
+
+// The full DFA of `(a|b)*a(a|b){7}` has 512 states.
+#define BIG_REGEX "(a|b)*a(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)"
+
+// Where the longest match of BIG_REGEX in a string of 'a's and 'b's ends.
+size_t big_regex_expected(const char *str, size_t sz) {
+    size_t right_bound = ~0UL;
+    for(size_t end = 8; end <= sz; ++end)
+        if('a' == str[end - 8])
+            right_bound = end;
+    return right_bound;
+}
+
+typedef struct {
+    LazyDfa *dfa;
+    unsigned int seed;
+    size_t failures;
+} big_regex_task;
+
+void run_big_regex(void *arg) {
+    big_regex_task *task = (big_regex_task*) arg;
+    char str[64];
+    for(size_t n = 0; n < 200; ++n) {
+        size_t sz = rand_r(&task->seed) % sizeof(str);
+        for(size_t i = 0; i < sz; ++i)
+            str[i] = (rand_r(&task->seed) % 2) ? 'a' : 'b';
+        str[sz] = '\0';
+        task->failures += (big_regex_expected(str, sz) != lazy_dfa_run_greedy(task->dfa, str, sz));
+    }
+}
+
+int main() {
+    srand(41);
+    // Every lazy DFA runs as the DFA that was compiled in full (and cached).
+    TokenRules *tables = new_lisp_token_rules();
+    assertTrue(0 == token_rules_load_cache(tables, lisp_regex_cache));
+    TokenRules *lazy = new_lisp_token_rules();
+    token_rules_compile(lazy);
+    for(size_t i = 0; i < NUM_RULES; ++i) {
+        assertTrue(NULL == vector_get(lazy->rules, i).regex->forward_dfa);
+        assertTrue(1 == lazy_dfa_num_states(vector_get(lazy->rules, i).regex->forward_lazy_dfa));
+    }
+    char input[MAX_INPUT + 1];
+    for(size_t n = 0; n < NUM_INPUTS; ++n) {
+        size_t size = rand() % (MAX_INPUT + 1);
+        for(size_t j = 0; j < size; ++j)
+            input[j] = random_char(LISP_CHARACTERS, 8);
+        input[size] = '\0';
+        for(size_t i = 0; i < NUM_RULES; ++i) {
+            _regex_t *table = vector_get(tables->rules, i).regex, *regex = vector_get(lazy->rules, i).regex;
+            for(size_t sz = 0; sz <= size; ++sz) {
+                assertTrue(dfa_run_greedy(table->forward_dfa, input, sz)
+                    == lazy_dfa_run_greedy(regex->forward_lazy_dfa, input, sz));
+                assertTrue(dfa_run_greedy(table->backward_dfa, input, sz)
+                    == lazy_dfa_run_greedy(regex->backward_lazy_dfa, input, sz));
+            }
+        }
+    }
+    const char *program = "(define (f x) ; a comment\n  (+ x 1 \"str\\\"ing\")) (a . b)";
+    List(_token_t) *expected = token_rules_tokenize(tables, program);
+    List(_token_t) *tokens = token_rules_tokenize(lazy, program);
+    assertTrue(0 < list_size(expected));
+    assertTrue(same_tokens(expected, tokens));
+    list_free(tokens);
+    list_free(expected);
+    token_rules_free(lazy);
+    token_rules_free(tables);
+
+    // A DFA larger than the cache: the cache is reset until it thrashes, then the NFA is
+    // simulated. Runs on several threads share the DFA.
+    Regex *big = regex_from(BIG_REGEX);
+    regex_compile(big);
+    LazyDfa *dfa = big->forward_lazy_dfa;
+    assertTrue(0 == lazy_dfa_uses_nfa(dfa));
+    assertTrue(8 == lazy_dfa_run_greedy(dfa, "abbbbbbb", 8));
+    assertTrue(~0UL == lazy_dfa_run_greedy(dfa, "babbbbbb", 8));
+    big_regex_task tasks[NUM_TASKS];
+    TaskGroup group = task_group_init();
+    for(size_t i = 0; i < NUM_TASKS; ++i) {
+        big_regex_task task = {dfa, (unsigned int) i, 0};
+        tasks[i] = task;
+        thread_pool_submit(thread_pool_default(), &group, &run_big_regex, &tasks[i]);
+    }
+    thread_pool_wait(thread_pool_default(), &group);
+    for(size_t i = 0; i < NUM_TASKS; ++i)
+        assertTrue(0 == tasks[i].failures);
+    assertTrue(1 == lazy_dfa_uses_nfa(dfa));
+    assertTrue(regex_run(big, "bbbabababab"));
+    assertTrue(!regex_run(big, "bbbbbbbb"));
+    regex_free(big);
+}
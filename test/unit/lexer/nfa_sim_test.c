@@ -0,0 +1,106 @@
+#include "../testlib/testlib.h"
+#include <stdio.h>
+#include <string.h>
+#include "../../../src/lexer/lexer.h"
+#include "../../../evaluators/lisp/lisp_regex_cache.h"
+#include "../testlib/lexer_testlib.h"
+
+#define NUM_RULES (sizeof(lisp_regex_cache) / sizeof(lisp_regex_cache[0]))
+#define NUM_INPUTS 300
+#define MAX_INPUT 24
+
+// The full DFA of `(a|b)*a(a|b){n}` has 2^(n+1) states: 256 (past the budget, but an NFA of at
+// most 64 states) and 2^20 (an NFA of more than 64 states).
+#define SMALL_REGEX "(a|b)*a(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)"
+#define BIG_REGEX "(a|b)*a(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)" \
+    "(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)"
+
+// Where the longest match of `(a|b)*a(a|b){n}` in a string of 'a's and 'b's ends.
+size_t expected_right_bound(const char *str, size_t sz, size_t n) {
+    size_t right_bound = ~0UL;
+    for(size_t end = n + 1; end <= sz; ++end)
+        if('a' == str[end - n - 1])
+            right_bound = end;
+    return right_bound;
+}
+
+// Both ways of simulating `sim` return what the DFA of its NFA returns, forwards and on the
+// input reversed.
+void assert_runs_as(_nfa_sim_t *sim, _flat_dfa_t *dfa, const char *input, size_t sz) {
+    size_t right_bound = dfa_run_greedy(dfa, input, sz);
+    assertTrue(right_bound == nfa_sim_run_greedy(sim, input, sz));
+    assertTrue(right_bound == _nfa_sim_run_sets(sim, input, sz, 1));
+    char *rev = (char*) malloc(sz + 1);
+    for(size_t i = 0; i <= sz; ++i)
+        rev[i] = input[sz - i];
+    assertTrue(right_bound == nfa_sim_run_greedy_reverse(sim, rev + sz, sz));
+    assertTrue(right_bound == _nfa_sim_run_sets(sim, rev + sz, sz, -1));
+    assertTrue(right_bound == flat_dfa_run_greedy_reverse(dfa, rev + sz, sz));
+    free(rev);
+}
+
+void test_big_regex(const char *raw_regex, size_t n, size_t bit_parallel) {
+    Regex *regex = regex_from(raw_regex);
+    regex_compile(regex);
+    // Reversed, the regex is `(a|b){n}a(a|b)*`, whose DFA is small.
+    assertTrue(NULL == regex->forward_dfa && NULL != regex->forward_nfa_sim);
+    assertTrue(NULL != regex->backward_dfa && NULL == regex->backward_nfa_sim);
+    assertTrue(bit_parallel == nfa_sim_is_bit_parallel(regex->forward_nfa_sim));
+    size_t failures = 0;
+    char str[64];
+    for(size_t k = 0; k < 500; ++k) {
+        size_t sz = rand() % sizeof(str);
+        for(size_t i = 0; i < sz; ++i)
+            str[i] = (rand() % 2) ? 'a' : 'b';
+        str[sz] = '\0';
+        failures += (expected_right_bound(str, sz, n) != nfa_sim_run_greedy(regex->forward_nfa_sim, str, sz));
+    }
+    assertTrue(0 == failures);
+    char match[64] = "bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb";
+    match[3] = 'a';
+    List(_regex_match_t) *matches = regex_find_all(regex, match);
+    assertTrue(1 == list_size(matches));
+    assertTrue(0 == list_get_front(matches).begin && 4 + n == list_get_front(matches).length);
+    list_free(matches);
+    assertTrue(!regex_run(regex, "bbbbbbbbbbbbbbbbbbbbbbbbbbbbb"));
+    regex_free(regex);
+}
+
+int main() {
+    srand(42);
+    // The lisp regexes are within the budget: they get DFAs, and their NFAs simulate as them.
+    TokenRules *tables = token_rules_new();
+    for(size_t i = 0; i < NUM_RULES; ++i)
+        token_rules_add_rule(tables, lisp_regex_cache[i].name, lisp_regex_cache[i].raw_regex);
+    token_rules_compile(tables);
+    _nfa_sim_t *forward[NUM_RULES], *backward[NUM_RULES];
+    for(size_t i = 0; i < NUM_RULES; ++i) {
+        _regex_t *regex = vector_get(tables->rules, i).regex;
+        assertTrue(NULL != regex->forward_dfa && NULL == regex->forward_nfa_sim);
+        forward[i] = nfa_sim_from_nfa(regex->forward_nfa);
+        backward[i] = nfa_sim_from_nfa(regex->backward_nfa);
+    }
+    char input[MAX_INPUT + 1];
+    for(size_t n = 0; n < NUM_INPUTS; ++n) {
+        size_t size = rand() % (MAX_INPUT + 1);
+        for(size_t j = 0; j < size; ++j)
+            input[j] = random_char(LISP_CHARACTERS, 8);
+        input[size] = '\0';
+        for(size_t i = 0; i < NUM_RULES; ++i) {
+            _regex_t *regex = vector_get(tables->rules, i).regex;
+            for(size_t sz = 0; sz <= size; ++sz) {
+                assert_runs_as(forward[i], regex->forward_dfa, input, sz);
+                assert_runs_as(backward[i], regex->backward_dfa, input, sz);
+            }
+        }
+    }
+    for(size_t i = 0; i < NUM_RULES; ++i) {
+        nfa_sim_free(forward[i]);
+        nfa_sim_free(backward[i]);
+    }
+    token_rules_free(tables);
+
+    // Past the budget, the regexes run their NFAs.
+    test_big_regex(SMALL_REGEX, 7, 1);
+    test_big_regex(BIG_REGEX, 19, 0);
+}
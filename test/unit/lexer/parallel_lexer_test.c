@@ -0,0 +1,88 @@
+#include "../testlib/testlib.h"
+#include <stdio.h>
+#include <string.h>
+
+#define MULTITHREADED
+size_t parallel_threshold = 1;
+#define LEXER_PARALLEL_THRESHOLD parallel_threshold
+#define LEXER_MIN_CHUNK_SIZE 16
+#include "../../../src/lexer/lexer.h"
+#include "../testlib/lexer_testlib.h"
+
+// Pieces of lisp-like input; strings and comments hide parentheses and newlines.
+const char *pieces[] = {
+    "(", ")", ".", " ", "  ", "\n", "abc", "x-1", "<=", "+", "-", "\"a (b\"", "\"\\\"\"", "\"\n",
+    "; a comment (with parens) \"\n", ";;\n", "\"unterminated ( ", "42"
+};
+
+List(_token_t) *tokenize(TokenRules *tr, const char *input, size_t parallel) {
+    parallel_threshold = parallel ? 1 : ~0UL;
+    return token_rules_tokenize(tr, input);
+}
+
+TokenRules *lisp_token_rules() {
+    TokenRules *tr = token_rules_new();
+    token_rules_add_rule(tr, "COMMENT", ";[^\n]*");
+    token_rules_add_rule(tr, "ATOMIC_SYMBOL", "(\"([^\n\"]|\\\")*\"|[a-z0-9\\-]+|(<=|>=|[+-\\*/<>=]))");
+    token_rules_add_rule(tr, "OPEN_PAREN", "\\(");
+    token_rules_add_rule(tr, "CLOSE_PAREN", "\\)");
+    token_rules_add_rule(tr, "PERIOD", "\\.");
+    token_rules_compile(tr);
+    return tr;
+}
+
+int main() {
+    setenv("APLI_THREADS", "4", 1);
+    TokenRules *tr = lisp_token_rules();
+    // The same rules, with the comments skipped.
+    TokenRules *skipping = lisp_token_rules();
+    token_rules_skip(skipping, "COMMENT");
+
+    // Random inputs, split into many small chunks, give the same tokens as the serial lexer.
+    srand(7);
+    size_t num_pieces = sizeof(pieces) / sizeof(pieces[0]);
+    for(size_t round = 0; round < 40; ++round) {
+        size_t capacity = 500 + 250 * round, size = 0;
+        char *input = (char*) malloc(capacity + 64);
+        while(size < capacity) {
+            const char *piece = pieces[rand() % num_pieces];
+            strcpy(input + size, piece);
+            size += strlen(piece);
+        }
+        List(_token_t) *serial = tokenize(tr, input, 0);
+        List(_token_t) *parallel = tokenize(tr, input, 1);
+        assertTrueQuiet(0 < list_size(serial));
+        assertTrueQuiet(same_tokens(serial, parallel));
+        list_free(parallel);
+        // Skipped comments are the tokens that `_token_rules_ignore_token` removes.
+        _token_rules_ignore_token(serial, "COMMENT");
+        List(_token_t) *skipped[3] = {tokenize(skipping, input, 0), tokenize(skipping, input, 1), stream_tokens(skipping, input)};
+        for(size_t k = 0; k < 3; ++k) {
+            assertTrueQuiet(same_tokens(serial, skipped[k]));
+            list_free(skipped[k]);
+        }
+        list_free(serial);
+        free(input);
+    }
+
+    const char *program = "(define (f x) ; comment (\n  (+ x \"a ) string\" 1))\n";
+    size_t program_size = strlen(program), repeat = 200;
+    char *input = (char*) malloc(program_size * repeat + 1);
+    for(size_t i = 0; i < repeat; ++i)
+        memcpy(input + i * program_size, program, program_size);
+    input[program_size * repeat] = '\0';
+    List(_token_t) *tokens = tokenize(tr, input, 1);
+    assertTrue(14 * repeat == list_size(tokens));
+    Iterator(_token_t) *iter = list_get_iterator(tokens);
+    for(size_t i = 0; i < 14 * (repeat - 1) + 6; ++i)
+        iter = iter_next(iter);
+    assertTrue(0 == strcmp("COMMENT", iter_val(iter).name));
+    assertTrue(0 == strncmp("; comment (", iter_val(iter).ptr, 11));
+    list_free(tokens);
+    tokens = tokenize(skipping, input, 1);
+    assertTrue(13 * repeat == list_size(tokens));
+    list_free(tokens);
+    free(input);
+    token_rules_free(tr);
+    token_rules_free(skipping);
+}
@@ -0,0 +1,75 @@
+#include "../testlib/testlib.h"
+#include <stdio.h>
+#include <string.h>
+#include "../../../src/lexer/lexer.h"
+#include "../testlib/lexer_testlib.h"
+
+#define NUM_RULES 4
+
+const char *names[NUM_RULES] = {"COMMENT", "WORD", "OPEN_PAREN", "CLOSE_PAREN"};
+const char *regexes[NUM_RULES] = {";[^\n]*", "[a-z\"]+", "\\(", "\\)"};
+
+TokenRules *new_token_rules() {
+    TokenRules *tr = token_rules_new();
+    for(size_t i = 0; i < NUM_RULES; ++i)
+        token_rules_add_rule(tr, names[i], regexes[i]);
+    return tr;
+}
+
+int main() {
+    const char *input = "(ab (c) ; a \"comment\" (\n\"d\")";
+    TokenRules *compiled = new_token_rules();
+    token_rules_compile(compiled);
+    List(_token_t) *expected = token_rules_tokenize(compiled, input);
+    assertTrue(8 == list_size(expected));
+
+    // The header defines the cache and stamps every entry with the hash of its regex.
+    char *header = NULL;
+    size_t header_size = 0;
+    FILE *fp = open_memstream(&header, &header_size);
+    token_rules_write_cache(compiled, fp, "test");
+    fclose(fp);
+    char hash[32];
+    sprintf(hash, "0x%016zXUL", regex_source_hash(regexes[0]));
+    assertTrue(NULL != strstr(header, "static const _regex_cache_entry_t test_regex_cache[] = {"));
+    assertTrue(NULL != strstr(header, "{\"COMMENT\", \";[^\\n]*\", "));
+    assertTrue(NULL != strstr(header, hash));
+    free(header);
+
+    // The same cache in memory: every rule loads its DFAs.
+    RegexCacheEntry cache[NUM_RULES];
+    for(size_t i = 0; i < NUM_RULES; ++i) {
+        _regex_t *regex = vector_get(compiled->rules, i).regex;
+        RegexCacheEntry entry = {names[i], regexes[i], regex_source_hash(regexes[i]),
+            flat_dfa_serialize(regex->forward_dfa), flat_dfa_serialize(regex->backward_dfa)};
+        cache[i] = entry;
+    }
+    TokenRules *loaded = new_token_rules();
+    assertTrue(0 == token_rules_load_cache(loaded, cache));
+    List(_token_t) *tokens = token_rules_tokenize(loaded, input);
+    assertTrue(same_tokens(expected, tokens));
+    list_free(tokens);
+    token_rules_free(loaded);
+
+    // A rule whose regex changed since the cache was written, and a rule the cache does not know,
+    // are left to `token_rules_compile`.
+    regexes[1] = "[a-z\"]+!?";
+    TokenRules *stale = new_token_rules();
+    token_rules_add_rule(stale, "PERIOD", "\\.");
+    assertTrue(2 == token_rules_load_cache(stale, cache));
+    assertTrue(REGEX_COMPILED == vector_get(stale->rules, 0).regex->state);
+    assertTrue(REGEX_RAW_LOADED == vector_get(stale->rules, 1).regex->state);
+    assertTrue(REGEX_RAW_LOADED == vector_get(stale->rules, 4).regex->state);
+    token_rules_compile(stale);
+    tokens = token_rules_tokenize(stale, input);
+    assertTrue(same_tokens(expected, tokens));
+    list_free(tokens);
+    token_rules_free(stale);
+
+    for(size_t i = 0; i < NUM_RULES; ++i) {
+        free((void*) cache[i].forward);
+        free((void*) cache[i].backward);
+    }
+    list_free(expected);
+    token_rules_free(compiled);
+}
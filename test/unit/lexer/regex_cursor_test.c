@@ -0,0 +1,77 @@
+#include "../testlib/testlib.h"
+#include <stdio.h>
+#include <string.h>
+#include "../../../src/lexer/lexer.h"
+#include "../testlib/lexer_testlib.h"
+
+#define NUM_INPUTS 500
+#define MAX_INPUT 40
+#define BATCH_CAPACITY 3
+
+const char *regexes[] = {"a+", "ab|b", "(a|b)*c", "[^\n]+", "b(ab)*a?", "c", "(a|b)*a(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)"};
+
+// The matches of the search from the end of each match, on a string copied reversed (as
+// `regex_find_all` found them before the cursor).
+List(_regex_match_t) *expected_matches(Regex *regex, const char *input, size_t size) {
+    List(_regex_match_t) *matches = list_new(_regex_match_t);
+    char *rev_input = _regex_reverse_string(input, size);
+    _regex_find_matches_between(regex, input, rev_input, size, 0, size, matches);
+    free(rev_input);
+    return matches;
+}
+
+// The matches of the cursor are those matches, one at a time and in batches.
+size_t test_regex(Regex *regex) {
+    size_t failures = 0;
+    char input[MAX_INPUT + 1];
+    _regex_match_t batch[BATCH_CAPACITY];
+    for(size_t n = 0; n < NUM_INPUTS; ++n) {
+        size_t size = rand() % (MAX_INPUT + 1);
+        random_string(input, size, "abc\n");
+        List(_regex_match_t) *expected = expected_matches(regex, input, size);
+        // Neither walk reads past `size`, so the input need not end in '\0'.
+        input[size] = 'a';
+        RegexCursor cursor = regex_cursor_init();
+        Iterator(_regex_match_t) *iter = list_get_iterator(expected);
+        for(; iter_is_not_null(iter); iter = iter_next(iter)) {
+            failures += !regex_next_match(regex, input, size, &cursor);
+            failures += (iter_val(iter).begin != cursor.match.begin || iter_val(iter).length != cursor.match.length);
+        }
+        failures += regex_next_match(regex, input, size, &cursor);
+        RegexCursor batch_cursor = regex_cursor_init();
+        iter = list_get_iterator(expected);
+        size_t batch_size;
+        do {
+            batch_size = regex_next_matches(regex, input, size, &batch_cursor, batch, BATCH_CAPACITY);
+            for(size_t k = 0; k < batch_size; ++k, iter = iter_next(iter))
+                failures += (!iter_is_not_null(iter) || iter_val(iter).begin != batch[k].begin
+                    || iter_val(iter).length != batch[k].length);
+        } while(BATCH_CAPACITY == batch_size);
+        failures += iter_is_not_null(iter);
+        list_free(expected);
+    }
+    return failures;
+}
+
+int main() {
+    srand(48);
+    for(size_t i = 0; i < sizeof(regexes) / sizeof(regexes[0]); ++i) {
+        Regex *regex = regex_from(regexes[i]);
+        regex_compile(regex);
+        assertTrue(0 == test_regex(regex));
+        regex_free(regex);
+    }
+
+    // A cursor over part of a string.
+    Regex *regex = regex_from("[a-z]+");
+    regex_compile(regex);
+    const char *text = "one two three";
+    RegexCursor cursor = regex_cursor_init();
+    assertTrue(regex_next_match(regex, text, 6, &cursor));
+    assertTrue(0 == cursor.match.begin && 3 == cursor.match.length);
+    assertTrue(regex_next_match(regex, text, 6, &cursor));
+    assertTrue(4 == cursor.match.begin && 2 == cursor.match.length);
+    assertTrue(!regex_next_match(regex, text, 6, &cursor));
+    regex_free(regex);
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include "../testlib/testlib.h"
+#include <stdio.h>
+#include <string.h>
+#include "../../../src/lexer/lexer.h"
+#include "../../../evaluators/lisp/lisp_regex_cache.h"
+#include "../../../evaluators/lisp/lisp_regex_scanners.h"
+#include "../testlib/lexer_testlib.h"
+
+#define NUM_RULES (sizeof(lisp_regex_cache) / sizeof(lisp_regex_cache[0]))
+#define NUM_INPUTS 300
+#define MAX_INPUT 24
+
+// The lisp rules, with the DFAs of the cache.
+TokenRules *loaded_lisp_token_rules() {
+    TokenRules *tr = new_lisp_token_rules();
+    assertTrue(0 == token_rules_load_cache(tr, lisp_regex_cache));
+    return tr;
+}
+
+// A copy of `dfa` with one more state without transitions: the table runner indexes bytes >= 128
+// into the next state's row, which is past the end of the table for the last state.
+_flat_dfa_t *padded(_flat_dfa_t *dfa) {
+    _flat_dfa_t *copy = flat_dfa_new(dfa->state_size + 1);
+    memcpy(copy->transition, dfa->transition, dfa->state_size << _flat_dfa_offset_constant);
+    return copy;
+}
+
+// Mostly lisp characters, with some bytes >= 128 and some NULs.
+char random_byte() {
+    const char *alphabet = "();. \n\t\"ab1-+*'\\";
+    switch(rand() % 8) {
+        case 0:     return (char) (128 + rand() % 128);
+        case 1:     return (char) (rand() % 128);
+        default:    return alphabet[rand() % strlen(alphabet)];
+    }
+}
+
+int main() {
+    srand(40);
+    TokenRules *tables = loaded_lisp_token_rules();
+    TokenRules *scanned = loaded_lisp_token_rules();
+    assertTrue(0 == token_rules_load_scanners(scanned, lisp_regex_scanners));
+
+    // Every scanner returns exactly what its DFA table returns, in both directions.
+    _flat_dfa_t *forward[NUM_RULES], *backward[NUM_RULES];
+    for(size_t i = 0; i < NUM_RULES; ++i) {
+        forward[i] = padded(vector_get(tables->rules, i).regex->forward_dfa);
+        backward[i] = padded(vector_get(tables->rules, i).regex->backward_dfa);
+    }
+    char input[MAX_INPUT + 1];
+    for(size_t n = 0; n < NUM_INPUTS; ++n) {
+        size_t size = rand() % (MAX_INPUT + 1);
+        for(size_t j = 0; j < size; ++j)
+            input[j] = random_byte();
+        input[size] = '\0';
+        for(size_t i = 0; i < NUM_RULES; ++i) {
+            for(size_t sz = 0; sz <= size; ++sz) {
+                assertTrue(dfa_run_greedy(forward[i], input, sz) == lisp_regex_scanners[i].forward(input, sz));
+                assertTrue(dfa_run_greedy(backward[i], input, sz) == lisp_regex_scanners[i].backward(input, sz));
+            }
+        }
+    }
+    for(size_t i = 0; i < NUM_RULES; ++i) {
+        dfa_free(forward[i]);
+        dfa_free(backward[i]);
+    }
+
+    // Tokenizing with the scanners gives the same tokens.
+    const char *program = "(define (f x) ; a comment\n  (+ x 1.5 \"str\\\"ing\")) '(a . b)";
+    List(_token_t) *expected = token_rules_tokenize(tables, program);
+    List(_token_t) *tokens = token_rules_tokenize(scanned, program);
+    assertTrue(0 < list_size(expected));
+    assertTrue(same_tokens(expected, tokens));
+    list_free(tokens);
+    list_free(expected);
+
+    // The header defines one scanner per direction of every rule, stamped with its regex's hash.
+    char *header = NULL;
+    size_t header_size = 0;
+    FILE *fp = open_memstream(&header, &header_size);
+    token_rules_write_scanners(tables, fp, "test");
+    fclose(fp);
+    char entry[128];
+    sprintf(entry, "{\"%s\", 0x%016zXUL, _test_regex_scanner_0_forward, _test_regex_scanner_0_backward}",
+        lisp_regex_cache[0].name, lisp_regex_cache[0].source_hash);
+    assertTrue(NULL != strstr(header, "static const _regex_scanner_entry_t test_regex_scanners[] = {"));
+    assertTrue(NULL != strstr(header, entry));
+    free(header);
+
+    // A scanner whose regex changed is not attached.
+    TokenRules *stale = token_rules_new();
+    token_rules_add_rule(stale, lisp_regex_cache[0].name, "x");
+    for(size_t i = 1; i < NUM_RULES; ++i)
+        token_rules_add_rule(stale, lisp_regex_cache[i].name, lisp_regex_cache[i].raw_regex);
+    assertTrue(1 == token_rules_load_scanners(stale, lisp_regex_scanners));
+    assertTrue(NULL == vector_get(stale->rules, 0).regex->forward_scanner);
+    assertTrue(NULL != vector_get(stale->rules, 1).regex->forward_scanner);
+    token_rules_free(stale);
+
+    token_rules_free(scanned);
+    token_rules_free(tables);
+}
@@ -0,0 +1,170 @@
+#include "../testlib/testlib.h"
+#include <stdio.h>
+#include <string.h>
+#include "../../../src/lexer/lexer.h"
+#include "../testlib/lexer_testlib.h"
+
+#define NUM_INPUTS 300
+#define MAX_INPUT 24
+
+const char *regexes[] = {"[a-z]+", "[0-9]+", "ab", "a(b|0)*1", "^b", "a$", "\\(", "[^\n]*1", "a*", "^(a|b)+$"};
+
+// Whether the NFA of `sim` accepts all of str[begin .. end), by simulating it.
+size_t nfa_accepts(const _nfa_sim_t *sim, const char *str, size_t begin, size_t end) {
+    uint32_t *current = (uint32_t*) malloc(sizeof(uint32_t) * sim->num_states);
+    uint32_t *next = (uint32_t*) malloc(sizeof(uint32_t) * sim->num_states);
+    uint32_t *marks = (uint32_t*) calloc(sim->num_states, sizeof(uint32_t));
+    size_t size = 0;
+    int accept = 0, moved;
+    for(size_t k = sim->closure_begin[sim->begin_state]; k < sim->closure_begin[sim->begin_state + 1]; ++k) {
+        current[size++] = sim->closures[k];
+        accept |= sim->accept[sim->closures[k]];
+    }
+    for(size_t i = begin; i < end; ++i) {
+        size = _nfa_sim_step(sim, current, size, (unsigned char) str[i], next, marks, (uint32_t) (i - begin + 1), &accept, &moved);
+        uint32_t *swap = current;
+        current = next;
+        next = swap;
+    }
+    free(current);
+    free(next);
+    free(marks);
+    return accept;
+}
+
+size_t regex_matches_between(RegexSet *set, size_t k, const char *str, size_t len, size_t begin, size_t end) {
+    if(((set->left_rooted >> k) & 1) && 0 != begin)
+        return 0;
+    if(((set->right_rooted >> k) & 1) && len != end)
+        return 0;
+    return nfa_accepts(set->sims[k], str, begin, end);
+}
+
+uint64_t expected_matches(RegexSet *set, const char *str, size_t len) {
+    uint64_t found = 0;
+    for(size_t k = 0; k < regex_set_size(set); ++k)
+        for(size_t begin = 0; begin <= len; ++begin)
+            for(size_t end = begin; end <= len; ++end)
+                if(regex_matches_between(set, k, str, len, begin, end))
+                    found |= 1ULL << k;
+    return found;
+}
+
+// The longest non-empty match at `begin`, of the first regex that matches that much.
+size_t expected_match_at(RegexSet *set, const char *str, size_t len, size_t begin, size_t *length) {
+    for(size_t end = len; end > begin; --end) {
+        for(size_t k = 0; k < regex_set_size(set); ++k) {
+            if(regex_matches_between(set, k, str, len, begin, end)) {
+                *length = end - begin;
+                return k;
+            }
+        }
+    }
+    return ~0UL;
+}
+
+// Every way of running the set finds what its regexes find one at a time.
+size_t test_set(RegexSet *set) {
+    size_t failures = 0;
+    char input[MAX_INPUT + 1];
+    for(size_t n = 0; n < NUM_INPUTS; ++n) {
+        size_t len = rand() % (MAX_INPUT + 1);
+        random_string(input, len, "ab01 (\n\310");
+        failures += (expected_matches(set, input, len) != regex_set_matches(set, input, len));
+        for(size_t offset = 0; offset <= len; ++offset) {
+            _regex_match_t match;
+            size_t length = 0, id = expected_match_at(set, input, len, offset, &length);
+            size_t found = regex_set_match_at(set, input, len, offset, &match);
+            failures += (id != found);
+            failures += (~0UL != id && (offset != match.begin || length != match.length));
+            size_t begin = offset;
+            while(begin < len && ~0UL == (id = expected_match_at(set, input, len, begin, &length)))
+                ++begin;
+            found = regex_set_find(set, input, len, offset, &match);
+            failures += (id != found);
+            failures += (~0UL != id && (begin != match.begin || length != match.length));
+        }
+    }
+    return failures;
+}
+
+int main() {
+    srand(49);
+    RegexSet *set = regex_set_new();
+    for(size_t k = 0; k < sizeof(regexes) / sizeof(regexes[0]); ++k)
+        assertTrue(k == regex_set_add(set, regexes[k]));
+    regex_set_compile(set);
+    assertTrue(NULL != set->dfa);
+    assertTrue(0 == test_set(set));
+    regex_set_free(set);
+
+    // A product DFA past the state budget: every run determinizes its own states.
+    set = regex_set_new();
+    regex_set_add(set, "(a|b)*a(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)");
+    regex_set_add(set, "b0*1");
+    regex_set_add(set, "[ab]+");
+    regex_set_compile(set);
+    assertTrue(NULL == set->dfa);
+    assertTrue(0 == test_set(set));
+    regex_set_free(set);
+
+    // Classifying words, and the rules of a tokenizer.
+    set = regex_set_new();
+    regex_set_add(set, "^[0-9]+$");
+    regex_set_add(set, "^[a-z_][a-z0-9_]*$");
+    regex_set_add(set, "[0-9]");
+    regex_set_compile(set);
+    assertTrue(5 == regex_set_matches(set, "1234", 4));
+    assertTrue(6 == regex_set_matches(set, "snake_9", 7));
+    assertTrue(4 == regex_set_matches(set, "9lives", 6));
+    assertTrue(0 == regex_set_matches(set, "x-y", 3));
+    regex_set_free(set);
+
+    // A counted repetition is rejected, and leaves the set as it was.
+    set = regex_set_new();
+    assertTrue(0 == regex_set_add(set, "[0-9]{2,3}"));
+    assertTrue(REGEX_SET_ERROR == regex_set_add(set, "[0-9]{1,100}"));
+    assertTrue(REGEX_SET_ERROR == regex_set_add(set, "(a{1,50}b){1,3}"));
+    assertTrue(REGEX_SET_ERROR == regex_set_add(set, "((a){1,40}){1,40}"));
+    assertTrue(1 == regex_set_add(set, "x"));
+    regex_set_compile(set);
+    assertTrue(2 == regex_set_size(set));
+    assertTrue(3 == regex_set_matches(set, "x12", 3));
+    assertTrue(2 == regex_set_matches(set, "x1", 2));
+    regex_set_free(set);
+    set = regex_set_new();
+    regex_set_add(set, "define");
+    regex_set_add(set, "[a-z]+");
+    regex_set_add(set, "\\(");
+    regex_set_add(set, "\\)");
+    regex_set_compile(set);
+    const char *program = "(define definer)";
+    size_t expected_ids[] = {2, 0, 1, 3};
+    size_t expected_begins[] = {0, 1, 8, 15};
+    _regex_match_t match = {0, 0};
+    size_t failures = 0, k = 0;
+    for(size_t id; ~0UL != (id = regex_set_find(set, program, strlen(program), match.begin + match.length, &match)); ++k)
+        failures += (4 <= k || expected_ids[k] != id || expected_begins[k] != match.begin);
+    assertTrue(0 == failures && 4 == k);
+    regex_set_free(set);
+
+    // A large input is searched in one pass, with or without a match.
+    set = regex_set_new();
+    regex_set_add(set, "a*b");
+    regex_set_add(set, "[0-9]+");
+    regex_set_compile(set);
+    size_t size = 200000;
+    char *large = (char*) malloc(size + 1);
+    memset(large, 'a', size);
+    large[size] = '\0';
+    assertTrue(~0UL == regex_set_find(set, large, size, 0, &match));
+    large[size - 1] = '7';
+    assertTrue(1 == regex_set_find(set, large, size, 0, &match));
+    assertTrue(size - 1 == match.begin && 1 == match.length);
+    large[size - 1] = 'b';
+    assertTrue(0 == regex_set_find(set, large, size, 1, &match));
+    assertTrue(1 == match.begin && size - 1 == match.length);
+    free(large);
+    regex_set_free(set);
+    return 0;
+}
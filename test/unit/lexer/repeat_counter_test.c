@@ -0,0 +1,102 @@
+// Every repetition is counted, so that small bounds can be checked against their copies.
+#define REGEX_REPEAT_COPY_BUDGET 0
+
+#include "../testlib/testlib.h"
+#include <stdio.h>
+#include <string.h>
+#include "../../../src/lexer/lexer.h"
+#include "../testlib/lexer_testlib.h"
+
+#define NUM_INPUTS 300
+#define MAX_INPUT 30
+
+// A counted regex, and the same regex with its repetition written out.
+const char *regexes[][2] = {
+    {"a{3}", "aaa"},
+    {"a{1,3}", "aa?a?"},
+    {"(ab|c){2,4}", "(ab|c)(ab|c)(ab|c)?(ab|c)?"},
+    {"x(ab|c){2,}b", "x(ab|c)(ab|c)(ab|c)*b"},
+    {"[0-9]{1,}", "[0-9][0-9]*"},
+    {"^(a|b)*c{2,3}$", "^(a|b)*ccc?$"},
+    {"(a*b){2}a", "(a*b)(a*b)a"},
+    {"x[^x]{1,2}x", "x[^x][^x]?x"},
+    {"(a{2}b){1,2}c", "(aab)(aab)?c"},
+};
+
+// A counted regex finds and runs as its copies do.
+size_t test_regex(Regex *counted, Regex *copied) {
+    size_t failures = 0;
+    char input[MAX_INPUT + 1];
+    for(size_t n = 0; n < NUM_INPUTS; ++n) {
+        size_t size = rand() % (MAX_INPUT + 1);
+        random_string(input, size, "abcx0\n");
+        failures += (regex_run(counted, input) != regex_run(copied, input));
+        List(_regex_match_t) *expected = regex_find_all(copied, input);
+        List(_regex_match_t) *found = regex_find_all(counted, input);
+        failures += !same_matches(expected, found);
+        list_free(expected);
+        list_free(found);
+    }
+    return failures;
+}
+
+int main() {
+    srand(50);
+    for(size_t i = 0; i < sizeof(regexes) / sizeof(regexes[0]); ++i) {
+        Regex *counted = regex_from(regexes[i][0]);
+        Regex *copied = regex_from(regexes[i][1]);
+        regex_compile(counted);
+        regex_compile(copied);
+        assertTrue(NULL != counted->forward_nfa_sim && 0 < counted->forward_nfa_sim->num_counters);
+        assertTrue(0 == test_regex(counted, copied));
+        regex_free(counted);
+        regex_free(copied);
+    }
+
+    // Large bounds: the body is in the NFA once.
+    char digits[1102];
+    memset(digits, '7', 1101);
+    digits[1101] = '\0';
+    Regex *regex = regex_from("^[0-9]{1,1000}$");
+    regex_compile(regex);
+    assertTrue(32 > regex->forward_nfa_sim->num_states);
+    digits[1000] = '\0';
+    assertTrue(regex_run(regex, digits));
+    digits[1000] = '7';
+    assertTrue(!regex_run(regex, digits));
+    regex_free(regex);
+    regex = regex_from("[0-9]{1,1000}");
+    regex_compile(regex);
+    List(_regex_match_t) *matches = regex_find_all(regex, digits);
+    assertTrue(2 == list_size(matches));
+    assertTrue(0 == list_get_front(matches).begin && 1000 == list_get_front(matches).length);
+    // (the second match is found backwards from its end, as with copies)
+    assertTrue(101 == list_get_back(matches).begin && 1000 == list_get_back(matches).length);
+    list_free(matches);
+    regex_free(regex);
+    regex = regex_from("(ab|c){300,}d");
+    regex_compile(regex);
+    char text[1000] = "d";
+    for(size_t i = 0; i < 299; ++i)
+        strcat(text, (i % 2) ? "ab" : "c");
+    assertTrue(!regex_run(regex, "cd") && !regex_run(regex, strcat(text, "d")));
+    text[strlen(text) - 1] = '\0';
+    assertTrue(regex_run(regex, strcat(text, "cd")));
+    regex_free(regex);
+    // Counters do not nest: the outer repetition is copied, around the inner counter.
+    regex = regex_from("^(a{1,50}b){1,3}$");
+    assertTrue(NULL != regex_compile(regex));
+    assertTrue(regex_run(regex, "abaab") && !regex_run(regex, "abababab"));
+    regex_free(regex);
+    // A literal '{' is not a repetition.
+    regex = regex_from("^([{]x){1,100}$");
+    regex_compile(regex);
+    assertTrue(NULL != regex->forward_nfa_sim && 0 < regex->forward_nfa_sim->num_counters);
+    assertTrue(regex_run(regex, "{x{x") && !regex_run(regex, "{{"));
+    regex_free(regex);
+    // Copies that do not fit in an NFA do not compile.
+    regex = regex_from("((a){1,40}){1,200}");
+    assertTrue(NULL == regex_compile(regex));
+    regex_free(regex);
+    return 0;
+}
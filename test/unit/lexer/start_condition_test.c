@@ -0,0 +1,61 @@
+#include "../testlib/testlib.h"
+#include <stdio.h>
+#include <string.h>
+#include "../../../src/lexer/lexer.h"
+#include "../testlib/lexer_testlib.h"
+
+// Whether the tokens of `input` are named `names` and read `texts`, both when tokenized and
+// streamed.
+size_t tokenizes_as(TokenRules *tr, const char *input, size_t size, const char **names, const char **texts) {
+    List(_token_t) *tokens = token_rules_tokenize(tr, input);
+    List(_token_t) *streamed = stream_tokens(tr, input);
+    size_t same = (size == list_size(tokens)) && same_tokens(tokens, streamed);
+    size_t k = 0;
+    for(Iterator(_token_t) *iter = list_get_iterator(tokens); same && iter_is_not_null(iter); iter = iter_next(iter), ++k)
+        same = (0 == strcmp(names[k], iter_val(iter).name) && strlen(texts[k]) == iter_val(iter).length
+            && 0 == strncmp(texts[k], iter_val(iter).ptr, iter_val(iter).length));
+    list_free(tokens);
+    list_free(streamed);
+    return same;
+}
+
+int main() {
+    // Strings and comments are lexed by the rules of their own modes.
+    TokenRules *tr = token_rules_new();
+    token_rules_add_rule(tr, "OPEN_PAREN", "\\(");
+    token_rules_add_rule(tr, "CLOSE_PAREN", "\\)");
+    token_rules_add_rule(tr, "SYMBOL", "[a-z]+");
+    token_rules_add_rule_push(tr, "STRING_BEGIN", "\"", "STRING");
+    token_rules_add_rule_push(tr, "COMMENT_BEGIN", ";", "COMMENT");
+    token_rules_add_rule_pop(tr, "STRAY_NEWLINE", "\\n");
+    assertTrue(1 == token_rules_begin_mode(tr, "STRING"));
+    token_rules_add_rule(tr, "ESCAPE", "\\\\.");
+    token_rules_add_rule(tr, "CHARS", "[^\"\\\\]+");
+    token_rules_add_rule_pop(tr, "STRING_END", "\"");
+    assertTrue(2 == token_rules_begin_mode(tr, "COMMENT"));
+    token_rules_add_rule(tr, "COMMENT", "[^\n]+");
+    token_rules_add_rule_pop(tr, "COMMENT_END", "\\n");
+    assertTrue(0 == token_rules_begin_mode(tr, TOKEN_RULES_INITIAL_MODE));
+    token_rules_compile(tr);
+    const char *names[] = {"OPEN_PAREN", "SYMBOL", "STRING_BEGIN", "CHARS", "ESCAPE", "STRING_END",
+        "COMMENT_BEGIN", "COMMENT", "COMMENT_END", "STRAY_NEWLINE", "OPEN_PAREN", "SYMBOL", "CLOSE_PAREN"};
+    const char *texts[] = {"(", "a", "\"", "x;(y", "\\\"", "\"", ";", " (b) \"c\"", "\n", "\n", "(", "d", ")"};
+    assertTrue(tokenizes_as(tr, "(a \"x;(y\\\"\" ; (b) \"c\"\n\n(d)", 13, names, texts));
+    token_rules_free(tr);
+
+    // Nested block comments push their mode once per level.
+    tr = token_rules_new();
+    token_rules_add_rule(tr, "WORD", "[a-z]+");
+    token_rules_add_rule_push(tr, "BLOCK_BEGIN", "#\\|", "BLOCK");
+    token_rules_begin_mode(tr, "BLOCK");
+    token_rules_add_rule_push(tr, "BLOCK_BEGIN", "#\\|", "BLOCK");
+    token_rules_add_rule_pop(tr, "BLOCK_END", "\\|#");
+    token_rules_add_rule(tr, "BLOCK_TEXT", "[a-z ]+");
+    token_rules_compile(tr);
+    const char *block_names[] = {"WORD", "BLOCK_BEGIN", "BLOCK_TEXT", "BLOCK_BEGIN", "BLOCK_TEXT", "BLOCK_END",
+        "BLOCK_TEXT", "BLOCK_END", "WORD"};
+    const char *block_texts[] = {"a", "#|", " b ", "#|", " c ", "|#", " d ", "|#", "e"};
+    assertTrue(tokenizes_as(tr, "a #| b #| c |# d |# e", 9, block_names, block_texts));
+    token_rules_free(tr);
+    return 0;
+}
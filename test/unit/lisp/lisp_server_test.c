@@ -0,0 +1,63 @@
+#define LISP_NO_MAIN
+#include "../testlib/testlib.h"
+#include "../../../evaluators/lisp/lisp.c"
+
+// Serves `requests` (separated by '\0', ending with an empty one) and returns the responses.
+char *serve(const char *requests) {
+    char *input = NULL, *output = NULL;
+    size_t input_length = 0, output_length = 0;
+    FILE *in = open_memstream(&input, &input_length);
+    for(const char *script = requests; '\0' != script[0]; script += strlen(script) + 1)
+        fprintf(in, "%zu\n%s", strlen(script), script);
+    fclose(in);
+    in = fmemopen(input, input_length, "r");
+    FILE *out = open_memstream(&output, &output_length);
+    lisp_server_serve(in, out);
+    fclose(in);
+    fclose(out);
+    (free)(input);
+    return output;
+}
+
+// Reads the response at `*response` and moves past it.
+int next_response(const char **response, const char *output) {
+    int status;
+    size_t length;
+    int header;
+    if(2 != sscanf(*response, "%d %zu\n%n", &status, &length, &header))
+        return -1;
+    int same = (strlen(output) == length && 0 == strncmp(*response + header, output, length));
+    *response += header + length;
+    return same ? status : -1;
+}
+
+int main() {
+    _initialize_memory();
+    lisp_init();
+    parser_set_error_handler(&lisp_parse_fail);
+
+    // Errors in a script fail its request, and the next requests are still served.
+    char *output = serve(
+        "(+ 1 \"a\")\0"
+        "(write 3)\0"
+        "(/ 1 0)\0"
+        "(defun f (x) x) (f)\0"
+        "(let ((x)) x)\0"
+        "(let (x) x)\0"
+        "(< 1)\0"
+        "(((\0"
+        "(write-line \"ok\")\0");
+    const char *response = output;
+    assertTrue(1 == next_response(&response, "Argument must be NUMBER! Result: \n"));
+    assertTrue(0 == next_response(&response, "3"));
+    assertTrue(1 == next_response(&response, "Division by zero!\n"));
+    assertTrue(1 == next_response(&response, "Invalid # of arguments given to function call.\n"));
+    assertTrue(1 == next_response(&response, "Binding has no value!\n"));
+    assertTrue(1 == next_response(&response, "Bindings must be a list.\n"));
+    assertTrue(1 == next_response(&response, "Invalid # of arguments given to function call.\n"));
+    assertTrue(1 == next_response(&response, "Parse error! The script is not a sequence of s-expressions.\n"));
+    assertTrue(0 == next_response(&response, "ok\n"));
+    assertTrue('\0' == response[0]);
+    (free)(output);
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include "../testlib/testlib.h"
+#include "../../../src/context.h"
+
+/**
+ * <item>  := '(' <items> ')' | NUMBER
+ * <items> := <items> <item> | <item>
+ */
+
+#define NUM_INPUTS 64
+
+size_t same_tree(_parse_tree_node_t a, _parse_tree_node_t b) {
+    if(vector_size(a.children) != vector_size(b.children))
+        return 0;
+    if(0 == vector_size(a.children))
+        return a.root.ptr.token.ptr == b.root.ptr.token.ptr && a.root.ptr.token.length == b.root.ptr.token.length;
+    if(0 != strcmp(a.root.ptr.terminal.name, b.root.ptr.terminal.name))
+        return 0;
+    for(size_t i = 0; i < vector_size(a.children); ++i)
+        if(!same_tree(vector_get(a.children, i), vector_get(b.children, i)))
+            return 0;
+    return 1;
+}
+
+size_t count_leaves(_parse_tree_node_t node) {
+    if(0 == vector_size(node.children))
+        return 1;
+    size_t leaves = 0;
+    for(size_t i = 0; i < vector_size(node.children); ++i)
+        leaves += count_leaves(vector_get(node.children, i));
+    return leaves;
+}
+
+int main() {
+    Terminal items          = non_terminal_from("items");
+    Terminal item           = non_terminal_from("item");
+    Terminal number         = terminal_from("NUMBER");
+    Terminal open_paren     = terminal_from("OPEN_PAREN");
+    Terminal close_paren    = terminal_from("CLOSE_PAREN");
+    BnfRules *rules = bnf_rules_new();
+    bnf_rules_add_rule(rules, bnf_rule_from(item, open_paren, items, close_paren));
+    bnf_rules_add_rule(rules, bnf_rule_from(item, number));
+    bnf_rules_add_rule(rules, bnf_rule_from(items, items, item));
+    bnf_rules_add_rule(rules, bnf_rule_from(items, item));
+
+    TokenRules *tr = token_rules_new();
+    token_rules_add_rule(tr, "NUMBER", "[0-9]+");
+    token_rules_add_rule(tr, "OPEN_PAREN", "\\(");
+    token_rules_add_rule(tr, "CLOSE_PAREN", "\\)");
+    token_rules_add_rule(tr, "COMMENT", "#[^\n]*");
+
+    token_rules_skip(tr, "COMMENT");
+    ApliContext *ctx = apli_context_new(rules, tr, LEFT_TO_RIGHT);
+
+    // Input i is "1 (2 3) # (\n" repeated i + 1 times: 5 leaves per repetition.
+    const char *chunk = "1 (2 3) # (\n";
+    size_t chunk_size = strlen(chunk);
+    const char *inputs[NUM_INPUTS];
+    for(size_t i = 0; i < NUM_INPUTS; ++i) {
+        char *input = (char*) malloc(chunk_size * (i + 1) + 1);
+        for(size_t j = 0; j <= i; ++j)
+            memcpy(input + j * chunk_size, chunk, chunk_size);
+        input[chunk_size * (i + 1)] = '\0';
+        inputs[i] = input;
+    }
+
+    _parse_tree_t single = apli_context_parse(ctx, inputs[2]);
+    assertTrue(0 == strcmp("items", single.root.root.ptr.terminal.name));
+    assertTrue(15 == count_leaves(single.root));
+
+    _parse_tree_t trees[NUM_INPUTS];
+    apli_context_parse_batch(ctx, inputs, NUM_INPUTS, trees);
+    size_t correct = 0;
+    for(size_t i = 0; i < NUM_INPUTS; ++i) {
+        _parse_tree_t expected = apli_context_parse(ctx, inputs[i]);
+        correct += same_tree(expected.root, trees[i].root) && 5 * (i + 1) == count_leaves(trees[i].root);
+        parse_tree_free(expected);
+        parse_tree_free(trees[i]);
+    }
+    assertTrue(NUM_INPUTS == correct);
+
+    // Batches of one and of none.
+    apli_context_parse_batch(ctx, inputs, 1, trees);
+    assertTrue(5 == count_leaves(trees[0].root));
+    parse_tree_free(trees[0]);
+    apli_context_parse_batch(ctx, inputs, 0, trees);
+
+    parse_tree_free(single);
+    for(size_t i = 0; i < NUM_INPUTS; ++i)
+        free((char*) inputs[i]);
+    apli_context_free(ctx);
+    token_rules_free(tr);
+}
@@ -0,0 +1,76 @@
+#include "../testlib/testlib.h"
+#include "../../../src/parser/parser.h"
+
+/**
+ * <item>  := '(' <items> ')' | NUMBER
+ * <items> := <items> <item> | <item>
+ */
+
+size_t same_tree(_parse_tree_node_t a, _parse_tree_node_t b) {
+    if(vector_size(a.children) != vector_size(b.children))
+        return 0;
+    if(0 == vector_size(a.children))
+        return a.root.ptr.token.ptr == b.root.ptr.token.ptr && a.root.ptr.token.length == b.root.ptr.token.length;
+    if(0 != strcmp(a.root.ptr.terminal.name, b.root.ptr.terminal.name))
+        return 0;
+    for(size_t i = 0; i < vector_size(a.children); ++i)
+        if(!same_tree(vector_get(a.children, i), vector_get(b.children, i)))
+            return 0;
+    return 1;
+}
+
+int main() {
+    Terminal items          = non_terminal_from("items");
+    Terminal item           = non_terminal_from("item");
+    Terminal number         = terminal_from("NUMBER");
+    Terminal open_paren     = terminal_from("OPEN_PAREN");
+    Terminal close_paren    = terminal_from("CLOSE_PAREN");
+    BnfRules *rules = bnf_rules_new();
+    bnf_rules_add_rule(rules, bnf_rule_from(item, open_paren, items, close_paren));
+    bnf_rules_add_rule(rules, bnf_rule_from(item, number));
+    bnf_rules_add_rule(rules, bnf_rule_from(items, items, item));
+    bnf_rules_add_rule(rules, bnf_rule_from(items, item));
+
+    TokenRules *tr = token_rules_new();
+    token_rules_add_rule(tr, "NUMBER", "[0-9]+");
+    token_rules_add_rule(tr, "OPEN_PAREN", "\\(");
+    token_rules_add_rule(tr, "CLOSE_PAREN", "\\)");
+    token_rules_add_rule(tr, "COMMENT", "#[^\n]*");
+    token_rules_compile(tr);
+
+    // The token stream produces the same tokens as `token_rules_tokenize`.
+    const char *small = "1 (2 #(comment\n 33) 4";
+    List(_token_t) *tokens = token_rules_tokenize(tr, small);
+    TokenStream *ts = token_stream_new(tr, small);
+    _token_t token;
+    size_t same = 1;
+    for(Iterator(_token_t) *iter = list_get_iterator(tokens); iter_is_not_null(iter); iter = iter_next(iter))
+        same &= token_stream_next(ts, &token) && token.ptr == iter_val(iter).ptr && token.length == iter_val(iter).length;
+    assertTrue(same);
+    assertTrue(7 == list_size(tokens));
+    assertFalse(token_stream_next(ts, &token));
+    token_stream_free(ts);
+    list_free(tokens);
+
+    // An input large enough to fill the queue many times over.
+    const char *chunk = "1 (2 3 (4)) # a (comment\n(56 (7 8)) ";
+    size_t chunk_size = strlen(chunk), repeat = 2000;
+    char *input = (char*) malloc(chunk_size * repeat + 1);
+    for(size_t i = 0; i < repeat; ++i)
+        memcpy(input + i * chunk_size, chunk, chunk_size);
+    input[chunk_size * repeat] = '\0';
+
+    // Comments are skipped by both lexers.
+    token_rules_skip(tr, "COMMENT");
+    tokens = token_rules_tokenize(tr, input);
+    _parse_tree_t expected = bnf_rules_construct_parse_tree(rules, tokens, LEFT_TO_RIGHT);
+    list_free(tokens);
+    _parse_tree_t pipelined = bnf_rules_construct_parse_tree_pipelined(rules, tr, input);
+    assertTrue(0 == strcmp("items", pipelined.root.root.ptr.terminal.name));
+    assertTrue(same_tree(expected.root, pipelined.root));
+    parse_tree_free(expected);
+    parse_tree_free(pipelined);
+
+    free(input);
+    token_rules_free(tr);
+}
@@ -0,0 +1,74 @@
+#ifndef LEXER_TESTLIB_H
+#define LEXER_TESTLIB_H
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Helpers shared by the lexer tests. Include it after lexer.h (and after the flags a test
+ * defines for lexer.h), and after lisp_regex_cache.h for `new_lisp_token_rules`.
+ *
+ * Usage:
+ *   same_tokens(a, b)                      whether two token lists hold the same tokens
+ *   same_matches(a, b)                     whether two lists of regex matches are equal
+ *   stream_tokens(tr, input)               the tokens of `token_stream_next`, as a list
+ *   random_string(str, size, alphabet)     `size` random characters of `alphabet`, then '\0'
+ *   random_char(alphabet, one_in)          a character of `alphabet`, or (one time in `one_in`)
+ *                                          any character in 1 .. 127
+ *   new_lisp_token_rules()                 the (uncompiled) rules of the lisp regex cache
+ */
+
+#define LISP_CHARACTERS "();. \n\t\"ab1-+*'\\"
+
+size_t same_tokens(List(_token_t) *a, List(_token_t) *b) {
+    if(list_size(a) != list_size(b))
+        return 0;
+    Iterator(_token_t) *ia = list_get_iterator(a), *ib = list_get_iterator(b);
+    for(; iter_is_not_null(ia); ia = iter_next(ia), ib = iter_next(ib)) {
+        if(iter_val(ia).ptr != iter_val(ib).ptr || iter_val(ia).length != iter_val(ib).length
+            || 0 != strcmp(iter_val(ia).name, iter_val(ib).name))
+            return 0;
+    }
+    return 1;
+}
+
+size_t same_matches(List(_regex_match_t) *a, List(_regex_match_t) *b) {
+    if(list_size(a) != list_size(b))
+        return 0;
+    Iterator(_regex_match_t) *ia = list_get_iterator(a), *ib = list_get_iterator(b);
+    for(; iter_is_not_null(ia); ia = iter_next(ia), ib = iter_next(ib))
+        if(iter_val(ia).begin != iter_val(ib).begin || iter_val(ia).length != iter_val(ib).length)
+            return 0;
+    return 1;
+}
+
+List(_token_t) *stream_tokens(TokenRules *tr, const char *input) {
+    List(_token_t) *tokens = list_new(_token_t);
+    TokenStream *ts = token_stream_new(tr, input);
+    Token token;
+    while(token_stream_next(ts, &token))
+        list_push_back(tokens, token);
+    token_stream_free(ts);
+    return tokens;
+}
+
+void random_string(char *str, size_t size, const char *alphabet) {
+    for(size_t i = 0; i < size; ++i)
+        str[i] = alphabet[rand() % strlen(alphabet)];
+    str[size] = '\0';
+}
+
+char random_char(const char *alphabet, int one_in) {
+    return (0 == rand() % one_in) ? (char) (1 + rand() % 127) : alphabet[rand() % strlen(alphabet)];
+}
+
+#ifdef _lisp_REGEX_CACHE_
+TokenRules *new_lisp_token_rules() {
+    TokenRules *tr = token_rules_new();
+    for(size_t i = 0; i < sizeof(lisp_regex_cache) / sizeof(lisp_regex_cache[0]); ++i)
+        token_rules_add_rule(tr, lisp_regex_cache[i].name, lisp_regex_cache[i].raw_regex);
+    return tr;
+}
+#endif
+
+#endif
@@ -0,0 +1,62 @@
+#define APLI_ALLOC_TRACKING
+#include <stdint.h>
+#include "../testlib/testlib.h"
+#include "../../../src/util/map.h"
+
+size_t identity_hash(size_t x) { return x; }
+size_t identity_eq(size_t x, size_t y) { return x == y; }
+define_map(size_t, int);
+
+int main() {
+    setenv("APLI_ALLOC_QUIET", "1", 1);
+    apli_alloc_reset();
+
+    // Untagged allocations are charged to `other`.
+    char *a = (char*) malloc(10);
+    apli_alloc_stats s = apli_alloc_get(APLI_ALLOC_OTHER);
+    assertTrue(1 == s.allocations);
+    assertTrue(10 == s.bytes);
+    assertTrue(10 == s.live_bytes);
+    assertTrue(1 == s.histogram[0]);
+
+    // Frees are charged back to the tag of the allocation, not the current tag.
+    apli_alloc_push_tag(APLI_ALLOC_EVALUATOR);
+    char *b = (char*) malloc(100);
+    free(a);
+    s = apli_alloc_get(APLI_ALLOC_OTHER);
+    assertTrue(1 == s.frees);
+    assertTrue(0 == s.live_bytes);
+    assertTrue(10 == s.peak_live_bytes);
+    s = apli_alloc_get(APLI_ALLOC_EVALUATOR);
+    assertTrue(1 == s.allocations);
+    assertTrue(100 == s.live_bytes);
+    assertTrue(1 == s.histogram[3]);    // 64 < 100 <= 128
+
+    b = (char*) realloc(b, 5000);
+    s = apli_alloc_get(APLI_ALLOC_EVALUATOR);
+    assertTrue(2 == s.allocations);
+    assertTrue(5000 == s.live_bytes);
+    assertTrue(5000 == s.peak_live_bytes);
+    // A failed reallocation leaves the block live and charged.
+    assertTrue(NULL == realloc(b, SIZE_MAX >> 1));
+    s = apli_alloc_get(APLI_ALLOC_EVALUATOR);
+    assertTrue(2 == s.allocations && 1 == s.frees);
+    assertTrue(5000 == s.live_bytes);
+    free(b);
+    s = apli_alloc_get(APLI_ALLOC_EVALUATOR);
+    assertTrue(0 == s.live_bytes);
+
+    // Maps charge their own allocations to `maps` regardless of the current tag.
+    Map(size_t, int) *map = map_new(size_t, int);
+    map_set_hash(map, &identity_hash);
+    map_set_key_eq(map, &identity_eq);
+    for(size_t i = 0; i < 100; ++i)
+        map_insert(map, i, (int) i);
+    assertTrue(0 < apli_alloc_get(APLI_ALLOC_MAPS).allocations);
+    assertTrue(2 == apli_alloc_get(APLI_ALLOC_EVALUATOR).allocations);
+    map_free(map);
+    assertTrue(0 == apli_alloc_get(APLI_ALLOC_MAPS).live_bytes);
+
+    apli_alloc_pop_tag();
+    assertTrue(0 == apli_alloc_tag_depth());
+}
@@ -98,5 +98,21 @@ int main() {
         list_free(int_list);
     }
 
+    // splice_back moves all nodes and leaves the other list empty.
+    List(int) *front = list_new(int), *back = list_new(int);
+    list_splice_back(front, back);
+    assertTrue(0 == list_size(front));
+    list_push_back(back, 1);
+    list_push_back(back, 2);
+    list_splice_back(front, back);
+    list_push_back(back, 3);
+    list_splice_back(front, back);
+    assertTrue(3 == list_size(front) && 0 == list_size(back));
+    assertTrue(1 == list_get_first(front) && 3 == list_get_last(front));
+    list_pop_back(front);
+    assertTrue(2 == list_get_last(front));
+    list_free(front);
+    list_free(back);
+
     teardown_tests();
 }
\ No newline at end of file
@@ -0,0 +1,54 @@
+#define APLI_STATS
+#include "../testlib/testlib.h"
+#include "../../../src/lexer/flat_dfa.c"
+
+size_t identity_hash(size_t x) { return x; }
+size_t identity_eq(size_t x, size_t y) { return x == y; }
+
+int main() {
+    setenv("APLI_STATS_QUIET", "1", 1);
+    apli_stats_reset();
+    apli_stats s = apli_stats_get();
+    assertTrue(0 == s.dfa_runs);
+    assertTrue(0 == s.dfa_transitions);
+
+    // Accepts "ab".
+    _flat_dfa_t *dfa = flat_dfa_new(3);
+    dfa_add_transition(dfa, 0, 'a', 1);
+    dfa_add_transition(dfa, 1, 'b', 2);
+    dfa_add_accept_state(dfa, 2);
+
+    const char *str = "xab";
+    assertTrue(3 == dfa_run_greedy(dfa, str, strlen(str)));
+    s = apli_stats_get();
+    assertTrue(1 == s.dfa_runs);
+    assertTrue(2 == s.dfa_begin_resets);   // 'x' and the terminating '\0' have no transitions.
+    assertTrue(4 == s.dfa_transitions);    // 'x', 'a', 'b' and the terminating '\0'.
+    dfa_free(dfa);
+
+    Map(size_t, size_t) *map = map_new(size_t, size_t);
+    map_set_hash(map, &identity_hash);
+    map_set_key_eq(map, &identity_eq);
+    map_insert(map, 1, 10);
+    map_insert(map, 2, 20);
+    apli_stats_reset();
+    assertTrue(10 == map_at(map, 1));
+    assertTrue(1 == map_count(map, 2));
+    assertTrue(0 == map_count(map, 3));
+    s = apli_stats_get();
+    assertTrue(3 == s.map_lookups);
+    assertTrue(2 <= s.map_probes);
+    assertTrue(1 <= s.map_max_chain);
+    map_free(map);
+
+    apli_stats_reset();
+    const char *name = "s_expression";
+    assertTrue(name == apli_stat_dispatch(name));
+    apli_stat_dispatch(name);
+    apli_stat_dispatch("list");
+    s = apli_stats_get();
+    assertTrue(3 == s.dispatches);
+    assertTrue(2 == s.dispatch_names_size);
+    assertTrue(2 == s.dispatch_names[0].count);
+    assertTrue(1 == s.dispatch_names[1].count);
+}
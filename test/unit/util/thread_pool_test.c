@@ -0,0 +1,66 @@
+#include "../testlib/testlib.h"
+#include "../../../src/util/thread_pool.h"
+
+#define NUM_TASKS 1000
+
+size_t results[NUM_TASKS];
+size_t counter = 0;
+
+void square(void *arg) {
+    size_t i = (size_t) arg;
+    results[i] = i * i;
+}
+
+void count(void *arg) {
+    __atomic_add_fetch(&counter, 1, __ATOMIC_RELAXED);
+}
+
+// Submits two subtasks to a group of its own and waits for them from inside the pool.
+void fork_join(void *arg) {
+    ThreadPool *pool = (ThreadPool*) arg;
+    TaskGroup children = task_group_init();
+    thread_pool_submit(pool, &children, &count, NULL);
+    thread_pool_submit(pool, &children, &count, NULL);
+    thread_pool_wait(pool, &children);
+    count(NULL);
+}
+
+int main() {
+    ThreadPool *pool = thread_pool_new(4);
+    assertTrue(4 == thread_pool_size(pool));
+
+    TaskGroup group = task_group_init();
+    for(size_t i = 0; i < NUM_TASKS; ++i)
+        thread_pool_submit(pool, &group, &square, (void*) i);
+    thread_pool_wait(pool, &group);
+    size_t correct = 0;
+    for(size_t i = 0; i < NUM_TASKS; ++i)
+        correct += (i * i == results[i]);
+    assertTrue(NUM_TASKS == correct);
+    assertTrue(0 == group.pending);
+
+    // Waiting on an empty group returns immediately.
+    thread_pool_wait(pool, &group);
+
+    // Nested fork/join with more tasks than workers must not deadlock.
+    group = task_group_init();
+    for(size_t i = 0; i < 64; ++i)
+        thread_pool_submit(pool, &group, &fork_join, pool);
+    thread_pool_wait(pool, &group);
+    assertTrue(3 * 64 == counter);
+
+    // A pool with a single worker still makes progress on nested tasks.
+    ThreadPool *single = thread_pool_new(1);
+    counter = 0;
+    group = task_group_init();
+    for(size_t i = 0; i < 8; ++i)
+        thread_pool_submit(single, &group, &fork_join, single);
+    thread_pool_wait(single, &group);
+    assertTrue(3 * 8 == counter);
+    thread_pool_free(single);
+    thread_pool_free(pool);
+
+    assertTrue(NULL != thread_pool_default());
+    assertTrue(thread_pool_default() == thread_pool_default());
+    assertTrue(0 < thread_pool_size(thread_pool_default()));
+}
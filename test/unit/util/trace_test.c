@@ -0,0 +1,57 @@
+#define APLI_TRACE
+#include "../testlib/testlib.h"
+#include <unistd.h>
+#include "../../../src/util/trace.h"
+
+int main() {
+    assertTrue(!apli_trace_enabled());
+    apli_trace_begin("test", "disabled");
+    apli_trace_end("test", "disabled");
+    assertTrue(NULL == _apli_trace.buffers);
+
+    apli_trace_enable("/dev/null");
+    _apli_trace.path = NULL;    // do not write at exit
+    assertTrue(apli_trace_enabled());
+    apli_trace_begin_detail("test", "outer", "a \"quoted\" detail");
+    apli_trace_begin("test", "inner");
+    apli_trace_end("test", "inner");
+    apli_trace_end("test", "outer");
+    assertTrue(NULL != _apli_trace.buffers);
+    assertTrue(4 == _apli_trace.buffers->size);
+    assertTrue('B' == _apli_trace.buffers->events[0].phase);
+    assertTrue('E' == _apli_trace.buffers->events[3].phase);
+    assertTrue(0 == strcmp("a \"quoted\" detail", _apli_trace.buffers->events[0].detail));
+    assertTrue(_apli_trace.buffers->events[0].ts_ns <= _apli_trace.buffers->events[3].ts_ns);
+
+    // Nested evaluations are recorded down to `APLI_TRACE_EVAL_DEPTH` levels; chains of the
+    // same name count as one.
+    const char *p1, *p2, *p3, *p4;
+    int t1 = _apli_trace_eval_begin("program", &p1);
+    int t2 = _apli_trace_eval_begin("program", &p2);
+    int t3 = _apli_trace_eval_begin("form", &p3);
+    int t4 = _apli_trace_eval_begin("atom", &p4);
+    assertTrue(t1 && !t2 && t3 && !t4);
+    _apli_trace_eval_end(t4, "atom", p4);
+    _apli_trace_eval_end(t3, "form", p3);
+    _apli_trace_eval_end(t2, "program", p2);
+    _apli_trace_eval_end(t1, "program", p1);
+    assertTrue(8 == _apli_trace.buffers->size);
+    assertTrue(0 == _apli_trace_eval_depth);
+
+    char path[] = "/tmp/apli_trace_testXXXXXX";
+    int fd = mkstemp(path);
+    assertTrue(0 <= fd);
+    close(fd);
+    // 1 thread metadata event + 8 events.
+    assertTrue(9 == apli_trace_write(path));
+    FILE *fp = fopen(path, "r");
+    char buf[4096];
+    size_t len = fread(buf, 1, sizeof(buf) - 1, fp);
+    buf[len] = '\0';
+    fclose(fp);
+    remove(path);
+    assertTrue(NULL != strstr(buf, "\"traceEvents\""));
+    assertTrue(NULL != strstr(buf, "a \\\"quoted\\\" detail"));
+    assertTrue(NULL != strstr(buf, "\"name\": \"form\", \"cat\": \"eval\""));
+    apli_trace_disable();
+}
@@ -0,0 +1,103 @@
+/**
+ * Writes the DFA cache of a list of token rules as a C header (see `token_rules_write_cache`),
+ * and optionally their direct-coded scanners as a second header (see `token_rules_write_scanners`).
+ *
+ *   regex_cache_gen <rules file> <output header> <prefix> [<scanners header>]
+ *
+ * Every line of the rules file is a rule name followed by its regex as a C string literal
+ * (ie. copied from an `apli_regex` list); empty lines and lines starting with `#` are
+ * skipped. The header defines `<prefix>_regex_cache`, which is loaded with
+ * `token_rules_load_cache(token_rules, <prefix>_regex_cache)`; the scanners header defines
+ * `<prefix>_regex_scanners`, loaded with `token_rules_load_scanners`.
+ *
+ * Build it with `./compile.sh regex-cache`, which also regenerates the lisp cache.
+ */
+
+#include "../src/lexer/lexer.h"
+
+#define REGEX_CACHE_GEN_MAX_LINE 4096
+
+// Reads the C string literal at `*ptr` into `out`, and moves `*ptr` past it.
+static int parse_c_string(const char **ptr, char *out) {
+    const char *p = *ptr;
+    if('"' != *p++)
+        return 0;
+    while('"' != *p) {
+        if('\0' == *p)
+            return 0;
+        if('\\' != *p) {
+            *out++ = *p++;
+            continue;
+        }
+        switch(*++p) {
+            case 'n':   *out++ = '\n'; ++p; break;
+            case 't':   *out++ = '\t'; ++p; break;
+            case 'r':   *out++ = '\r'; ++p; break;
+            case 'x':   *out++ = (char) strtoul(p + 1, (char**) &p, 16); break;
+            case '0': case '1': case '2': case '3':
+                *out++ = (char) (((p[0] - '0') << 6) | ((p[1] - '0') << 3) | (p[2] - '0'));
+                p += 3;
+                break;
+            case '\0':  return 0;
+            default:    *out++ = *p++; break;
+        }
+    }
+    *out = '\0';
+    *ptr = p + 1;
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    if(4 != argc && 5 != argc) {
+        fprintf(stderr, "usage: %s <rules file> <output header> <prefix> [<scanners header>]\n", argv[0]);
+        return 1;
+    }
+    FILE *in = fopen(argv[1], "r");
+    if(NULL == in) {
+        fprintf(stderr, "regex_cache_gen: could not open %s\n", argv[1]);
+        return 1;
+    }
+    TokenRules *token_rules = token_rules_new();
+    char line[REGEX_CACHE_GEN_MAX_LINE];
+    for(size_t line_number = 1; NULL != fgets(line, sizeof(line), in); ++line_number) {
+        const char *p = line;
+        while(' ' == *p || '\t' == *p)
+            ++p;
+        if('#' == *p || '\n' == *p || '\0' == *p)
+            continue;
+        size_t name_length = strcspn(p, " \t\n");
+        char *name = (char*) malloc(name_length + 1);
+        memcpy(name, p, name_length);
+        name[name_length] = '\0';
+        p += name_length + strspn(p + name_length, " \t");
+        char *regex = (char*) malloc(strlen(p) + 1);
+        if(!parse_c_string(&p, regex)) {
+            fprintf(stderr, "regex_cache_gen: %s:%zu: expected a rule name and a string literal\n",
+                argv[1], line_number);
+            return 1;
+        }
+        token_rules_add_rule(token_rules, name, regex);
+        free(regex);
+    }
+    fclose(in);
+
+    FILE *out = fopen(argv[2], "w");
+    if(NULL == out) {
+        fprintf(stderr, "regex_cache_gen: could not open %s\n", argv[2]);
+        return 1;
+    }
+    token_rules_write_cache(token_rules, out, argv[3]);
+    fclose(out);
+    printf("Wrote the DFAs of %zu token rules to %s\n", vector_size(token_rules->rules), argv[2]);
+    if(5 == argc) {
+        out = fopen(argv[4], "w");
+        if(NULL == out) {
+            fprintf(stderr, "regex_cache_gen: could not open %s\n", argv[4]);
+            return 1;
+        }
+        token_rules_write_scanners(token_rules, out, argv[3]);
+        fclose(out);
+        printf("Wrote the scanners of %zu token rules to %s\n", vector_size(token_rules->rules), argv[4]);
+    }
+    return 0;
+}